@@ -10,7 +10,11 @@ On macOS, compile with...
 On Ubuntu, compile with...
     cc -c 040pixel.c
 ...and then link with a main program by for example...
-    cc main.c 040pixel.o -lglfw -lGL -lm -ldl
+    cc main.c 040pixel.o -lglfw -lGL -lm -ldl -lpthread
+
+To trace the event loop (see 354trace.h), add -DTRACE=1 when compiling, build into its 
+own object (for example -o 040pixelTrace.o) so that untraced programs can keep linking 
+040pixel.o, and link 354trace.o too.
 */
 
 /*
@@ -27,20 +31,42 @@ width and height equal to pixPowerOfTwoCeil of the user width and height.
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
 #include <GLFW/glfw3.h>
 #include <sys/time.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "040pixel.h"
+#include "354trace.h"
 
 // Global variables.
 GLFWwindow *pixWindow;
 int pixOrigWidth, pixOrigHeight; // as initialized
+int pixWidth, pixHeight; // of the pixels; less than the above if scaled down
 int pixWinWidth, pixWinHeight; // after resizing; resizing now forbidden
 int pixTexWidth, pixTexHeight; // for the underlying OpenGL texture
 GLuint pixTexture;
-GLfloat *pixPixels;
+GLfloat *pixPixels; // in pixRGBFLOAT format, 3 floats per pixel
+GLubyte *pixBytes; // in pixRGBA8 format, 4 bytes per pixel
+int pixFormat = pixRGBFLOAT, pixNextFormat = pixRGBFLOAT;
+GLuint pixUnpackBuffers[2]; // in pixRGBA8 format, used alternately
+int pixUnpackIndex = 0;
 int pixNeedsRedisplay = 1;
+int *pixDirtyMins, *pixDirtyMaxs; // per row, the dirty span; empty if min > max
+int pixUploadedNum = 0; // pixels sent by the most recent upload
+int pixViewIsLocked = 0;
+int pixPipelined = 0;
+int pixHeadless = 0, pixNextHeadless = 0; // 1 if there is no window
+int pixOnDemand = 0;
+atomic_int pixFrameRequested = 1;
+double pixFramePeriod = 0.0; // seconds; 0 means no frame cap
+double pixNextFrameTime = 0.0; // on the monotonic clock
 GLuint pixAttrBuffer, pixTriBuffer;
 GLuint pixProgram;
-GLint pixUnifLoc, pixAttrLoc;
+GLint pixUnifLoc, pixAttrLoc, pixTexScaleLoc, pixTexMaxLoc;
+GLint pixFilter = GL_NEAREST;
 double pixOldTime, pixNewTime;
 void (*pixUserKeyDownHandler)(int, int, int, int, int) = NULL;
 void (*pixUserKeyUpHandler)(int, int, int, int, int) = NULL;
@@ -50,6 +76,7 @@ void (*pixUserMouseUpHandler)(double, double, int, int, int, int, int) = NULL;
 void (*pixUserMouseMoveHandler)(double, double) = NULL;
 void (*pixUserMouseScrollHandler)(double, double) = NULL;
 void (*pixUserTimeStepHandler)(double, double) = NULL;
+void (*pixUserResizeHandler)(int, int) = NULL;
 
 int pixPowerOfTwoFloor(int n) {
     int m = 1;
@@ -65,12 +92,121 @@ int pixPowerOfTwoCeil(int n) {
     return m;
 }
 
+// Converts a color channel to a byte, clamping it to [0, 1] as OpenGL would.
+// Written with conditional expressions so that it compiles without branches.
+GLubyte pixByte(double channel) {
+    channel = (channel < 0.0) ? 0.0 : channel;
+    channel = (channel > 1.0) ? 1.0 : channel;
+    return (GLubyte)(channel * 255.0 + 0.5);
+}
+
+// Past this many rectangles, or past this fraction of the window, one full 
+// upload is cheaper than uploading the dirty rectangles one at a time.
+#define pixMAXDIRTYRECTS 32
+#define pixDIRTYFRACTION 0.5
+
+// Marks the row spans touched since the last upload. Rows are clean when 
+// their min exceeds their max.
+void pixMarkDirty(int x, int y) {
+    pixDirtyMins[y] = (x < pixDirtyMins[y]) ? x : pixDirtyMins[y];
+    pixDirtyMaxs[y] = (x > pixDirtyMaxs[y]) ? x : pixDirtyMaxs[y];
+    pixNeedsRedisplay = 1;
+}
+
+// Marks the pixels from xMin to xMax, inclusive, in row y.
+void pixMarkSpan(int xMin, int xMax, int y) {
+    pixDirtyMins[y] = (xMin < pixDirtyMins[y]) ? xMin : pixDirtyMins[y];
+    pixDirtyMaxs[y] = (xMax > pixDirtyMaxs[y]) ? xMax : pixDirtyMaxs[y];
+    pixNeedsRedisplay = 1;
+}
+
+void pixMarkAllDirty(void) {
+    for (int j = 0; j < pixHeight; j += 1) {
+        pixDirtyMins[j] = 0;
+        pixDirtyMaxs[j] = pixWidth - 1;
+    }
+    pixNeedsRedisplay = 1;
+}
+
+// Merges each run of consecutive dirty rows into one rectangle, stored as x, 
+// y, width, height in rects, and marks every row clean. Returns the number of 
+// rectangles. If there would be too many, or they would cover too much of the 
+// window, then instead stores the whole window as the one rectangle.
+int pixGatherDirty(int rects[pixMAXDIRTYRECTS][4]) {
+    int rectNum = 0, area = 0, j = 0;
+    while (j < pixHeight && rectNum <= pixMAXDIRTYRECTS) {
+        if (pixDirtyMins[j] > pixDirtyMaxs[j]) {
+            j += 1;
+            continue;
+        }
+        int min = pixDirtyMins[j], max = pixDirtyMaxs[j], start = j;
+        for (j += 1; j < pixHeight && pixDirtyMins[j] <= pixDirtyMaxs[j]; 
+                j += 1) {
+            min = (pixDirtyMins[j] < min) ? pixDirtyMins[j] : min;
+            max = (pixDirtyMaxs[j] > max) ? pixDirtyMaxs[j] : max;
+        }
+        if (rectNum < pixMAXDIRTYRECTS) {
+            rects[rectNum][0] = min;
+            rects[rectNum][1] = start;
+            rects[rectNum][2] = max - min + 1;
+            rects[rectNum][3] = j - start;
+        }
+        rectNum += 1;
+        area += (max - min + 1) * (j - start);
+    }
+    if (rectNum > pixMAXDIRTYRECTS || 
+            area > pixDIRTYFRACTION * pixWidth * pixHeight) {
+        rects[0][0] = 0;
+        rects[0][1] = 0;
+        rects[0][2] = pixWidth;
+        rects[0][3] = pixHeight;
+        rectNum = 1;
+    }
+    for (j = 0; j < pixHeight; j += 1) {
+        pixDirtyMins[j] = pixWidth;
+        pixDirtyMaxs[j] = -1;
+    }
+    return rectNum;
+}
+
 double pixTime(void) {
     struct timeval tv;
     gettimeofday(&tv, NULL);
     return (double)tv.tv_sec + (double)tv.tv_usec * 0.000001;
 }
 
+// Unlike pixTime, never jumps when the system clock is set.
+double pixMonotonicTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 0.000000001;
+}
+
+// Under a frame cap, sleeps until it's time for the next frame. The coarse part 
+// of the wait goes to glfwWaitEventsTimeout, if mayWaitEvents is 1, so that 
+// input is still handled promptly; only the last millisecond or so is slept 
+// precisely with nanosleep. Neither wait burns the processor.
+void pixWaitForFrameSlot(int mayWaitEvents) {
+    if (pixFramePeriod <= 0.0)
+        return;
+    double now = pixMonotonicTime();
+    if (mayWaitEvents && pixNextFrameTime - now > 0.002) {
+        glfwWaitEventsTimeout(pixNextFrameTime - now - 0.001);
+        now = pixMonotonicTime();
+    }
+    while (now < pixNextFrameTime) {
+        double rest = pixNextFrameTime - now;
+        struct timespec ts = {(time_t)rest, 
+            (long)((rest - (time_t)rest) * 1000000000.0)};
+        nanosleep(&ts, NULL);
+        now = pixMonotonicTime();
+    }
+    // If a frame runs late, start the next one right away, rather than trying 
+    // to catch up.
+    pixNextFrameTime += pixFramePeriod;
+    pixNextFrameTime = (pixNextFrameTime < now) ? now : pixNextFrameTime;
+}
+
 GLuint pixBuildVertexFragmentProgram(const GLchar *vertexCode, 
         const GLchar *fragmentCode) {
     GLuint vertexShader, fragmentShader, program;
@@ -91,6 +227,259 @@ GLuint pixBuildVertexFragmentProgram(const GLchar *vertexCode,
 
 
 
+/*** Private: events ***/
+
+// A user interface event, recorded so that it can be handed to another thread.
+#define pixEVENTKEYDOWN 0
+#define pixEVENTKEYUP 1
+#define pixEVENTKEYREPEAT 2
+#define pixEVENTMOUSEDOWN 3
+#define pixEVENTMOUSEUP 4
+#define pixEVENTMOUSEMOVE 5
+#define pixEVENTMOUSESCROLL 6
+typedef struct pixEvent pixEvent;
+struct pixEvent {
+    int type;
+    int keyButton; // key or mouse button
+    int shiftIsDown, controlIsDown, altOptionIsDown, superCommandIsDown;
+    double x, y; // mouse position or scroll offsets
+};
+
+// In pipelined mode, the main thread pushes events onto this single-producer, 
+// single-consumer ring, and the render thread pops them. Each side writes only 
+// its own index, so no lock is needed. Must be a power of 2.
+#define pixEVENTCAPACITY 1024
+pixEvent pixEvents[pixEVENTCAPACITY];
+atomic_uint pixEventHead = 0, pixEventTail = 0; // next to pop, next to push
+
+// Called on the main thread. Drops the event if the ring is full.
+void pixPushEvent(const pixEvent *event) {
+    unsigned tail = atomic_load_explicit(&pixEventTail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&pixEventHead, memory_order_acquire);
+    if (tail - head >= pixEVENTCAPACITY) {
+        fprintf(stderr, "warning: pixPushEvent: dropping event\n");
+        return;
+    }
+    pixEvents[tail & (pixEVENTCAPACITY - 1)] = *event;
+    atomic_store_explicit(&pixEventTail, tail + 1, memory_order_release);
+}
+
+// Returns 1 if events are waiting for the render thread, else 0.
+int pixEventsPending(void) {
+    return atomic_load(&pixEventHead) != atomic_load(&pixEventTail);
+}
+
+// Called on the render thread. Returns 1 if an event was popped, else 0.
+int pixPopEvent(pixEvent *event) {
+    unsigned head = atomic_load_explicit(&pixEventHead, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&pixEventTail, memory_order_acquire);
+    if (head == tail)
+        return 0;
+    *event = pixEvents[head & (pixEVENTCAPACITY - 1)];
+    atomic_store_explicit(&pixEventHead, head + 1, memory_order_release);
+    return 1;
+}
+
+// Defined below, with the rest of recording and replay.
+void pixRecordEvent(const pixEvent *event);
+
+// Invokes the user's handler for the event, if there is one. Because this 
+// function runs on the same thread as the time step callback, in the same 
+// order, it is where events are recorded.
+void pixDispatchEvent(const pixEvent *e) {
+    pixRecordEvent(e);
+    if (e->type == pixEVENTKEYDOWN && pixUserKeyDownHandler != NULL)
+        pixUserKeyDownHandler(e->keyButton, e->shiftIsDown, e->controlIsDown, 
+            e->altOptionIsDown, e->superCommandIsDown);
+    else if (e->type == pixEVENTKEYUP && pixUserKeyUpHandler != NULL)
+        pixUserKeyUpHandler(e->keyButton, e->shiftIsDown, e->controlIsDown, 
+            e->altOptionIsDown, e->superCommandIsDown);
+    else if (e->type == pixEVENTKEYREPEAT && pixUserKeyRepeatHandler != NULL)
+        pixUserKeyRepeatHandler(e->keyButton, e->shiftIsDown, 
+            e->controlIsDown, e->altOptionIsDown, e->superCommandIsDown);
+    else if (e->type == pixEVENTMOUSEDOWN && pixUserMouseDownHandler != NULL)
+        pixUserMouseDownHandler(e->x, e->y, e->keyButton, e->shiftIsDown, 
+            e->controlIsDown, e->altOptionIsDown, e->superCommandIsDown);
+    else if (e->type == pixEVENTMOUSEUP && pixUserMouseUpHandler != NULL)
+        pixUserMouseUpHandler(e->x, e->y, e->keyButton, e->shiftIsDown, 
+            e->controlIsDown, e->altOptionIsDown, e->superCommandIsDown);
+    else if (e->type == pixEVENTMOUSEMOVE && pixUserMouseMoveHandler != NULL)
+        pixUserMouseMoveHandler(e->x, e->y);
+    else if (e->type == pixEVENTMOUSESCROLL && pixUserMouseScrollHandler != NULL)
+        pixUserMouseScrollHandler(e->x, e->y);
+}
+
+// Defined below. Non-NULL while replaying.
+extern FILE *pixReplayFile;
+
+// In pipelined mode, forwards the event to the render thread. Otherwise 
+// handles it right away. While replaying, live input is ignored.
+void pixDeliverEvent(const pixEvent *event) {
+    if (pixReplayFile != NULL)
+        return;
+    if (pixPipelined)
+        pixPushEvent(event);
+    else
+        pixDispatchEvent(event);
+}
+
+
+
+/*** Private: recording and replay ***/
+
+// A recording starts with the 4 bytes "PIXR" and a 4-byte version number. Then 
+// come records, each starting with a 1-byte kind. For an event, the kind is 
+// the event's type, followed by 1 byte of modifier flags and a 4-byte key or 
+// button, and, for mouse events only, the 8-byte doubles x and y. For a time 
+// step, the kind is pixRECORDSTEP, followed by the 4-byte frame index and the 
+// 8-byte doubles oldTime and newTime. The events before a time step are the 
+// ones handled just before it. Numbers are in the machine's byte order.
+#define pixRECORDMAGIC "PIXR"
+#define pixRECORDVERSION 1
+#define pixRECORDSTEP 16
+#define pixRECORDMAXSIZE 32
+FILE *pixRecordFile = NULL;
+FILE *pixReplayFile = NULL;
+unsigned int pixFrameIndex = 0; // time steps recorded or replayed so far
+double pixReplayStep = 0.0; // seconds; 0 means use the recorded times
+double pixReplayTime;
+
+// Returns 1 if events of the given type carry a mouse position or offset.
+int pixEventHasXY(int type) {
+    return type == pixEVENTMOUSEDOWN || type == pixEVENTMOUSEUP || 
+        type == pixEVENTMOUSEMOVE || type == pixEVENTMOUSESCROLL;
+}
+
+// Appends one record. If writing fails, stops recording.
+void pixWriteRecord(const unsigned char *record, size_t size) {
+    if (fwrite(record, 1, size, pixRecordFile) != size) {
+        fprintf(stderr, "error: pixWriteRecord: fwrite failed; ");
+        fprintf(stderr, "recording stopped\n");
+        fclose(pixRecordFile);
+        pixRecordFile = NULL;
+    }
+}
+
+// Records the event, if recording.
+void pixRecordEvent(const pixEvent *event) {
+    if (pixRecordFile == NULL)
+        return;
+    unsigned char record[pixRECORDMAXSIZE];
+    int keyButton = event->keyButton;
+    record[0] = (unsigned char)event->type;
+    record[1] = (event->shiftIsDown != 0) | ((event->controlIsDown != 0) << 1) | 
+        ((event->altOptionIsDown != 0) << 2) | 
+        ((event->superCommandIsDown != 0) << 3);
+    memcpy(&record[2], &keyButton, 4);
+    size_t size = 6;
+    if (pixEventHasXY(event->type)) {
+        memcpy(&record[6], &event->x, 8);
+        memcpy(&record[14], &event->y, 8);
+        size = 22;
+    }
+    pixWriteRecord(record, size);
+}
+
+// Records a time step, if recording, and counts it.
+void pixRecordStep(double oldTime, double newTime) {
+    if (pixRecordFile != NULL) {
+        unsigned char record[pixRECORDMAXSIZE];
+        record[0] = pixRECORDSTEP;
+        memcpy(&record[1], &pixFrameIndex, 4);
+        memcpy(&record[5], &oldTime, 8);
+        memcpy(&record[13], &newTime, 8);
+        pixWriteRecord(record, 21);
+    }
+    pixFrameIndex += 1;
+}
+
+// Reads the recording up to its next time step, dispatching the events on the 
+// way, and puts the step's times in oldTime and newTime. Returns 0 on success, 
+// 1 at the end of the recording, or 2 if the recording is damaged.
+int pixReplayFrame(double *oldTime, double *newTime) {
+    unsigned char record[pixRECORDMAXSIZE];
+    while (fread(record, 1, 1, pixReplayFile) == 1) {
+        if (record[0] == pixRECORDSTEP) {
+            unsigned int frame;
+            if (fread(&record[1], 1, 20, pixReplayFile) != 20)
+                break;
+            memcpy(&frame, &record[1], 4);
+            memcpy(oldTime, &record[5], 8);
+            memcpy(newTime, &record[13], 8);
+            if (frame != pixFrameIndex) {
+                fprintf(stderr, "error: pixReplayFrame: expected frame %u, ", 
+                    pixFrameIndex);
+                fprintf(stderr, "found frame %u\n", frame);
+                return 2;
+            }
+            // With a fixed time step, the simulated clock starts where the 
+            // recorded one did.
+            if (pixReplayStep > 0.0) {
+                if (frame == 0)
+                    pixReplayTime = *oldTime;
+                *oldTime = pixReplayTime;
+                pixReplayTime += pixReplayStep;
+                *newTime = pixReplayTime;
+            }
+            return 0;
+        }
+        if (record[0] > pixEVENTMOUSESCROLL)
+            break;
+        size_t size = pixEventHasXY(record[0]) ? 21 : 5;
+        if (fread(&record[1], 1, size, pixReplayFile) != size)
+            break;
+        pixEvent event;
+        event.type = record[0];
+        event.shiftIsDown = record[1] & 1;
+        event.controlIsDown = (record[1] >> 1) & 1;
+        event.altOptionIsDown = (record[1] >> 2) & 1;
+        event.superCommandIsDown = (record[1] >> 3) & 1;
+        memcpy(&event.keyButton, &record[2], 4);
+        event.x = 0.0;
+        event.y = 0.0;
+        if (size == 21) {
+            memcpy(&event.x, &record[6], 8);
+            memcpy(&event.y, &record[14], 8);
+        }
+        pixDispatchEvent(&event);
+    }
+    if (feof(pixReplayFile))
+        return 1;
+    fprintf(stderr, "error: pixReplayFrame: damaged recording at frame %u\n", 
+        pixFrameIndex);
+    return 2;
+}
+
+// Opens a file of the given mode and checks or writes the header. Returns NULL 
+// on error.
+FILE *pixOpenRecording(const char *path, const char *mode) {
+    FILE *file = fopen(path, mode);
+    if (file == NULL) {
+        fprintf(stderr, "error: pixOpenRecording: could not open %s\n", path);
+        return NULL;
+    }
+    unsigned int version = pixRECORDVERSION;
+    char magic[4];
+    if (mode[0] == 'w') {
+        if (fwrite(pixRECORDMAGIC, 1, 4, file) == 4 && 
+                fwrite(&version, 4, 1, file) == 1)
+            return file;
+        fprintf(stderr, "error: pixOpenRecording: could not write %s\n", path);
+    } else {
+        if (fread(magic, 1, 4, file) == 4 && 
+                memcmp(magic, pixRECORDMAGIC, 4) == 0 && 
+                fread(&version, 4, 1, file) == 1 && 
+                version == pixRECORDVERSION)
+            return file;
+        fprintf(stderr, "error: pixOpenRecording: %s is not a recording\n", 
+            path);
+    }
+    fclose(file);
+    return NULL;
+}
+
+
+
 /*** Private: GLFW handlers ***/
 
 void pixHandleError(int error, const char *description) {
@@ -106,20 +495,21 @@ void pixHandleError(int error, const char *description) {
 // ...which on macOS mean shift, control, option, command.
 void pixHandleKey(GLFWwindow *window, int key, int scancode, int action,
         int mods) {
-    int shiftIsDown, controlIsDown, altOptionIsDown, superCommandIsDown;
-    shiftIsDown = mods & GLFW_MOD_SHIFT;
-    controlIsDown = mods & GLFW_MOD_CONTROL;
-    altOptionIsDown = mods & GLFW_MOD_ALT;
-    superCommandIsDown = mods & GLFW_MOD_SUPER;
-    if (action == GLFW_PRESS && pixUserKeyDownHandler != NULL)
-        pixUserKeyDownHandler(key, shiftIsDown, controlIsDown, altOptionIsDown, 
-            superCommandIsDown);
-    else if (action == GLFW_RELEASE && pixUserKeyUpHandler != NULL)
-        pixUserKeyUpHandler(key, shiftIsDown, controlIsDown, altOptionIsDown, 
-            superCommandIsDown);
-    else if (action == GLFW_REPEAT && pixUserKeyRepeatHandler != NULL)
-        pixUserKeyRepeatHandler(key, shiftIsDown, controlIsDown, 
-            altOptionIsDown, superCommandIsDown);
+    pixEvent event;
+    event.keyButton = key;
+    event.shiftIsDown = mods & GLFW_MOD_SHIFT;
+    event.controlIsDown = mods & GLFW_MOD_CONTROL;
+    event.altOptionIsDown = mods & GLFW_MOD_ALT;
+    event.superCommandIsDown = mods & GLFW_MOD_SUPER;
+    event.x = 0.0;
+    event.y = 0.0;
+    if (action == GLFW_PRESS)
+        event.type = pixEVENTKEYDOWN;
+    else if (action == GLFW_RELEASE)
+        event.type = pixEVENTKEYUP;
+    else
+        event.type = pixEVENTKEYREPEAT;
+    pixDeliverEvent(&event);
 }
 
 // button is GLFW_MOUSE_BUTTON_LEFT, GLFW_MOUSE_BUTTON_RIGHT, or...?
@@ -130,42 +520,48 @@ void pixHandleKey(GLFWwindow *window, int key, int scancode, int action,
 void pixHandleMouseButton(GLFWwindow *window, int button, int action, 
         int mods) {
     // Get status of modifier keys.
-    int shiftIsDown, controlIsDown, altOptionIsDown, superCommandIsDown;
-    shiftIsDown = mods & GLFW_MOD_SHIFT;
-    controlIsDown = mods & GLFW_MOD_CONTROL;
-    altOptionIsDown = mods & GLFW_MOD_ALT;
-    superCommandIsDown = mods & GLFW_MOD_SUPER;
+    pixEvent event;
+    event.keyButton = button;
+    event.shiftIsDown = mods & GLFW_MOD_SHIFT;
+    event.controlIsDown = mods & GLFW_MOD_CONTROL;
+    event.altOptionIsDown = mods & GLFW_MOD_ALT;
+    event.superCommandIsDown = mods & GLFW_MOD_SUPER;
     // Get the position of the mouse relative to lower left corner of window.
-    double x, y;
-    glfwGetCursorPos(window, &x, &y);
+    glfwGetCursorPos(window, &event.x, &event.y);
     int width, height;//!!!width, height
     glfwGetWindowSize(window, &width, &height);
-    y = height - y;
+    event.y = height - event.y;
     // Invoke the user's mouse-down or mouse-up handler.
-    if (action == GLFW_PRESS && pixUserMouseDownHandler != NULL)
-        pixUserMouseDownHandler(x, y, button, shiftIsDown, controlIsDown, 
-            altOptionIsDown, superCommandIsDown);
-    else if (action == GLFW_RELEASE && pixUserMouseUpHandler != NULL)
-        pixUserMouseUpHandler(x, y, button, shiftIsDown, controlIsDown, 
-            altOptionIsDown, superCommandIsDown);
+    if (action == GLFW_PRESS)
+        event.type = pixEVENTMOUSEDOWN;
+    else
+        event.type = pixEVENTMOUSEUP;
+    pixDeliverEvent(&event);
 }
 
 // The origin is in the upper left corner of the window.
 void pixHandleMouseMove(GLFWwindow *window, double x, double y) {
-    if (pixUserMouseMoveHandler != NULL) {
-        // Flip vertically, so that the origin is in the lower left.
-        int width, height; //!!!width, height
-        glfwGetWindowSize(window, &width, &height);
-        pixUserMouseMoveHandler(x, height - y);
-    }
+    // Flip vertically, so that the origin is in the lower left.
+    int width, height; //!!!width, height
+    glfwGetWindowSize(window, &width, &height);
+    pixEvent event = {pixEVENTMOUSEMOVE, 0, 0, 0, 0, 0, x, height - y};
+    pixDeliverEvent(&event);
+}
+
+// The window needs repainting, perhaps because it was uncovered. The texture 
+// still holds the last frame, so there's no need to render. The window can't be 
+// resized, so this is the only repaint that the window itself asks for.
+void pixHandleRefresh(GLFWwindow *window) {
+    if (!pixPipelined)
+        pixNeedsRedisplay = 1;
 }
 
 // The origin is in the upper left corner of the window.
 // A 1D scroll wheel will report 0.0 for xOffset.
 void pixHandleMouseScroll(GLFWwindow *window, double xOffset, double yOffset) {
-    if (pixUserMouseScrollHandler != NULL)
-        // Flip vertically, so that the origin is in the lower left.
-        pixUserMouseScrollHandler(xOffset, -yOffset);
+    // Flip vertically, so that the origin is in the lower left.
+    pixEvent event = {pixEVENTMOUSESCROLL, 0, 0, 0, 0, 0, xOffset, -yOffset};
+    pixDeliverEvent(&event);
 }
 
 
@@ -188,6 +584,7 @@ int pixInitGLFWGL3W(const char *name) {
     glfwSetCursorPosCallback(pixWindow, pixHandleMouseMove);
     glfwSetMouseButtonCallback(pixWindow, pixHandleMouseButton);
     glfwSetScrollCallback(pixWindow, pixHandleMouseScroll);
+    glfwSetWindowRefreshCallback(pixWindow, pixHandleRefresh);
     // The following code used to be...
     //glViewport(0, 0, pixOrigWidth, pixOrigHeight);
     int width, height;
@@ -196,11 +593,187 @@ int pixInitGLFWGL3W(const char *name) {
     return 0;
 }
 
-// Create the texture.
+// In pixRGBA8 format, the texture holds bytes rather than floats, and it is fed 
+// through two pixel buffer objects, which pixUploadBytes uses alternately.
+int pixInitTextureBytes() {
+    pixPixels = NULL;
+    pixBytes = (GLubyte *)malloc(4 * pixOrigWidth * pixOrigHeight);
+    if (pixBytes == NULL) {
+        fprintf(stderr, "error: pixInitTextureBytes: malloc failed\n");
+        return 1;
+    }
+    glGenTextures(1, &pixTexture);
+    glBindTexture(GL_TEXTURE_2D, pixTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, pixOrigWidth, pixOrigHeight, 0, 
+        GL_RGBA, GL_UNSIGNED_BYTE, pixBytes);
+    glGenBuffers(2, pixUnpackBuffers);
+    for (int i = 0; i < 2; i += 1) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixUnpackBuffers[i]);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, 4 * pixOrigWidth * pixOrigHeight, 
+            NULL, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    pixUnpackIndex = 0;
+    return 0;
+}
+
+// Sends the given rectangles of pixBytes to the texture through the next pixel 
+// buffer object. Copying into the buffer is a plain memcpy per row, to the same 
+// offsets that the rows have in pixBytes. The transfer from the buffer to the 
+// texture then happens asynchronously, so that it overlaps the rendering of the 
+// next frame. Because the two buffers alternate, and each is orphaned before 
+// it is refilled, the CPU never waits for a transfer still in flight.
+void pixUploadBytes(const GLubyte *bytes, int width, int rectNum, 
+        int rects[][4]) {
+    GLsizeiptr size = 4 * pixOrigWidth * pixOrigHeight;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixUnpackBuffers[pixUnpackIndex]);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+    GLubyte *mapped = (GLubyte *)glMapBuffer(GL_PIXEL_UNPACK_BUFFER, 
+        GL_WRITE_ONLY);
+    if (mapped != NULL) {
+        for (int k = 0; k < rectNum; k += 1)
+            for (int j = rects[k][1]; j < rects[k][1] + rects[k][3]; j += 1) {
+                size_t offset = 4 * (rects[k][0] + width * j);
+                memcpy(mapped + offset, bytes + offset, 4 * rects[k][2]);
+            }
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        // With a buffer bound, the last argument is an offset into it.
+        for (int k = 0; k < rectNum; k += 1)
+            glTexSubImage2D(GL_TEXTURE_2D, 0, rects[k][0], rects[k][1], 
+                rects[k][2], rects[k][3], GL_RGBA, GL_UNSIGNED_BYTE, 
+                (GLvoid *)(size_t)(4 * (rects[k][0] + width * rects[k][1])));
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    } else {
+        // If mapping fails, fall back to a synchronous upload.
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        for (int k = 0; k < rectNum; k += 1)
+            glTexSubImage2D(GL_TEXTURE_2D, 0, rects[k][0], rects[k][1], 
+                rects[k][2], rects[k][3], GL_RGBA, GL_UNSIGNED_BYTE, 
+                &bytes[4 * (rects[k][0] + width * rects[k][1])]);
+    }
+    pixUnpackIndex = 1 - pixUnpackIndex;
+}
+
+// Sends the given rectangles of buffer, which holds pixels in the current 
+// format with rows width pixels long, to the texture. Because 
+// GL_UNPACK_ROW_LENGTH is the row length, each rectangle is read straight out 
+// of the full pixel array.
+void pixUploadRects(const void *buffer, int width, int rectNum, 
+        int rects[][4]) {
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, width);
+    if (pixFormat == pixRGBA8)
+        pixUploadBytes((const GLubyte *)buffer, width, rectNum, rects);
+    else {
+        // In OpenGL 4.5 we might use glTextureSubImage2D. But in OpenGL 2.1 we 
+        // do this.
+        const GLfloat *pixels = (const GLfloat *)buffer;
+        for (int k = 0; k < rectNum; k += 1)
+            glTexSubImage2D(GL_TEXTURE_2D, 0, rects[k][0], rects[k][1], 
+                rects[k][2], rects[k][3], GL_RGB, GL_FLOAT, 
+                &pixels[3 * (rects[k][0] + width * rects[k][1])]);
+    }
+}
+
+// Returns the buffer that pixSetRGB and friends write to.
+void *pixGetBuffer(void) {
+    if (pixFormat == pixRGBA8)
+        return pixBytes;
+    return pixPixels;
+}
+
+// Makes pixSetRGB and friends write to buffer.
+void pixSetBuffer(void *buffer) {
+    if (pixFormat == pixRGBA8)
+        pixBytes = (GLubyte *)buffer;
+    else
+        pixPixels = (GLfloat *)buffer;
+}
+
+// Gathers the dirty rectangles and counts their pixels. Returns the number of 
+// rectangles.
+int pixGatherUpload(int rects[pixMAXDIRTYRECTS][4]) {
+    int rectNum = pixGatherDirty(rects);
+    pixUploadedNum = 0;
+    for (int k = 0; k < rectNum; k += 1)
+        pixUploadedNum += rects[k][2] * rects[k][3];
+    return rectNum;
+}
+
+// Sends the dirty parts of the pixels to the texture.
+void pixUpload(void) {
+    int rects[pixMAXDIRTYRECTS][4];
+    int rectNum = pixGatherUpload(rects);
+    pixUploadRects(pixGetBuffer(), pixWidth, rectNum, rects);
+}
+
+// Draws the lower left width x height texels of the texture over the whole 
+// window. If that is fewer texels than the window has pixels, then they are 
+// stretched with bilinear filtering. texMax keeps the filter from reaching 
+// past the edge of those texels, into stale ones.
+void pixDraw(int width, int height) {
+    GLfloat matrix[] = {
+        2.0 / pixWinWidth, 0.0, 0.0, -1.0,
+        0.0, 2.0 / pixWinHeight, 0.0, -1.0,
+        0.0, 0.0, -1.0, 0.0,
+        0.0, 0.0, 0.0, 1.0};
+    glUniformMatrix4fv(pixUnifLoc, 1, GL_TRUE, matrix);
+    glUniform2f(pixTexScaleLoc, (GLfloat)width / pixOrigWidth, 
+        (GLfloat)height / pixOrigHeight);
+    glUniform2f(pixTexMaxLoc, (width - 0.5) / pixTexWidth, 
+        (height - 0.5) / pixTexHeight);
+    GLint filter = (width < pixOrigWidth || height < pixOrigHeight) ? 
+        GL_LINEAR : GL_NEAREST;
+    if (filter != pixFilter) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+        pixFilter = filter;
+    }
+    glDrawElements(GL_TRIANGLES, 3 * 2, GL_UNSIGNED_SHORT, 0);
+}
+
+// Without a window, allocates just the pixels, as pixInitTexture would.
+int pixInitHeadless() {
+    pixFormat = pixNextFormat;
+    pixPixels = NULL;
+    pixBytes = NULL;
+    if (pixFormat == pixRGBA8)
+        pixBytes = (GLubyte *)malloc(4 * pixOrigWidth * pixOrigHeight);
+    else
+        pixPixels = (GLfloat *)malloc(3 * pixOrigWidth * pixOrigHeight * 
+            sizeof(GLfloat));
+    if (pixBytes == NULL && pixPixels == NULL) {
+        fprintf(stderr, "error: pixInitHeadless: malloc failed\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Allocates the dirty row spans, with every row dirty, so that the first 
+// upload sends the whole window.
+int pixInitDirty() {
+    pixDirtyMins = (int *)malloc(2 * pixOrigHeight * sizeof(int));
+    if (pixDirtyMins == NULL) {
+        fprintf(stderr, "error: pixInitDirty: malloc failed\n");
+        return 1;
+    }
+    pixDirtyMaxs = &pixDirtyMins[pixOrigHeight];
+    pixMarkAllDirty();
+    return 0;
+}
+
+// Create the texture, and in pixRGBA8 format the pixel buffer objects.
 int pixInitTexture() {
-    // !!error if malloc returns NULL
+    pixFormat = pixNextFormat;
+    if (pixFormat == pixRGBA8)
+        return pixInitTextureBytes();
     pixPixels = (GLfloat *)malloc(3 * pixOrigWidth * pixOrigHeight * 
         sizeof(GLfloat));
+    if (pixPixels == NULL) {
+        fprintf(stderr, "error: pixInitTexture: malloc failed\n");
+        return 1;
+    }
     // If we were using OpenGL 4.5, we might do this.
     //glCreateTextures(GL_TEXTURE_RECTANGLE, 1, &pixTexture);
     //glTextureStorage2D(pixTexture, 1, GL_RGB32F, pixTexWidth, pixTexHeight);
@@ -220,23 +793,25 @@ int pixInitTexture() {
 /*
 // Vertex shader.
 uniform mat4 cameraMatrix;
+uniform vec2 texScale;
 attribute vec4 attribs;
 varying vec2 texCoords;
 void main(){
     gl_Position = cameraMatrix * vec4(attribs[0], attribs[1], 0.0, 1.0);
-    texCoords = vec2(attribs[2], attribs[3]);
+    texCoords = vec2(attribs[2], attribs[3]) * texScale;
 }
 // Fragment shader.
 varying vec2 texCoords;
 uniform sampler2D texture0;
+uniform vec2 texMax;
 void main(){
-    gl_FragColor = texture2D(texture0, texCoords);
+    gl_FragColor = texture2D(texture0, min(texCoords, texMax));
 }
 */
 // Build the shader program and leave it bound.
 int pixInitShaders() {
-    GLchar vertexCode[] = "uniform mat4 cameraMatrix;attribute vec4 attribs;varying vec2 texCoords;void main(){gl_Position = cameraMatrix * vec4(attribs[0], attribs[1], 0.0, 1.0);texCoords = vec2(attribs[2], attribs[3]);}";
-    GLchar fragmentCode[] = "varying vec2 texCoords;uniform sampler2D texture0;void main(){gl_FragColor = texture2D(texture0, texCoords);}";
+    GLchar vertexCode[] = "uniform mat4 cameraMatrix;uniform vec2 texScale;attribute vec4 attribs;varying vec2 texCoords;void main(){gl_Position = cameraMatrix * vec4(attribs[0], attribs[1], 0.0, 1.0);texCoords = vec2(attribs[2], attribs[3]) * texScale;}";
+    GLchar fragmentCode[] = "varying vec2 texCoords;uniform sampler2D texture0;uniform vec2 texMax;void main(){gl_FragColor = texture2D(texture0, min(texCoords, texMax));}";
     pixProgram = pixBuildVertexFragmentProgram(vertexCode, fragmentCode);
     glUseProgram(pixProgram);
     // Load identifiers for sampler units, for some reason before validating.
@@ -244,6 +819,9 @@ int pixInitShaders() {
     //!!validateShaderProgram(self.drawingProgram)
     pixUnifLoc = glGetUniformLocation(pixProgram, "cameraMatrix");
     pixAttrLoc = glGetAttribLocation(pixProgram, "attribs");
+    pixTexScaleLoc = glGetUniformLocation(pixProgram, "texScale");
+    pixTexMaxLoc = glGetUniformLocation(pixProgram, "texMax");
+    pixFilter = GL_NEAREST;
     return 0;
 }
 
@@ -274,7 +852,296 @@ int pixInitMesh() {
 
 
 
-/*** Public: miscellaneous ***/
+/*** Private: dynamic resolution ***/
+
+// The controller never scales below this, and it rounds sizes to multiples of 
+// pixSCALESTEP pixels, so that small wobbles in frame time don't resize.
+#define pixMINSCALE 0.25
+#define pixSCALESTEP 8
+// It waits this many frames after each resize before judging again.
+#define pixSCALESETTLE 10
+double pixTargetTime = 0.0; // seconds per time step callback; 0 means no control
+double pixAverageTime = 0.0;
+int pixFramesSinceResize = 0;
+
+// Sets the size of the pixels to the window size times scale, rounded. If the 
+// size changes, then the pixels are cleared to black and the resize callback 
+// is invoked.
+void pixApplyScale(double scale) {
+    scale = (scale < pixMINSCALE) ? pixMINSCALE : scale;
+    scale = (scale > 1.0) ? 1.0 : scale;
+    int width = pixSCALESTEP * (int)(scale * pixOrigWidth / pixSCALESTEP + 0.5);
+    int height = pixSCALESTEP * (int)(scale * pixOrigHeight / pixSCALESTEP + 0.5);
+    width = (width < pixSCALESTEP) ? pixSCALESTEP : width;
+    height = (height < pixSCALESTEP) ? pixSCALESTEP : height;
+    width = (width > pixOrigWidth) ? pixOrigWidth : width;
+    height = (height > pixOrigHeight) ? pixOrigHeight : height;
+    if (width == pixWidth && height == pixHeight)
+        return;
+    pixWidth = width;
+    pixHeight = height;
+    pixClearRGB(0.0, 0.0, 0.0);
+    pixAverageTime = 0.0;
+    pixFramesSinceResize = 0;
+    if (pixUserResizeHandler != NULL)
+        pixUserResizeHandler(pixWidth, pixHeight);
+}
+
+// Called between frames, with the time that the last time step callback took. 
+// The callback's time is roughly proportional to the number of pixels, so the 
+// scale moves by the square root of the ratio of the target to the average. It 
+// moves down as soon as frames run 5% slow, but up only when they run 20% 
+// fast, so that it doesn't oscillate around the target.
+void pixControlResolution(double renderTime) {
+    if (pixTargetTime <= 0.0)
+        return;
+    if (pixAverageTime == 0.0)
+        pixAverageTime = renderTime;
+    else
+        pixAverageTime = 0.8 * pixAverageTime + 0.2 * renderTime;
+    pixFramesSinceResize += 1;
+    if (pixFramesSinceResize < pixSCALESETTLE)
+        return;
+    double ratio = pixTargetTime / pixAverageTime;
+    if (ratio < 1.0 / 1.05 || ratio > 1.2)
+        pixApplyScale((double)pixWidth / pixOrigWidth * sqrt(ratio));
+}
+
+
+
+/*** Private: pipelining ***/
+
+// In pipelined mode there are two CPU framebuffers. The render thread runs the 
+// user's callbacks, drawing frame N + 1 into one buffer, while the main thread 
+// uploads frame N from the other and swaps. The hand-off is guarded by a mutex 
+// and condition variable. pixFrameState says where the hand-off stands.
+#define pixFRAMEIDLE 0 // the main thread is done with the last frame handed off
+#define pixFRAMEREADY 1 // a frame is waiting for the main thread
+#define pixFRAMEBUSY 2 // the main thread is uploading a frame
+pthread_mutex_t pixFrameMutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t pixFrameCond = PTHREAD_COND_INITIALIZER;
+int pixFrameState = pixFRAMEIDLE;
+void *pixFrameBuffer; // the frame handed off
+int pixFrameRects[pixMAXDIRTYRECTS][4], pixFrameRectNum;
+int pixFrameWidth, pixFrameHeight;
+atomic_int pixQuitting = 0;
+void *pixSpareBuffer; // in pipelined mode, the buffer not being drawn into
+
+// Hands the finished frame to the main thread, once the main thread is done 
+// with the previous one, and then brings the spare buffer up to date, so that 
+// the render thread can go on drawing into it.
+void pixHandOff(void) {
+    TRACEBEGIN("pixRun wait");
+    pthread_mutex_lock(&pixFrameMutex);
+    while (pixFrameState != pixFRAMEIDLE && !atomic_load(&pixQuitting))
+        pthread_cond_wait(&pixFrameCond, &pixFrameMutex);
+    if (atomic_load(&pixQuitting)) {
+        pthread_mutex_unlock(&pixFrameMutex);
+        TRACEEND();
+        return;
+    }
+    pixFrameRectNum = pixGatherUpload(pixFrameRects);
+    pixFrameBuffer = pixGetBuffer();
+    pixFrameWidth = pixWidth;
+    pixFrameHeight = pixHeight;
+    pixFrameState = pixFRAMEREADY;
+    pthread_cond_broadcast(&pixFrameCond);
+    pthread_mutex_unlock(&pixFrameMutex);
+    TRACEEND();
+    // The spare buffer holds the frame before this one. Only the dirty 
+    // rectangles differ. The main thread only reads pixFrameBuffer, so copying 
+    // out of it now is safe.
+    TRACEBEGIN("pixRun copy");
+    int channelNum = (pixFormat == pixRGBA8) ? 4 : 3;
+    size_t channelSize = (pixFormat == pixRGBA8) ? 1 : sizeof(GLfloat);
+    for (int k = 0; k < pixFrameRectNum; k += 1)
+        for (int j = pixFrameRects[k][1]; 
+                j < pixFrameRects[k][1] + pixFrameRects[k][3]; j += 1) {
+            size_t offset = channelNum * channelSize * 
+                (pixFrameRects[k][0] + pixWidth * j);
+            memcpy((char *)pixSpareBuffer + offset, 
+                (char *)pixFrameBuffer + offset, 
+                channelNum * channelSize * pixFrameRects[k][2]);
+        }
+    pixSetBuffer(pixSpareBuffer);
+    pixSpareBuffer = pixFrameBuffer;
+    pixNeedsRedisplay = 0;
+    TRACEEND();
+}
+
+// The render thread's loop. It handles the forwarded events, runs the time 
+// step callback, and hands off each frame that was drawn.
+void *pixRunRenderThread(void *arg) {
+    TRACETHREADNAME("pixRun render");
+    while (!atomic_load(&pixQuitting)) {
+        // In on-demand mode, sleep until there is something to do. The main 
+        // thread wakes us after forwarding events.
+        if (pixOnDemand) {
+            int wasIdle = 0;
+            pthread_mutex_lock(&pixFrameMutex);
+            while (!atomic_load(&pixQuitting) && 
+                    !atomic_load(&pixFrameRequested) && !pixEventsPending()) {
+                wasIdle = 1;
+                pthread_cond_wait(&pixFrameCond, &pixFrameMutex);
+            }
+            pthread_mutex_unlock(&pixFrameMutex);
+            if (wasIdle)
+                pixNewTime = pixTime();
+        }
+        TRACESCOPE("pixRun frame");
+        TRACEBEGIN("pixRun events");
+        pixEvent event;
+        while (pixPopEvent(&event))
+            pixDispatchEvent(&event);
+        TRACEEND();
+        if (pixOnDemand && !atomic_load(&pixFrameRequested))
+            continue;
+        TRACEBEGIN("pixRun cap");
+        pixWaitForFrameSlot(0);
+        TRACEEND();
+        atomic_store(&pixFrameRequested, 0);
+        pixOldTime = pixNewTime;
+        pixNewTime = pixTime();
+        pixRecordStep(pixOldTime, pixNewTime);
+        TRACEBEGIN("pixRun time step");
+        if (pixUserTimeStepHandler != NULL)
+            pixUserTimeStepHandler(pixOldTime, pixNewTime);
+        TRACEEND();
+        double renderTime = pixTime() - pixNewTime;
+        if (pixNeedsRedisplay && !pixViewIsLocked) {
+            pixHandOff();
+            // If the main thread is asleep in glfwWaitEvents, wake it.
+            if (pixOnDemand || pixFramePeriod > 0.0)
+                glfwPostEmptyEvent();
+        }
+        pixControlResolution(renderTime);
+    }
+    return NULL;
+}
+
+// The main thread's loop in pipelined mode. Returns an error code, which is 
+// nonzero if pipelining could not start, in which case pixRun runs the usual 
+// loop instead.
+int pixRunPipelined(void) {
+    // Allocate for the full window, in case the resolution scales up.
+    int channelSize = (pixFormat == pixRGBA8) ? 4 : 3 * sizeof(GLfloat);
+    pixSpareBuffer = malloc(channelSize * pixOrigWidth * pixOrigHeight);
+    if (pixSpareBuffer == NULL) {
+        fprintf(stderr, "error: pixRunPipelined: malloc failed\n");
+        return 1;
+    }
+    memcpy(pixSpareBuffer, pixGetBuffer(), pixGetPixelsSize());
+    atomic_store(&pixEventHead, 0);
+    atomic_store(&pixEventTail, 0);
+    atomic_store(&pixQuitting, 0);
+    pixFrameState = pixFRAMEIDLE;
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, pixRunRenderThread, NULL) != 0) {
+        fprintf(stderr, "error: pixRunPipelined: pthread_create failed\n");
+        free(pixSpareBuffer);
+        pixSpareBuffer = NULL;
+        return 2;
+    }
+    TRACETHREADNAME("pixRun present");
+    // If frames come only on demand or at a capped rate, then sleep until 
+    // either an event arrives or the render thread posts one with a frame.
+    int mayWait = pixOnDemand || pixFramePeriod > 0.0;
+    while (glfwWindowShouldClose(pixWindow) == GL_FALSE) {
+        TRACEBEGIN("pixRun events");
+        if (mayWait)
+            glfwWaitEvents();
+        else
+            glfwPollEvents();
+        TRACEEND();
+        // Wait briefly for a frame, so that events keep flowing even when the 
+        // render thread is slow. But wake the render thread first, if it is 
+        // waiting for events.
+        pthread_mutex_lock(&pixFrameMutex);
+        if (mayWait)
+            pthread_cond_broadcast(&pixFrameCond);
+        else if (pixFrameState != pixFRAMEREADY) {
+            struct timespec until;
+            clock_gettime(CLOCK_REALTIME, &until);
+            until.tv_nsec += 2000000;
+            if (until.tv_nsec >= 1000000000) {
+                until.tv_sec += 1;
+                until.tv_nsec -= 1000000000;
+            }
+            pthread_cond_timedwait(&pixFrameCond, &pixFrameMutex, &until);
+        }
+        int ready = (pixFrameState == pixFRAMEREADY);
+        if (ready)
+            pixFrameState = pixFRAMEBUSY;
+        pthread_mutex_unlock(&pixFrameMutex);
+        if (!ready)
+            continue;
+        // Once the pixels are uploaded, the render thread may reuse the buffer, 
+        // even while the main thread draws and swaps.
+        TRACEBEGIN("pixRun upload");
+        pixUploadRects(pixFrameBuffer, pixFrameWidth, pixFrameRectNum, 
+            pixFrameRects);
+        pthread_mutex_lock(&pixFrameMutex);
+        pixFrameState = pixFRAMEIDLE;
+        pthread_cond_broadcast(&pixFrameCond);
+        pthread_mutex_unlock(&pixFrameMutex);
+        pixDraw(pixFrameWidth, pixFrameHeight);
+        TRACEEND();
+        TRACEBEGIN("pixRun swap");
+        glfwSwapBuffers(pixWindow);
+        TRACEEND();
+    }
+    pthread_mutex_lock(&pixFrameMutex);
+    atomic_store(&pixQuitting, 1);
+    pthread_cond_broadcast(&pixFrameCond);
+    pthread_mutex_unlock(&pixFrameMutex);
+    pthread_join(thread, NULL);
+    // Keep the buffer that the render thread was drawing into. Because the 
+    // dirty spans no longer match the texture, the next upload sends it all.
+    free(pixSpareBuffer);
+    pixSpareBuffer = NULL;
+    pixMarkAllDirty();
+    return 0;
+}
+
+// The loop while replaying. Events come from the recording rather than the 
+// user, and time steps from the recording or the fixed step. Nothing waits: 
+// on-demand mode and the frame cap are ignored, as is dynamic resolution, 
+// whose choices depend on timing. Ends with the recording.
+void pixRunReplay(void) {
+    int rects[pixMAXDIRTYRECTS][4];
+    while (pixHeadless || glfwWindowShouldClose(pixWindow) == GL_FALSE) {
+        TRACESCOPE("pixRun frame");
+        TRACEBEGIN("pixRun events");
+        // Let the user close the window. Other input is ignored.
+        if (!pixHeadless)
+            glfwPollEvents();
+        int error = pixReplayFrame(&pixOldTime, &pixNewTime);
+        TRACEEND();
+        if (error != 0)
+            break;
+        pixRecordStep(pixOldTime, pixNewTime);
+        TRACEBEGIN("pixRun time step");
+        if (pixUserTimeStepHandler != NULL)
+            pixUserTimeStepHandler(pixOldTime, pixNewTime);
+        TRACEEND();
+        if (pixNeedsRedisplay && !pixViewIsLocked) {
+            if (pixHeadless)
+                pixGatherUpload(rects);
+            else {
+                TRACEBEGIN("pixRun upload");
+                pixUpload();
+                pixDraw(pixWidth, pixHeight);
+                TRACEEND();
+                TRACEBEGIN("pixRun swap");
+                glfwSwapBuffers(pixWindow);
+                TRACEEND();
+            }
+            pixNeedsRedisplay = 0;
+        }
+    }
+    fclose(pixReplayFile);
+    pixReplayFile = NULL;
+}
 
 /* A pixel system program usually proceeds through these five steps:
     A. pixInitialize is invoked to set up certain resources.
@@ -302,18 +1169,46 @@ int pixInitialize(int width, int height, const char *name) {
     pixOrigHeight = pixTexHeight;
     pixWinWidth = pixOrigWidth;
     pixWinHeight = pixOrigHeight;
+    pixWidth = pixOrigWidth;
+    pixHeight = pixOrigHeight;
+    pixTargetTime = 0.0;
+    atomic_store(&pixFrameRequested, 1);
+    pixNextFrameTime = pixMonotonicTime();
     if (pixOrigWidth != width || pixOrigHeight != height) {
         fprintf(stderr, "warning: pixInitialize: ");
         fprintf(stderr, "forcing width, height to be powers of 2.\n");
     }
-    // !!when errors happen midway through, should deallocate resources so far
-    error = pixInitGLFWGL3W(name);
-    if (!error)
-        error = pixInitTexture();
-    if (!error)
-        error = pixInitShaders();
+    pixHeadless = pixNextHeadless;
+    pixFrameIndex = 0;
+    // Zero the names, so that a failure midway can release everything with 
+    // pixFinalize, without deleting stale names from a previous window.
+    pixPixels = NULL;
+    pixBytes = NULL;
+    pixDirtyMins = NULL;
+    pixDirtyMaxs = NULL;
+    pixTexture = 0;
+    pixUnpackBuffers[0] = 0;
+    pixUnpackBuffers[1] = 0;
+    pixAttrBuffer = 0;
+    pixTriBuffer = 0;
+    pixProgram = 0;
+    if (pixHeadless)
+        error = pixInitHeadless();
+    else {
+        error = pixInitGLFWGL3W(name);
+        if (!error)
+            error = pixInitTexture();
+        if (!error)
+            error = pixInitShaders();
+        if (!error)
+            error = pixInitMesh();
+    }
     if (!error)
-        error = pixInitMesh();
+        error = pixInitDirty();
+    if (error) {
+        pixFinalize();
+        return error;
+    }
     pixNewTime = pixTime();
     //fprintf(stderr, "pixInitialize: OpenGL %s, GLSL %s.\n", 
     //    glGetString(GL_VERSION), glGetString(GL_SHADING_LANGUAGE_VERSION));
@@ -323,31 +1218,62 @@ int pixInitialize(int width, int height, const char *name) {
 /* Runs the event loop. First, any pending user events are processed by their 
 corresponding callbacks. Second, the time step callback is invoked. Third, if 
 any drawing has occurred, then the screen is updated to reflect that drawing. 
-When the user elects to quit, this function terminates. */
+When the user elects to quit, this function terminates. While replaying (see 
+pixStartReplay), the events and times come from the recording instead, and this 
+function terminates when the recording ends. Without a window (see 
+pixSetHeadless), this function does nothing unless replaying. */
 void pixRun(void) {
+    if (pixReplayFile != NULL) {
+        pixRunReplay();
+        return;
+    }
+    if (pixHeadless) {
+        fprintf(stderr, "warning: pixRun: no window and nothing to replay\n");
+        return;
+    }
+    if (pixPipelined && pixRunPipelined() == 0)
+        return;
     while (glfwWindowShouldClose(pixWindow) == GL_FALSE) {
-        glfwPollEvents();
-        pixOldTime = pixNewTime;
-        pixNewTime = pixTime();
-        if (pixUserTimeStepHandler != NULL)
-            pixUserTimeStepHandler(pixOldTime, pixNewTime);
-        if (pixNeedsRedisplay) {
-            // In OpenGL 4.5 we might do this.
-            //glTextureSubImage2D(pixTexture, 0, 0, 0, pixOrigWidth, 
-            //    pixOrigHeight, GL_RGB, GL_FLOAT, pixPixels);
-            // But in OpenGL 2.1 we do this.
-            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, pixOrigWidth, 
-                pixOrigHeight, GL_RGB, GL_FLOAT, pixPixels);
-            GLfloat matrix[] = {
-                2.0 / pixWinWidth, 0.0, 0.0, -1.0,
-                0.0, 2.0 / pixWinHeight, 0.0, -1.0,
-                0.0, 0.0, -1.0, 0.0,
-                0.0, 0.0, 0.0, 1.0};
-            glUniformMatrix4fv(pixUnifLoc, 1, GL_TRUE, matrix);
-            glDrawElements(GL_TRIANGLES, 3 * 2, GL_UNSIGNED_SHORT, 0);
+        TRACESCOPE("pixRun frame");
+        TRACEBEGIN("pixRun events");
+        // In on-demand mode with nothing to do, sleep until an event arrives. 
+        // Then restart the clock, so that the next time step doesn't include 
+        // the idle time.
+        int isIdle = pixOnDemand && !atomic_load(&pixFrameRequested) && 
+            !pixNeedsRedisplay;
+        if (isIdle) {
+            glfwWaitEvents();
+            pixNewTime = pixTime();
+        } else
+            glfwPollEvents();
+        TRACEEND();
+        double renderTime = -1.0;
+        if (!pixOnDemand || atomic_load(&pixFrameRequested)) {
+            TRACEBEGIN("pixRun cap");
+            pixWaitForFrameSlot(1);
+            TRACEEND();
+            atomic_store(&pixFrameRequested, 0);
+            pixOldTime = pixNewTime;
+            pixNewTime = pixTime();
+            pixRecordStep(pixOldTime, pixNewTime);
+            TRACEBEGIN("pixRun time step");
+            if (pixUserTimeStepHandler != NULL)
+                pixUserTimeStepHandler(pixOldTime, pixNewTime);
+            TRACEEND();
+            renderTime = pixTime() - pixNewTime;
+        }
+        if (pixNeedsRedisplay && !pixViewIsLocked) {
+            TRACEBEGIN("pixRun upload");
+            pixUpload();
+            pixDraw(pixWidth, pixHeight);
+            TRACEEND();
+            TRACEBEGIN("pixRun swap");
             glfwSwapBuffers(pixWindow);
+            TRACEEND();
             pixNeedsRedisplay = 0;
         }
+        if (renderTime >= 0.0)
+            pixControlResolution(renderTime);
     }
 }
 
@@ -355,6 +1281,21 @@ void pixRun(void) {
 called, pixInitialize must be called again, before any further use of the pixel 
 system. */
 void pixFinalize(void) {
+    pixStopRecording();
+    if (pixReplayFile != NULL) {
+        fclose(pixReplayFile);
+        pixReplayFile = NULL;
+    }
+    if (pixHeadless) {
+        free(pixPixels);
+        free(pixBytes);
+        free(pixDirtyMins);
+        pixPixels = NULL;
+        pixBytes = NULL;
+        pixDirtyMins = NULL;
+        pixDirtyMaxs = NULL;
+        return;
+    }
     glDisableVertexAttribArray(pixAttrLoc);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
@@ -363,60 +1304,263 @@ void pixFinalize(void) {
     //glUseProgram(0);
     glDeleteProgram(pixProgram);
     glDeleteTextures(1, &pixTexture);
+    if (pixFormat == pixRGBA8)
+        glDeleteBuffers(2, pixUnpackBuffers);
     free(pixPixels);
+    free(pixBytes);
+    free(pixDirtyMins);
+    pixPixels = NULL;
+    pixBytes = NULL;
+    pixDirtyMins = NULL;
+    pixDirtyMaxs = NULL;
     glfwDestroyWindow(pixWindow);
     glfwTerminate();
 }
 
+/* Chooses how the pixel system stores the window's pixels, starting with the 
+next pixInitialize. The default, pixRGBFLOAT, stores 3 floats per pixel. 
+pixRGBA8 stores 4 bytes per pixel, which is a third of the memory and a third 
+of the bandwidth for each upload to the screen, and the uploads overlap 
+rendering. In pixRGBA8 format, colors are clamped to [0, 1] and rounded to the 
+nearest 1 / 255 as they are set, so pixGetR and friends return the rounded 
+values. */
+void pixSetFormat(int format) {
+    if (format == pixRGBA8)
+        pixNextFormat = pixRGBA8;
+    else
+        pixNextFormat = pixRGBFLOAT;
+}
+
+/* Chooses whether pixRun pipelines rendering with presentation. By default, 
+pixRun handles events, runs the time step callback, and then updates the screen, 
+one after the other. With pipelined set to 1, pixRun runs all of the callbacks 
+on a second thread, the render thread, and keeps two copies of the window's 
+pixels. While the time step callback draws frame N + 1 into one copy, the main 
+thread sends frame N to the screen from the other. So each frame takes about as 
+long as the slower of the two, rather than their sum, although the screen lags 
+one frame further behind the input. The callbacks must not call GLFW or OpenGL 
+functions, because those belong to the main thread. Call this function before 
+pixRun. */
+void pixSetPipelined(int pipelined) {
+    pixPipelined = (pipelined != 0);
+}
+
+/* Chooses whether pixRun renders only on demand. By default, pixRun invokes 
+the time step callback over and over, as fast as it can (or as fast as the frame 
+cap allows). With onDemand set to 1, pixRun invokes the time step callback only 
+after pixRequestFrame has been called, and otherwise sleeps until the next user 
+event, using almost no processor time. So a program whose scene changes only in 
+response to the user should call pixRequestFrame from its key and mouse 
+callbacks. A program that is animating should call pixRequestFrame from its 
+time step callback, for as long as the animation lasts. After a sleep, the 
+oldTime passed to the time step callback is just before newTime, so animations 
+don't jump ahead by the time spent asleep. The first frame is always requested. 
+*/
+void pixSetOnDemand(int onDemand) {
+    pixOnDemand = (onDemand != 0);
+}
+
+/* In on-demand mode, asks pixRun to invoke the time step callback once more, 
+soon. Requests made before that invocation are merged into it. In the default 
+mode, this function has no effect. */
+void pixRequestFrame(void) {
+    atomic_store(&pixFrameRequested, 1);
+}
+
+/* Caps the rate at which pixRun invokes the time step callback. Between frames 
+pixRun sleeps, rather than polling, and it goes on handling user events while 
+it sleeps. A framesPerSecond of 0.0 removes the cap. */
+void pixSetFrameCap(double framesPerSecond) {
+    pixFramePeriod = (framesPerSecond > 0.0) ? 1.0 / framesPerSecond : 0.0;
+    pixNextFrameTime = pixMonotonicTime();
+}
+
+/* Chooses whether the next pixInitialize opens a window (0, the default) or not 
+(1). Without a window, there is no screen and no user input, but the pixels 
+themselves work as usual, so a recording (see pixStartReplay) can be replayed 
+on a machine without a display, for example to time it. */
+void pixSetHeadless(int headless) {
+    pixNextHeadless = (headless != 0);
+}
+
+/* Starts recording every key and mouse event that reaches the callbacks, and 
+every invocation of the time step callback with its times, to a compact binary 
+file at path. pixStartReplay can then feed the same input to the same program, 
+frame for frame. Call this function after pixInitialize and before pixRun. 
+Recording stops at pixStopRecording or pixFinalize. Returns an error code (0 on 
+success). */
+int pixStartRecording(const char *path) {
+    pixStopRecording();
+    pixRecordFile = pixOpenRecording(path, "wb");
+    if (pixRecordFile == NULL)
+        return 1;
+    pixFrameIndex = 0;
+    return 0;
+}
+
+/* Stops recording, and finishes writing the file. */
+void pixStopRecording(void) {
+    if (pixRecordFile == NULL)
+        return;
+    if (fclose(pixRecordFile) != 0)
+        fprintf(stderr, "error: pixStopRecording: could not finish file\n");
+    pixRecordFile = NULL;
+}
+
+/* Makes the next pixRun replay the recording at path, made by 
+pixStartRecording, instead of listening to the user. Each recorded event is 
+handed to its callback just before the time step in which it originally 
+arrived. If timeStep is positive, then the time step callback sees a simulated 
+clock that advances by exactly timeStep seconds per frame. Otherwise it sees the 
+recorded times. Either way, the same program replaying the same recording runs 
+the same frames, so that timings from two builds can be compared fairly. During 
+replay, pixRun runs as fast as it can, ignoring the on-demand mode, the frame 
+cap, pipelining, and dynamic resolution. It returns when the recording ends. 
+Call this function after pixInitialize. Returns an error code (0 on success). 
+*/
+int pixStartReplay(const char *path, double timeStep) {
+    if (pixReplayFile != NULL)
+        fclose(pixReplayFile);
+    pixReplayFile = pixOpenRecording(path, "rb");
+    if (pixReplayFile == NULL)
+        return 1;
+    pixReplayStep = (timeStep > 0.0) ? timeStep : 0.0;
+    pixFrameIndex = 0;
+    return 0;
+}
+
+/* Returns the number of time steps recorded or replayed since pixInitialize, 
+pixStartRecording, or pixStartReplay. */
+int pixGetFrameIndex(void) {
+    return (int)pixFrameIndex;
+}
+
+/* Returns the width of the pixels. This is the window's width, unless the 
+resolution has been scaled down by pixSetResolutionScale or 
+pixSetTargetFrameTime. All of the functions that take pixel coordinates, such 
+as pixSetRGB, work in this width and pixGetHeight. (The mouse callbacks still 
+report window coordinates.) */
+int pixGetWidth(void) {
+    return pixWidth;
+}
+
+/* Returns the height of the pixels. See pixGetWidth. */
+int pixGetHeight(void) {
+    return pixHeight;
+}
+
+/* Renders at a lower resolution, which the graphics card stretches to fill the 
+window, with bilinear filtering. scale is clamped to [0.25, 1]. The width and 
+height become the window's width and height times scale, rounded to a multiple 
+of 8, so they need not be powers of 2. If they change, the pixels are cleared 
+to black and the resize callback is invoked. */
+void pixSetResolutionScale(double scale) {
+    pixApplyScale(scale);
+}
+
+/* Returns the current width of the pixels divided by the window's width. */
+double pixGetResolutionScale(void) {
+    return (double)pixWidth / pixOrigWidth;
+}
+
+/* Turns on dynamic resolution. Between frames, pixRun measures how long the 
+time step callback took, and scales the resolution (as pixSetResolutionScale 
+does) to bring that time to about seconds. Because the callback does less work 
+at lower resolution, the frame rate holds steady as the scene gets harder to 
+render, at the cost of sharpness. A seconds of 0.0 turns the control off, 
+leaving the scale where it is. */
+void pixSetTargetFrameTime(double seconds) {
+    pixTargetTime = (seconds > 0.0) ? seconds : 0.0;
+    pixAverageTime = 0.0;
+    pixFramesSinceResize = 0;
+}
+
+/* Returns the target set by pixSetTargetFrameTime, or 0.0 if there is none. */
+double pixGetTargetFrameTime(void) {
+    return pixTargetTime;
+}
+
 /* Returns the red channel of the pixel at coordinates (x, y). Coordinates are 
 relative to the lower left corner of the window. */
 double pixGetR(int x, int y) {
-    if (0 <= x && x < pixOrigWidth && 0 <= y && y < pixOrigHeight)
-        return pixPixels[3 * (x + pixOrigWidth * y)];
-    else
+    if (0 <= x && x < pixWidth && 0 <= y && y < pixHeight) {
+        if (pixFormat == pixRGBA8)
+            return pixBytes[4 * (x + pixWidth * y)] / 255.0;
+        return pixPixels[3 * (x + pixWidth * y)];
+    } else
         return -1.0;
 }
 
 /* Returns the green channel of the pixel at coordinates (x, y). Coordinates 
 are relative to the lower left corner of the window. */
 double pixGetG(int x, int y) {
-    if (0 <= x && x < pixOrigWidth && 0 <= y && y < pixOrigHeight)
-        return pixPixels[3 * (x + pixOrigWidth * y) + 1];
-    else
+    if (0 <= x && x < pixWidth && 0 <= y && y < pixHeight) {
+        if (pixFormat == pixRGBA8)
+            return pixBytes[4 * (x + pixWidth * y) + 1] / 255.0;
+        return pixPixels[3 * (x + pixWidth * y) + 1];
+    } else
         return -1.0;
 }
 
 /* Returns the blue channel of the pixel at coordinates (x, y). Coordinates are 
 relative to the lower left corner of the window. */
 double pixGetB(int x, int y) {
-    if (0 <= x && x < pixOrigWidth && 0 <= y && y < pixOrigHeight)
-        return pixPixels[3 * (x + pixOrigWidth * y) + 2];
-    else
+    if (0 <= x && x < pixWidth && 0 <= y && y < pixHeight) {
+        if (pixFormat == pixRGBA8)
+            return pixBytes[4 * (x + pixWidth * y) + 2] / 255.0;
+        return pixPixels[3 * (x + pixWidth * y) + 2];
+    } else
         return -1.0;
 }
 
 /* Sets the pixel at coordinates (x, y) to the given RGB color. Coordinates are 
 relative to the lower left corner of the window. */
 void pixSetRGB(int x, int y, double red, double green, double blue) {
-    if (0 <= x && x < pixOrigWidth && 0 <= y && y < pixOrigHeight) {
-        int index = 3 * (x + pixOrigWidth * y);
+    if (0 <= x && x < pixWidth && 0 <= y && y < pixHeight) {
+        if (pixFormat == pixRGBA8) {
+            GLubyte *byte = &pixBytes[4 * (x + pixWidth * y)];
+            byte[0] = pixByte(red);
+            byte[1] = pixByte(green);
+            byte[2] = pixByte(blue);
+            byte[3] = 255;
+            pixMarkDirty(x, y);
+            return;
+        }
+        int index = 3 * (x + pixWidth * y);
         pixPixels[index] = red;
         pixPixels[index + 1] = green;
         pixPixels[index + 2] = blue;
-        pixNeedsRedisplay = 1;
+        pixMarkDirty(x, y);
     }
 }
 
 /* Sets all pixels to the given RGB color. */
 void pixClearRGB(double red, double green, double blue) {
+    if (pixFormat == pixRGBA8) {
+        GLubyte color[4] = {pixByte(red), pixByte(green), pixByte(blue), 255};
+        for (int i = 0; i < pixWidth * pixHeight; i += 1)
+            memcpy(&pixBytes[4 * i], color, 4);
+        pixMarkAllDirty();
+        return;
+    }
     int index, bound;
-    bound = 3 * pixOrigWidth * pixOrigHeight;
+    bound = 3 * pixWidth * pixHeight;
     for (index = 0; index < bound; index += 3) {
         pixPixels[index] = red;
         pixPixels[index + 1] = green;
         pixPixels[index + 2] = blue;
     }
-    pixNeedsRedisplay = 1;
+    pixMarkAllDirty();
+}
+
+/* Returns the number of pixels that the most recent screen update sent to the 
+graphics card. The pixel system tracks which pixels have been set since the 
+previous update, and sends only the rectangles around them, unless those 
+rectangles are numerous or large enough that sending the whole window is 
+cheaper. So a program that redraws only a small part of the window, such as a 
+moving sprite over a static background, sends only that part. */
+int pixGetUploadedNum(void) {
+    return pixUploadedNum;
 }
 
 /* data must be an array of width * height * 3 doubles, so that it can hold RGB 
@@ -424,24 +1568,154 @@ for each pixel in the window. This function copies the current window contents
 out to the data array. Pixel (i, j) (measured from the lower left) ends up at 
 data[(i + width * j) * 3] and the two doubles following that. */
 void pixCopyRGB(double *data) {
-    int k = 0;
-    for (int j = 0; j < pixOrigHeight; j += 1)
-        for (int i = 0; i < pixOrigWidth; i += 1) {
-            data[k++] = pixGetR(i, j);
-            data[k++] = pixGetG(i, j);
-            data[k++] = pixGetB(i, j);
+    int pixelNum = pixWidth * pixHeight;
+    if (pixFormat == pixRGBA8)
+        for (int k = 0; k < pixelNum; k += 1) {
+            data[3 * k] = pixBytes[4 * k] / 255.0;
+            data[3 * k + 1] = pixBytes[4 * k + 1] / 255.0;
+            data[3 * k + 2] = pixBytes[4 * k + 2] / 255.0;
         }
+    else
+        for (int k = 0; k < 3 * pixelNum; k += 1)
+            data[k] = pixPixels[k];
 }
 
 /* Inverse of pixCopyRGB. This function pastes the contents of the data array 
 into the window. */
 void pixPasteRGB(double *data) {
-    int k = 0;
-    for (int j = 0; j < pixOrigHeight; j += 1)
-        for (int i = 0; i < pixOrigWidth; i += 1) {
-            pixSetRGB(i, j, data[k], data[k + 1], data[k + 2]);
-            k += 3;
+    for (int j = 0; j < pixHeight; j += 1)
+        pixSetSpanRGB(0, j, pixWidth, &data[3 * pixWidth * j]);
+}
+
+/* Sets width pixels of row y, starting at x and moving right, to the colors in 
+rgb, which holds 3 * width doubles. Pixels outside the window are skipped. This 
+is much faster than setting the pixels one at a time with pixSetRGB. */
+void pixSetSpanRGB(int x, int y, int width, const double rgb[]) {
+    if (y < 0 || y >= pixHeight)
+        return;
+    int xMin = (x < 0) ? 0 : x;
+    int xMax = (x + width > pixWidth) ? pixWidth - 1 : x + width - 1;
+    if (xMin > xMax)
+        return;
+    const double *src = &rgb[3 * (xMin - x)];
+    if (pixFormat == pixRGBA8) {
+        GLubyte *dst = &pixBytes[4 * (xMin + pixWidth * y)];
+        for (int i = 0; i <= xMax - xMin; i += 1) {
+            dst[4 * i] = pixByte(src[3 * i]);
+            dst[4 * i + 1] = pixByte(src[3 * i + 1]);
+            dst[4 * i + 2] = pixByte(src[3 * i + 2]);
+            dst[4 * i + 3] = 255;
         }
+    } else {
+        GLfloat *dst = &pixPixels[3 * (xMin + pixWidth * y)];
+        for (int k = 0; k < 3 * (xMax - xMin + 1); k += 1)
+            dst[k] = src[k];
+    }
+    pixMarkSpan(xMin, xMax, y);
+}
+
+/* Sets the pixels in the rectangle with lower left corner (x, y) and the given 
+width and height to the given RGB color. The parts of the rectangle outside the 
+window are skipped. */
+void pixFillRect(int x, int y, int width, int height, double red, double green, 
+        double blue) {
+    int xMin = (x < 0) ? 0 : x;
+    int xMax = (x + width > pixWidth) ? pixWidth - 1 : x + width - 1;
+    int yMin = (y < 0) ? 0 : y;
+    int yMax = (y + height > pixHeight) ? pixHeight - 1 : y + height - 1;
+    if (xMin > xMax || yMin > yMax)
+        return;
+    if (pixFormat == pixRGBA8) {
+        GLubyte color[4] = {pixByte(red), pixByte(green), pixByte(blue), 255};
+        // Fill the first row, and then copy it to the others.
+        GLubyte *first = &pixBytes[4 * (xMin + pixWidth * yMin)];
+        for (int i = 0; i <= xMax - xMin; i += 1)
+            memcpy(&first[4 * i], color, 4);
+        for (int j = yMin + 1; j <= yMax; j += 1)
+            memcpy(&pixBytes[4 * (xMin + pixWidth * j)], first, 
+                4 * (xMax - xMin + 1));
+    } else {
+        GLfloat *first = &pixPixels[3 * (xMin + pixWidth * yMin)];
+        for (int i = 0; i <= xMax - xMin; i += 1) {
+            first[3 * i] = red;
+            first[3 * i + 1] = green;
+            first[3 * i + 2] = blue;
+        }
+        for (int j = yMin + 1; j <= yMax; j += 1)
+            memcpy(&pixPixels[3 * (xMin + pixWidth * j)], first, 
+                3 * (xMax - xMin + 1) * sizeof(GLfloat));
+    }
+    for (int j = yMin; j <= yMax; j += 1)
+        pixMarkSpan(xMin, xMax, j);
+}
+
+/* Returns the number of bytes that pixCopyPixels and pixPastePixels use. */
+int pixGetPixelsSize(void) {
+    if (pixFormat == pixRGBA8)
+        return 4 * pixWidth * pixHeight;
+    return 3 * pixWidth * pixHeight * sizeof(GLfloat);
+}
+
+/* Copies the window's pixels, in the pixel system's own format, to data, which 
+must hold pixGetPixelsSize() bytes. This is a single memcpy, so it is the 
+fastest way to save the window, for example to restore a static background 
+later with pixPastePixels. */
+void pixCopyPixels(void *data) {
+    if (pixFormat == pixRGBA8)
+        memcpy(data, pixBytes, pixGetPixelsSize());
+    else
+        memcpy(data, pixPixels, pixGetPixelsSize());
+}
+
+/* Inverse of pixCopyPixels. data must have been filled by pixCopyPixels, in 
+the same format and window size. */
+void pixPastePixels(const void *data) {
+    if (pixFormat == pixRGBA8)
+        memcpy(pixBytes, data, pixGetPixelsSize());
+    else
+        memcpy(pixPixels, data, pixGetPixelsSize());
+    pixMarkAllDirty();
+}
+
+/* Gives direct access to the window's pixels, by filling in view. Until 
+pixUnlockView is called, the caller may read and write the pixels through view, 
+and pixRun holds off updating the screen. Returns an error code, which is 
+nonzero if the view is already locked. */
+int pixLockView(pixView *view) {
+    if (pixViewIsLocked) {
+        fprintf(stderr, "error: pixLockView: view already locked\n");
+        return 1;
+    }
+    pixViewIsLocked = 1;
+    view->format = pixFormat;
+    view->width = pixWidth;
+    view->height = pixHeight;
+    if (pixFormat == pixRGBA8) {
+        view->channelNum = 4;
+        view->floats = NULL;
+        view->bytes = pixBytes;
+    } else {
+        view->channelNum = 3;
+        view->floats = pixPixels;
+        view->bytes = NULL;
+    }
+    view->stride = view->channelNum * pixWidth;
+    return 0;
+}
+
+/* Ends direct access. The rectangle with lower left corner (x, y) and the 
+given width and height must include every pixel written through the view, so 
+that the screen update sends it. Pass a width or height of 0 if nothing was 
+written. */
+void pixUnlockView(int x, int y, int width, int height) {
+    pixViewIsLocked = 0;
+    int xMin = (x < 0) ? 0 : x;
+    int xMax = (x + width > pixWidth) ? pixWidth - 1 : x + width - 1;
+    int yMin = (y < 0) ? 0 : y;
+    int yMax = (y + height > pixHeight) ? pixHeight - 1 : y + height - 1;
+    if (xMin <= xMax)
+        for (int j = yMin; j <= yMax; j += 1)
+            pixMarkSpan(xMin, xMax, j);
 }
 
 
@@ -529,3 +1803,15 @@ void pixSetTimeStepHandler(void (*handler)(double, double)) {
     pixUserTimeStepHandler = handler;
 }
 
+/* Sets a callback function that fires whenever the width and height of the 
+pixels change, because of pixSetResolutionScale or pixSetTargetFrameTime. 
+Invoked using something like 
+    pixSetResizeHandler(myResizeHandler);
+where myResizeHandler is defined something like
+    void myResizeHandler(int width, int height);
+A program that renders at a lower resolution should use it to resize its depth 
+buffer, viewport, and so on. It is invoked between frames. */
+void pixSetResizeHandler(void (*handler)(int, int)) {
+    pixUserResizeHandler = handler;
+}
+
@@ -33,7 +33,10 @@ int pixInitialize(int width, int height, const char *name);
 /* Runs the event loop. First, any pending user events are processed by their 
 corresponding callbacks. Second, the time step callback is invoked. Third, if 
 any drawing has occurred, then the screen is updated to reflect that drawing. 
-When the user elects to quit, this function terminates. */
+When the user elects to quit, this function terminates. While replaying (see 
+pixStartReplay), the events and times come from the recording instead, and this 
+function terminates when the recording ends. Without a window (see 
+pixSetHeadless), this function does nothing unless replaying. */
 void pixRun(void);
 
 /* Deallocates the resources supporting the window. After this function is 
@@ -41,6 +44,119 @@ called, pixInitialize must be called again, before any further use of the pixel
 system. */
 void pixFinalize(void);
 
+/* Pixel formats, for pixSetFormat. */
+#define pixRGBFLOAT 0
+#define pixRGBA8 1
+
+/* Chooses how the pixel system stores the window's pixels, starting with the 
+next pixInitialize. The default, pixRGBFLOAT, stores 3 floats per pixel. 
+pixRGBA8 stores 4 bytes per pixel, which is a third of the memory and a third 
+of the bandwidth for each upload to the screen, and the uploads overlap 
+rendering. In pixRGBA8 format, colors are clamped to [0, 1] and rounded to the 
+nearest 1 / 255 as they are set, so pixGetR and friends return the rounded 
+values. */
+void pixSetFormat(int format);
+
+/* Chooses whether pixRun pipelines rendering with presentation. By default, 
+pixRun handles events, runs the time step callback, and then updates the screen, 
+one after the other. With pipelined set to 1, pixRun runs all of the callbacks 
+on a second thread, the render thread, and keeps two copies of the window's 
+pixels. While the time step callback draws frame N + 1 into one copy, the main 
+thread sends frame N to the screen from the other. So each frame takes about as 
+long as the slower of the two, rather than their sum, although the screen lags 
+one frame further behind the input. The callbacks must not call GLFW or OpenGL 
+functions, because those belong to the main thread. Call this function before 
+pixRun. */
+void pixSetPipelined(int pipelined);
+
+/* Chooses whether pixRun renders only on demand. By default, pixRun invokes 
+the time step callback over and over, as fast as it can (or as fast as the frame 
+cap allows). With onDemand set to 1, pixRun invokes the time step callback only 
+after pixRequestFrame has been called, and otherwise sleeps until the next user 
+event, using almost no processor time. So a program whose scene changes only in 
+response to the user should call pixRequestFrame from its key and mouse 
+callbacks. A program that is animating should call pixRequestFrame from its 
+time step callback, for as long as the animation lasts. After a sleep, the 
+oldTime passed to the time step callback is just before newTime, so animations 
+don't jump ahead by the time spent asleep. The first frame is always requested. 
+*/
+void pixSetOnDemand(int onDemand);
+
+/* In on-demand mode, asks pixRun to invoke the time step callback once more, 
+soon. Requests made before that invocation are merged into it. In the default 
+mode, this function has no effect. */
+void pixRequestFrame(void);
+
+/* Caps the rate at which pixRun invokes the time step callback. Between frames 
+pixRun sleeps, rather than polling, and it goes on handling user events while 
+it sleeps. A framesPerSecond of 0.0 removes the cap. */
+void pixSetFrameCap(double framesPerSecond);
+
+/* Chooses whether the next pixInitialize opens a window (0, the default) or not 
+(1). Without a window, there is no screen and no user input, but the pixels 
+themselves work as usual, so a recording (see pixStartReplay) can be replayed 
+on a machine without a display, for example to time it. */
+void pixSetHeadless(int headless);
+
+/* Starts recording every key and mouse event that reaches the callbacks, and 
+every invocation of the time step callback with its times, to a compact binary 
+file at path. pixStartReplay can then feed the same input to the same program, 
+frame for frame. Call this function after pixInitialize and before pixRun. 
+Recording stops at pixStopRecording or pixFinalize. Returns an error code (0 on 
+success). */
+int pixStartRecording(const char *path);
+
+/* Stops recording, and finishes writing the file. */
+void pixStopRecording(void);
+
+/* Makes the next pixRun replay the recording at path, made by 
+pixStartRecording, instead of listening to the user. Each recorded event is 
+handed to its callback just before the time step in which it originally 
+arrived. If timeStep is positive, then the time step callback sees a simulated 
+clock that advances by exactly timeStep seconds per frame. Otherwise it sees the 
+recorded times. Either way, the same program replaying the same recording runs 
+the same frames, so that timings from two builds can be compared fairly. During 
+replay, pixRun runs as fast as it can, ignoring the on-demand mode, the frame 
+cap, pipelining, and dynamic resolution. It returns when the recording ends. 
+Call this function after pixInitialize. Returns an error code (0 on success). 
+*/
+int pixStartReplay(const char *path, double timeStep);
+
+/* Returns the number of time steps recorded or replayed since pixInitialize, 
+pixStartRecording, or pixStartReplay. */
+int pixGetFrameIndex(void);
+
+/* Returns the width of the pixels. This is the window's width, unless the 
+resolution has been scaled down by pixSetResolutionScale or 
+pixSetTargetFrameTime. All of the functions that take pixel coordinates, such 
+as pixSetRGB, work in this width and pixGetHeight. (The mouse callbacks still 
+report window coordinates.) */
+int pixGetWidth(void);
+
+/* Returns the height of the pixels. See pixGetWidth. */
+int pixGetHeight(void);
+
+/* Renders at a lower resolution, which the graphics card stretches to fill the 
+window, with bilinear filtering. scale is clamped to [0.25, 1]. The width and 
+height become the window's width and height times scale, rounded to a multiple 
+of 8, so they need not be powers of 2. If they change, the pixels are cleared 
+to black and the resize callback is invoked. */
+void pixSetResolutionScale(double scale);
+
+/* Returns the current width of the pixels divided by the window's width. */
+double pixGetResolutionScale(void);
+
+/* Turns on dynamic resolution. Between frames, pixRun measures how long the 
+time step callback took, and scales the resolution (as pixSetResolutionScale 
+does) to bring that time to about seconds. Because the callback does less work 
+at lower resolution, the frame rate holds steady as the scene gets harder to 
+render, at the cost of sharpness. A seconds of 0.0 turns the control off, 
+leaving the scale where it is. */
+void pixSetTargetFrameTime(double seconds);
+
+/* Returns the target set by pixSetTargetFrameTime, or 0.0 if there is none. */
+double pixGetTargetFrameTime(void);
+
 /* Returns the red channel of the pixel at coordinates (x, y). Coordinates are 
 relative to the lower left corner of the window. */
 double pixGetR(int x, int y);
@@ -60,6 +176,14 @@ void pixSetRGB(int x, int y, double red, double green, double blue);
 /* Sets all pixels to the given RGB color. */
 void pixClearRGB(double red, double green, double blue);
 
+/* Returns the number of pixels that the most recent screen update sent to the 
+graphics card. The pixel system tracks which pixels have been set since the 
+previous update, and sends only the rectangles around them, unless those 
+rectangles are numerous or large enough that sending the whole window is 
+cheaper. So a program that redraws only a small part of the window, such as a 
+moving sprite over a static background, sends only that part. */
+int pixGetUploadedNum(void);
+
 /* data must be an array of width * height * 3 doubles, so that it can hold RGB 
 for each pixel in the window. This function copies the current window contents 
 out to the data array. Pixel (i, j) (measured from the lower left) ends up at 
@@ -71,6 +195,64 @@ into the window. */
 void pixPasteRGB(double *data);
 
 
+/* Sets width pixels of row y, starting at x and moving right, to the colors in 
+rgb, which holds 3 * width doubles. Pixels outside the window are skipped. This 
+is much faster than setting the pixels one at a time with pixSetRGB. */
+void pixSetSpanRGB(int x, int y, int width, const double rgb[]);
+
+/* Sets the pixels in the rectangle with lower left corner (x, y) and the given 
+width and height to the given RGB color. The parts of the rectangle outside the 
+window are skipped. */
+void pixFillRect(int x, int y, int width, int height, double red, double green, 
+        double blue);
+
+/* Returns the number of bytes that pixCopyPixels and pixPastePixels use. */
+int pixGetPixelsSize(void);
+
+/* Copies the window's pixels, in the pixel system's own format, to data, which 
+must hold pixGetPixelsSize() bytes. This is a single memcpy, so it is the 
+fastest way to save the window, for example to restore a static background 
+later with pixPastePixels. */
+void pixCopyPixels(void *data);
+
+/* Inverse of pixCopyPixels. data must have been filled by pixCopyPixels, in 
+the same format and window size. */
+void pixPastePixels(const void *data);
+
+
+
+/*** Direct access ***/
+
+/* A view of the window's pixels, as filled in by pixLockView. In pixRGBFLOAT 
+format, floats is non-NULL and bytes is NULL; in pixRGBA8 format, it's the 
+other way around. Pixel (x, y) (measured from the lower left) starts at 
+channel x * channelNum + y * stride, and its channels are red, green, blue, and 
+in pixRGBA8 format alpha, which should be 255. So a rasterizer or post-effect 
+can walk a row with a pointer instead of calling pixSetRGB for each pixel. Bytes 
+hold colors times 255, and unlike pixSetRGB the view does not clamp. */
+typedef struct pixView pixView;
+struct pixView {
+    int format;                 /* pixRGBFLOAT or pixRGBA8 */
+    int width, height;
+    int channelNum;             /* 3 or 4 */
+    int stride;                 /* channels from one row to the next */
+    float *floats;
+    unsigned char *bytes;
+};
+
+/* Gives direct access to the window's pixels, by filling in view. Until 
+pixUnlockView is called, the caller may read and write the pixels through view, 
+and pixRun holds off updating the screen. Returns an error code, which is 
+nonzero if the view is already locked. */
+int pixLockView(pixView *view);
+
+/* Ends direct access. The rectangle with lower left corner (x, y) and the 
+given width and height must include every pixel written through the view, so 
+that the screen update sends it. Pass a width or height of 0 if nothing was 
+written. */
+void pixUnlockView(int x, int y, int width, int height);
+
+
 
 /*** Callbacks ***/
 
@@ -139,3 +321,13 @@ current frame. Both times are in seconds since the epoch (something like 1970).
 */
 void pixSetTimeStepHandler(void (*handler)(double, double));
 
+/* Sets a callback function that fires whenever the width and height of the 
+pixels change, because of pixSetResolutionScale or pixSetTargetFrameTime. 
+Invoked using something like 
+    pixSetResizeHandler(myResizeHandler);
+where myResizeHandler is defined something like
+    void myResizeHandler(int width, int height);
+A program that renders at a lower resolution should use it to resize its depth 
+buffer, viewport, and so on. It is invoked between frames. */
+void pixSetResizeHandler(void (*handler)(int, int));
+
@@ -0,0 +1,88 @@
+/*
+    350kernel.c
+    A registry of specialized rasterizer-plus-shader kernels. Each kernel is a copy of triRender that
+    was stamped out by 350specialize.c for one particular shadeFragment, with unifDim, texNum, and
+    varyDim fixed at compile time. Because the kernel calls its shadeFragment directly, rather than
+    through sha->shadeFragment, the compiler can inline the shader into setPixel and keep the
+    varyings in fixed-size arrays. meshRender asks the registry for a kernel matching its shaShading
+    and falls back to the generic triRender when there isn't one.
+    Include this file after the triangle file and before 350specialize.c and the mesh file.
+    Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+/* The pipeline statistics hooks used by 350specialize.c. If 353stats.c wasn't
+included first, then they compile to nothing. */
+#ifndef STATADD
+#define STATADD(member, n)
+#define STATSTART(start)
+#define STATSTOP(member, start)
+#endif
+
+/* Helpers for building kernel function names out of KERNELNAME. For example,
+if KERNELNAME is land, then kerName(Render) is landRender. */
+#define kerPaste(a, b) a##b
+#define kerPasteExpanded(a, b) kerPaste(a, b)
+#define kerName(suffix) kerPasteExpanded(KERNELNAME, suffix)
+
+/* The maximum number of kernels that can be registered at once. */
+#define kerMAXNUM 16
+
+/* Feel free to read from this struct's members, but don't write to them except
+through kerRegister. */
+typedef struct kerKernel kerKernel;
+struct kerKernel {
+    void (*shadeFragment)(int, const double[], int, const texTexture *[], int, const double[], double[4]);
+    int unifDim, texNum, varyDim;
+    void (*render)(
+        const shaShading *, depthBuffer *, const double[], const texTexture *[],
+        const double[], const double[], const double[]);
+};
+
+kerKernel kerKernels[kerMAXNUM];
+int kerNum = 0;
+int kerEnabled = 1;
+
+/* Registers a specialized kernel. Usually you don't call this function
+directly. Instead you call the register function that 350specialize.c stamps
+out, for example landRegister(). Returns an error code (0 on success). */
+int kerRegister(
+        void (*shadeFragment)(int, const double[], int, const texTexture *[], int, const double[], double[4]),
+        int unifDim, int texNum, int varyDim,
+        void (*render)(
+            const shaShading *, depthBuffer *, const double[], const texTexture *[],
+            const double[], const double[], const double[])) {
+    if (kerNum >= kerMAXNUM) {
+        fprintf(stderr, "error: kerRegister: too many kernels\n");
+        return 1;
+    }
+    kerKernels[kerNum].shadeFragment = shadeFragment;
+    kerKernels[kerNum].unifDim = unifDim;
+    kerKernels[kerNum].texNum = texNum;
+    kerKernels[kerNum].varyDim = varyDim;
+    kerKernels[kerNum].render = render;
+    kerNum += 1;
+    return 0;
+}
+
+/* Turns the specialized kernels on (1) or off (0). When they're off,
+kerGetRenderer always returns the generic triRender. Useful for benchmarking. */
+void kerSetEnabled(int enabled) {
+    kerEnabled = enabled;
+}
+
+/* Returns the triangle renderer to use with the given shading. That's a
+registered kernel, if one matches the shading's shadeFragment and all three of
+its dimensions. Otherwise it's the generic triRender. Cheap enough to call once
+per meshRender, but not once per triangle. */
+void (*kerGetRenderer(const shaShading *sha))(
+        const shaShading *, depthBuffer *, const double[], const texTexture *[],
+        const double[], const double[], const double[]) {
+    if (kerEnabled)
+        for (int i = 0; i < kerNum; i += 1)
+            if (kerKernels[i].shadeFragment == sha->shadeFragment &&
+                    kerKernels[i].unifDim == sha->unifDim &&
+                    kerKernels[i].texNum == sha->texNum &&
+                    kerKernels[i].varyDim == sha->varyDim)
+                return kerKernels[i].render;
+    return triRender;
+}
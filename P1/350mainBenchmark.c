@@ -0,0 +1,379 @@
+/*
+	350mainBenchmark.c
+	Times the generic triRender path against the specialized kernels of 350kernel.c and
+	350specialize.c. There are two scenes. The first is the landscape of 340mainLandscape.c, with
+	its shaders unchanged. The second is the three textured sprites of 240mainShadings.c, with
+	their shaders ported to the 3D pipeline (Z = 0, W = 1, and an identity viewport) and the
+	sprites enlarged so that the fragment work is measurable. (carrot.png, jondich.jpeg, and
+	jdavis.jpg don't load in this directory, so awesome.png and jondich.jpg stand in for them.)
+	Each scene is rendered the same number of times along each path, and the two resulting images
+	are compared pixel by pixel.
+	Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+
+/* On macOS, compile with...
+    clang -O3 350mainBenchmark.c 040pixel.o -lglfw -framework OpenGL -framework Cocoa -framework IOKit
+On Ubuntu, compile with...
+    cc -O3 350mainBenchmark.c 040pixel.o -lglfw -lGL -lm -ldl
+*/
+
+#define WINDOWWIDTH 512.0
+#define WINDOWHEIGHT 512.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <GLFW/glfw3.h>
+#include <sys/time.h>
+
+#include "040pixel.h"
+
+#include "250vector.c"
+#include "280matrix.c"
+#include "150texture.c"
+#include "260shading.c"
+#include "260depth.c"
+#include "270triangle.c"
+#include "350kernel.c"
+#include "350mesh.c"
+#include "190mesh2D.c"
+#include "250mesh3D.c"
+#include "300isometry.c"
+#include "300camera.c"
+#include "340landscape.c"
+
+#define LANDSIZE 40
+#define FRAMENUM 100
+#define WARMUPNUM 5
+
+/* Landscape scene, as in 340mainLandscape.c. */
+#define ATTRX 0
+#define ATTRY 1
+#define ATTRZ 2
+#define ATTRS 3
+#define ATTRT 4
+#define ATTRN 5
+#define ATTRO 6
+#define ATTRP 7
+#define VARYX 0
+#define VARYY 1
+#define VARYZ 2
+#define VARYW 3
+#define VARYS 4
+#define VARYT 5
+#define VARYN 6
+#define VARYO 7
+#define VARYP 8
+#define UNIFMODELING 0
+#define UNIFPROJINVISOM 16
+
+void shadeVertexLand(
+        int unifDim, const double unif[], int attrDim, const double attr[],
+        int varyDim, double vary[]) {
+	double attrHomog[4] = {attr[ATTRX], attr[ATTRY], attr[ATTRZ], 1.0};
+	double modHomog[4];
+	mat441Multiply((double(*)[4])(&unif[UNIFMODELING]), attrHomog, modHomog);
+	mat441Multiply((double(*)[4])(&unif[UNIFPROJINVISOM]), modHomog, vary);
+	vecCopy(5, &attr[ATTRS], &vary[VARYS]);
+}
+
+void shadeFragmentLand(
+        int unifDim, const double unif[], int texNum, const texTexture *tex[],
+        int varyDim, const double vary[], double rgbd[4]) {
+	double sample[tex[0]->texelDim];
+	texSample(tex[0], vary[VARYS], vary[VARYT], sample);
+	sample[0] = sample[1] * 0.2 + 0.8;
+	sample[1] = sample[1] * 0.2 + 0.6;
+	sample[2] = 0.3;
+	double intensity = vary[VARYP] / vecLength(3, &vary[VARYN]);
+	vecScale(3, intensity, sample, rgbd);
+	rgbd[3] = vary[VARYZ];
+}
+
+/* Sprite scene, as in 240mainShadings.c. The attributes are X, Y, S, T. */
+#define SPRITEATTRX 0
+#define SPRITEATTRY 1
+#define SPRITEATTRS 2
+#define SPRITEATTRT 3
+#define SPRITEUNIFR 0
+#define SPRITEUNIFG 1
+#define SPRITEUNIFB 2
+#define SPRITEUNIFMODELING 3
+
+void shadeVertexSprite(
+        int unifDim, const double unif[], int attrDim, const double attr[],
+        int varyDim, double vary[]) {
+    double attrHomog[3] = {attr[SPRITEATTRX], attr[SPRITEATTRY], 1.0};
+    double varyHomog[3];
+    mat331Multiply((double(*)[3])(&unif[SPRITEUNIFMODELING]), attrHomog, varyHomog);
+    vec4Set(varyHomog[0], varyHomog[1], 0.0, 1.0, vary);
+    vary[VARYS] = attr[SPRITEATTRS];
+    vary[VARYT] = attr[SPRITEATTRT];
+}
+
+void shadeFragmentSprite(
+        int unifDim, const double unif[], int texNum, const texTexture *tex[],
+        int varyDim, const double vary[], double rgbd[4]) {
+    double sample[tex[0]->texelDim];
+    texSample(tex[0], vary[VARYS], vary[VARYT], sample);
+    vecModulate(3, sample, &unif[SPRITEUNIFR], rgbd);
+    rgbd[3] = vary[VARYZ];
+}
+
+/* Stamp out one specialized kernel per fragment shader. */
+#define KERNELNAME land
+#define KERNELUNIFDIM (16 + 16)
+#define KERNELTEXNUM 1
+#define KERNELVARYDIM (4 + 2 + 3)
+#define KERNELSHADEFRAGMENT shadeFragmentLand
+#include "350specialize.c"
+
+#define KERNELNAME sprite
+#define KERNELUNIFDIM (3 + 9)
+#define KERNELTEXNUM 1
+#define KERNELVARYDIM (4 + 2)
+#define KERNELSHADEFRAGMENT shadeFragmentSprite
+#include "350specialize.c"
+
+depthBuffer buf;
+shaShading shaLand, shaSprite;
+texTexture texLand, texCarrot, texJondich, texJdavis;
+const texTexture *texturesLand[1] = {&texLand};
+const texTexture *texturesCarrot[1] = {&texCarrot};
+const texTexture *texturesJondich[1] = {&texJondich};
+const texTexture *texturesJdavis[1] = {&texJdavis};
+meshMesh meshLand, meshCarrot, meshJondich, meshJdavis;
+double unifLand[16 + 16] = {
+	1.0, 0.0, 0.0, 0.0,
+	0.0, 1.0, 0.0, 0.0,
+	0.0, 0.0, 1.0, 0.0,
+	0.0, 0.0, 0.0, 1.0};
+double unifCarrot[3 + 9] = {1.0, 1.0, 1.0};
+double unifJondich[3 + 9] = {1.0, 1.0, 1.0};
+double unifJdavis[3 + 9] = {1.0, 1.0, 1.0};
+double viewportLand[4][4];
+double viewportSprite[4][4] = {
+	{1.0, 0.0, 0.0, 0.0},
+	{0.0, 1.0, 0.0, 0.0},
+	{0.0, 0.0, 1.0, 0.0},
+	{0.0, 0.0, 0.0, 1.0}};
+camCamera cam;
+
+/* Returns the current time in seconds. */
+double benchTime(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (double)tv.tv_sec + (double)tv.tv_usec * 0.000001;
+}
+
+/* Renders the landscape. The frame index slowly spins the camera, so that
+every frame differs a little. */
+void renderLand(int frame) {
+	pixClearRGB(0.8, 0.8, 1.0);
+	depthClearDepths(&buf, 1000000000.0);
+	double position[3] = {-5.0, -5.0, 20.0};
+	camLookFrom(&cam, position, M_PI * 0.6, M_PI * 0.25 + frame * 0.001);
+	double projInvIsom[4][4];
+	camGetProjectionInverseIsometry(&cam, projInvIsom);
+	vecCopy(16, (double *)projInvIsom, &unifLand[UNIFPROJINVISOM]);
+	meshRender(&meshLand, &buf, viewportLand, &shaLand, unifLand, texturesLand);
+}
+
+/* Renders the sprites. The carrot spins and the professors change color with
+the frame index, much as they did with time in 240mainShadings.c. */
+void renderSprites(int frame) {
+	pixClearRGB(0.0, 0.0, 0.0);
+	depthClearDepths(&buf, 1000000000.0);
+	double isom[3][3];
+	double translationCarrot[2] = {256.0, 256.0};
+	mat33Isometry(frame * 0.1, translationCarrot, isom);
+	vecCopy(9, (double *)isom, &unifCarrot[SPRITEUNIFMODELING]);
+	double translationJondich[2] = {0.0, 0.0};
+	unifJondich[SPRITEUNIFR] = 0.5 + 0.5 * sin(frame * 0.1);
+	mat33Isometry(0.0, translationJondich, isom);
+	vecCopy(9, (double *)isom, &unifJondich[SPRITEUNIFMODELING]);
+	double translationJdavis[2] = {0.0, 0.0};
+	unifJdavis[SPRITEUNIFG] = 0.5 + 0.5 * cos(frame * 0.1);
+	mat33Isometry(0.0, translationJdavis, isom);
+	vecCopy(9, (double *)isom, &unifJdavis[SPRITEUNIFMODELING]);
+	meshRender(&meshCarrot, &buf, viewportSprite, &shaSprite, unifCarrot, texturesCarrot);
+	meshRender(&meshJondich, &buf, viewportSprite, &shaSprite, unifJondich, texturesJondich);
+	meshRender(&meshJdavis, &buf, viewportSprite, &shaSprite, unifJdavis, texturesJdavis);
+}
+
+/* Renders the scene FRAMENUM times with the kernels enabled or disabled, after
+a few untimed warm-up frames. Returns the mean seconds per frame. Leaves the
+last frame's pixels in image, which must hold width * height * 3 doubles. */
+double benchRun(void (*render)(int), int enabled, double *image) {
+	kerSetEnabled(enabled);
+	for (int i = 0; i < WARMUPNUM; i += 1)
+		render(i);
+	double start = benchTime();
+	for (int i = 0; i < FRAMENUM; i += 1)
+		render(i);
+	double seconds = (benchTime() - start) / FRAMENUM;
+	pixCopyRGB(image);
+	return seconds;
+}
+
+/* Benchmarks one scene along both paths and prints the comparison. */
+void benchScene(const char *name, void (*render)(int), double *generic,
+		double *specialized) {
+	double genericTime = benchRun(render, 0, generic);
+	double specializedTime = benchRun(render, 1, specialized);
+	int differing = 0;
+	for (int i = 0; i < WINDOWWIDTH * WINDOWHEIGHT * 3; i += 1)
+		if (generic[i] != specialized[i])
+			differing += 1;
+	printf("%s: generic %f ms/frame, specialized %f ms/frame, speedup %fx, ",
+		name, genericTime * 1000.0, specializedTime * 1000.0,
+		genericTime / specializedTime);
+	printf("%d differing channels\n", differing);
+}
+
+int initializeTextures(void) {
+	if (texInitializeFile(&texLand, "awesome.png") != 0)
+		return 4;
+	if (texInitializeFile(&texCarrot, "awesome.png") != 0) {
+		texFinalize(&texLand);
+		return 3;
+	}
+	if (texInitializeFile(&texJondich, "jondich.jpg") != 0) {
+		texFinalize(&texCarrot);
+		texFinalize(&texLand);
+		return 2;
+	}
+	if (texInitializeFile(&texJdavis, "jondich.jpg") != 0) {
+		texFinalize(&texJondich);
+		texFinalize(&texCarrot);
+		texFinalize(&texLand);
+		return 1;
+	}
+	texSetFiltering(&texLand, texNEAREST);
+	texSetLeftRight(&texLand, texREPEAT);
+	texSetTopBottom(&texLand, texREPEAT);
+	texSetFiltering(&texCarrot, texLINEAR);
+	texSetLeftRight(&texCarrot, texREPEAT);
+	texSetTopBottom(&texCarrot, texREPEAT);
+	texSetFiltering(&texJondich, texLINEAR);
+	texSetLeftRight(&texJondich, texREPEAT);
+	texSetTopBottom(&texJondich, texREPEAT);
+	texSetFiltering(&texJdavis, texLINEAR);
+	texSetLeftRight(&texJdavis, texREPEAT);
+	texSetTopBottom(&texJdavis, texREPEAT);
+	return 0;
+}
+
+void finalizeTextures(void) {
+	texFinalize(&texJdavis);
+	texFinalize(&texJondich);
+	texFinalize(&texCarrot);
+	texFinalize(&texLand);
+}
+
+int initializeMeshes(void) {
+	/* A fixed seed, so that every run benchmarks the same landscape. */
+	double landData[LANDSIZE * LANDSIZE];
+	landFlat(LANDSIZE, landData, 0.0);
+	srand(311);
+	for (int i = 0; i < 12; i += 1)
+		landFaultRandomly(LANDSIZE, landData, 1.0 - i * 0.04);
+	for (int i = 0; i < 4; i += 1)
+		landBlur(LANDSIZE, landData);
+	for (int i = 0; i < 4; i += 1)
+		landBump(LANDSIZE, landData, landInt(0, LANDSIZE - 1),
+			landInt(0, LANDSIZE - 1), 5.0, 1.0);
+	if (mesh3DInitializeLandscape(&meshLand, LANDSIZE, 1.0, landData) != 0)
+		return 4;
+	for (int i = 0; i < meshLand.vertNum; i += 1) {
+		double *vertPtr = meshGetVertexPointer(&meshLand, i);
+		vertPtr[ATTRS] = 0.0;
+		vertPtr[ATTRT] = vertPtr[ATTRZ];
+	}
+	if (mesh2DInitializeRectangle(&meshCarrot, -96.0, 96.0, -96.0, 96.0) != 0) {
+		meshFinalize(&meshLand);
+		return 3;
+	}
+	if (mesh2DInitializeRectangle(&meshJondich, 0.0, 128.0, 0.0, 128.0) != 0) {
+		meshFinalize(&meshCarrot);
+		meshFinalize(&meshLand);
+		return 2;
+	}
+	if (mesh2DInitializeRectangle(&meshJdavis, 384.0, 512.0, 384.0, 512.0) != 0) {
+		meshFinalize(&meshJondich);
+		meshFinalize(&meshCarrot);
+		meshFinalize(&meshLand);
+		return 1;
+	}
+	return 0;
+}
+
+void finalizeMeshes(void) {
+	meshFinalize(&meshJdavis);
+	meshFinalize(&meshJondich);
+	meshFinalize(&meshCarrot);
+	meshFinalize(&meshLand);
+}
+
+int main(void) {
+	if (pixInitialize(WINDOWWIDTH, WINDOWHEIGHT, "Benchmark") != 0)
+		return 1;
+	if (depthInitialize(&buf, WINDOWWIDTH, WINDOWHEIGHT) != 0) {
+		pixFinalize();
+		return 2;
+	}
+	if (initializeTextures() != 0) {
+		depthFinalize(&buf);
+		pixFinalize();
+		return 3;
+	}
+	if (initializeMeshes() != 0) {
+		finalizeTextures();
+		depthFinalize(&buf);
+		pixFinalize();
+		return 4;
+	}
+	double *generic = malloc(WINDOWWIDTH * WINDOWHEIGHT * 3 * sizeof(double));
+	double *specialized = malloc(WINDOWWIDTH * WINDOWHEIGHT * 3 * sizeof(double));
+	if (generic == NULL || specialized == NULL) {
+		fprintf(stderr, "error: main: malloc failed\n");
+		free(generic);
+		free(specialized);
+		finalizeMeshes();
+		finalizeTextures();
+		depthFinalize(&buf);
+		pixFinalize();
+		return 5;
+	}
+	/* Configure shader programs and register their kernels. */
+	shaLand.unifDim = 16 + 16;
+	shaLand.attrDim = 3 + 2 + 3;
+	shaLand.varyDim = 4 + 2 + 3;
+	shaLand.shadeVertex = shadeVertexLand;
+	shaLand.shadeFragment = shadeFragmentLand;
+	shaLand.texNum = 1;
+	shaSprite.unifDim = 3 + 9;
+	shaSprite.attrDim = 2 + 2;
+	shaSprite.varyDim = 4 + 2;
+	shaSprite.shadeVertex = shadeVertexSprite;
+	shaSprite.shadeFragment = shadeFragmentSprite;
+	shaSprite.texNum = 1;
+	landRegister();
+	spriteRegister();
+	/* Configure viewport and camera. */
+	mat44Viewport(WINDOWWIDTH, WINDOWHEIGHT, viewportLand);
+	camSetProjectionType(&cam, camPERSPECTIVE);
+	camSetFrustum(&cam, M_PI / 6.0, 10.0, 10.0, WINDOWWIDTH, WINDOWHEIGHT);
+	/* Run the benchmarks. */
+	benchScene("landscape (340)", renderLand, generic, specialized);
+	benchScene("sprites (240)", renderSprites, generic, specialized);
+	/* Clean up. */
+	free(specialized);
+	free(generic);
+	finalizeMeshes();
+	finalizeTextures();
+	depthFinalize(&buf);
+	pixFinalize();
+	return 0;
+}
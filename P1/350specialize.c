@@ -0,0 +1,185 @@
+/*
+    350specialize.c
+    A template that stamps out one specialized rasterizer-plus-shader kernel (see 350kernel.c). It
+    is a copy of 270triangle.c, except that the shader and its dimensions are fixed at compile time.
+    To use it, define these five macros and then include this file, once per shader:
+        #define KERNELNAME land
+        #define KERNELUNIFDIM (16 + 16)
+        #define KERNELTEXNUM 1
+        #define KERNELVARYDIM (4 + 2 + 3)
+        #define KERNELSHADEFRAGMENT shadeFragment
+        #include "350specialize.c"
+    That defines landRender, which has the same signature as triRender, and landRegister, which adds
+    landRender to the registry. The shadeFragment must be defined above the include. This file
+    undefines the five macros at the end, so that it can be included again for another shader.
+    The kernels feed the pipeline statistics of 353stats.c, if it is included before 350kernel.c.
+    Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+/* Same as setPixel in 270triangle.c, but the varyings are fixed-size arrays and
+the shader is called directly. */
+void kerName(SetPixel)(
+    depthBuffer *buf, const double unif[], const texTexture *tex[], const double x[2],
+    const double a[], const double invertedItpCoeffs[2][2],
+    const double bMinusA[], const double cMinusA[]) {
+    STATADD(fragNum, 1);
+    // checks if fragment is outside window. if it is, don't render it.
+    if (x[0] < 0 || x[0] > WINDOWWIDTH || x[1] < 0 || x[1] > WINDOWHEIGHT) {
+        STATADD(clippedNum, 1);
+        return;
+    }
+    STATSTART(fragmentStart);
+    double xMinusA[2];
+    double pq[2];
+    double chi[KERNELVARYDIM]; // interpolated varyings vector for x
+    double rgbd[4]; // rgbd for shadeFragment
+
+    // computes p and q.
+    vecSubtract(2, x, a, xMinusA);
+    mat221Multiply(invertedItpCoeffs, xMinusA, pq);
+
+    // linearly interpolates the varyings at current pixel. the parentheses keep the rounding
+    // identical to the generic a + (p(b - a) + q(c - a)).
+    for (int k = 0; k < KERNELVARYDIM; k += 1)
+        chi[k] = a[k] + (pq[0] * bMinusA[k] + pq[1] * cMinusA[k]);
+
+    vec3Set(1.0, 1.0, 1.0, rgbd);
+    KERNELSHADEFRAGMENT(KERNELUNIFDIM, unif, KERNELTEXNUM, tex, KERNELVARYDIM, chi, rgbd);
+    STATADD(shadedNum, 1);
+
+    double currDepth = depthGetDepth(buf, x[0], x[1]);
+    if (currDepth > rgbd[3]) {
+        depthSetDepth(buf, x[0], x[1], rgbd[3]);
+        pixSetRGB((int)x[0], (int)x[1], rgbd[0], rgbd[1], rgbd[2]);
+        STATADD(writtenNum, 1);
+    } else
+        STATADD(rejectedNum, 1);
+    STATSTOP(fragmentTime, fragmentStart);
+}
+
+/* Same as triRenderHelper in 270triangle.c, but calls the specialized
+setPixel. */
+void kerName(RenderHelper)(
+        depthBuffer *buf, const double unif[], const texTexture *tex[],
+        const double a[], const double b[], const double c[]) {
+    STATSTART(setupStart);
+    double x[2];
+    x[0] = ceil(a[0]);
+
+    double interpolateCoeffs[2][2];
+    double invertedItpCoeffs[2][2];
+    createA(a, b, c, interpolateCoeffs);
+    // backface culling, exactly as in the generic path.
+    if (mat22Invert(interpolateCoeffs, invertedItpCoeffs) <= 0) {
+        STATADD(culledNum, 1);
+        STATSTOP(setupTime, setupStart);
+        return;
+    }
+
+    double bMinusA[KERNELVARYDIM];
+    double cMinusA[KERNELVARYDIM];
+    for (int k = 0; k < KERNELVARYDIM; k += 1) {
+        bMinusA[k] = b[k] - a[k];
+        cMinusA[k] = c[k] - a[k];
+    }
+    STATSTOP(setupTime, setupStart);
+    STATSTART(rasterStart);
+
+    // the five cases below mirror those of 270triangle.c. see there for details.
+    if (a[0] == c[0]) {
+        while (x[0] <= floor(b[0])){
+            x[1] = ceil(a[1] + (b[1]-a[1])/(b[0]-a[0])*(x[0]-a[0]));
+            while (x[1] <= floor(c[1] + (b[1]-c[1])/(b[0]-c[0])*(x[0]-c[0]))) {
+                kerName(SetPixel)(buf, unif, tex, x, a, invertedItpCoeffs, bMinusA, cMinusA);
+                x[1] = x[1] + 1;
+            }
+            x[0] = x[0] + 1;
+        }
+    }
+    else if (a[0] == b[0]) {
+        while (x[0] <= floor(c[0])){
+            x[1] = ceil(b[1] + (c[1]-b[1])/(c[0]-b[0])*(x[0]-b[0]));
+            while (x[1] <= floor(a[1] + (c[1]-a[1])/(c[0]-a[0])*(x[0]-a[0]))) {
+                kerName(SetPixel)(buf, unif, tex, x, a, invertedItpCoeffs, bMinusA, cMinusA);
+                x[1] = x[1] + 1;
+            }
+            x[0] = x[0] + 1;
+        }
+    }
+    else if (b[0] == c[0]) {
+        while (x[0] <= floor(c[0])){
+            x[1] = ceil(a[1] + (b[1]-a[1])/(b[0]-a[0])*(x[0]-a[0]));
+            while (x[1] <= floor(a[1] + (c[1]-a[1])/(c[0]-a[0])*(x[0]-a[0]))) {
+                kerName(SetPixel)(buf, unif, tex, x, a, invertedItpCoeffs, bMinusA, cMinusA);
+                x[1] = x[1] + 1;
+            }
+            x[0] = x[0] + 1;
+        }
+    }
+    else if (b[0] < c[0]) {
+        while (x[0] <= floor(b[0])){
+            x[1] = ceil(a[1] + (a[1]-b[1])/(a[0]-b[0])*(x[0]-a[0]));
+            while (x[1] <= floor(a[1] + (c[1]-a[1])/(c[0]-a[0])*(x[0]-a[0]))) {
+                kerName(SetPixel)(buf, unif, tex, x, a, invertedItpCoeffs, bMinusA, cMinusA);
+                x[1] = x[1] + 1;
+            }
+            x[0] = x[0] + 1;
+        }
+        while (x[0] <= floor(c[0])){
+            x[1] = ceil(c[1] + (c[1]-b[1])/(c[0]-b[0])*(x[0]-c[0]));
+            while (x[1] <= floor(a[1] + (c[1]-a[1])/(c[0]-a[0])*(x[0]-a[0]))) {
+                kerName(SetPixel)(buf, unif, tex, x, a, invertedItpCoeffs, bMinusA, cMinusA);
+                x[1] = x[1] + 1;
+            }
+            x[0] = x[0] + 1;
+        }
+    }
+    else {
+        while (x[0] <= floor(c[0])){
+            x[1] = ceil(a[1] + (b[1]-a[1])/(b[0]-a[0])*(x[0]-a[0]));
+            while (x[1] <= floor(a[1] + (c[1]-a[1])/(c[0]-a[0])*(x[0]-a[0]))) {
+                kerName(SetPixel)(buf, unif, tex, x, a, invertedItpCoeffs, bMinusA, cMinusA);
+                x[1] = x[1] + 1;
+            }
+            x[0] = x[0] + 1;
+        }
+        while (x[0] <= floor(b[0])){
+            x[1] = ceil(a[1] + (b[1]-a[1])/(b[0]-a[0])*(x[0]-a[0]));
+            while (x[1] <= floor(b[1] + (c[1]-b[1])/(c[0]-b[0])*(x[0]-b[0]))) {
+                kerName(SetPixel)(buf, unif, tex, x, a, invertedItpCoeffs, bMinusA, cMinusA);
+                x[1] = x[1] + 1;
+            }
+            x[0] = x[0] + 1;
+        }
+    }
+    STATSTOP(rasterTime, rasterStart);
+}
+
+/* Same signature as triRender, so that the registry can hand it to meshRender
+in place of triRender. The sha argument is ignored, because everything it would
+tell us is already baked in. */
+void kerName(Render)(
+        const shaShading *sha, depthBuffer *buf, const double unif[], const texTexture *tex[],
+        const double a[], const double b[], const double c[]) {
+    STATADD(triNum, 1);
+    if (a[0] <= b[0] && a[0] <= c[0])
+        kerName(RenderHelper)(buf, unif, tex, a, b, c);
+    else if(b[0] <= a[0] && b[0] <= c[0])
+        kerName(RenderHelper)(buf, unif, tex, b, c, a);
+    else
+        kerName(RenderHelper)(buf, unif, tex, c, a, b);
+}
+
+/* Adds this kernel to the registry in 350kernel.c. Returns an error code (0 on
+success). */
+int kerName(Register)(void) {
+    return kerRegister(
+        KERNELSHADEFRAGMENT, KERNELUNIFDIM, KERNELTEXNUM, KERNELVARYDIM,
+        kerName(Render));
+}
+
+#undef KERNELNAME
+#undef KERNELUNIFDIM
+#undef KERNELTEXNUM
+#undef KERNELVARYDIM
+#undef KERNELSHADEFRAGMENT
@@ -0,0 +1,370 @@
+/*
+	351mainBenchmark.c
+	Times batched vertex shading (351shading.c, 351mesh.c) on the landscape of 340mainLandscape.c.
+	The landscape's vertex shader gets a batched version, shadeVerticesLand, that multiplies the
+	projection-inverse-isometry by the modeling matrix once per batch and then transforms four
+	vertices at a time with AVX2. First the vertex stage is timed on its own, on a large
+	landscape, against the per-vertex shader driven by the default adapter. Then whole frames are
+	timed both ways, in alternating rounds, on the small landscape up close and on the large one
+	from far away. Batching speeds up only the vertex stage, so it pays off only when that stage is
+	a large share of the frame. Up close, it is a tiny share. From far away, the large landscape
+	covers few pixels per triangle, but clearing the window and setting up each triangle still
+	cost about ten times what the vertex stage does, so the gain is within the noise there too.
+	Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+
+/* On macOS (Intel), compile with...
+    clang -O3 -mavx2 351mainBenchmark.c 040pixel.o -lglfw -framework OpenGL -framework Cocoa -framework IOKit
+On Ubuntu, compile with...
+    cc -O3 -mavx2 351mainBenchmark.c 040pixel.o -lglfw -lGL -lm -ldl
+Without -mavx2 (for example on Apple silicon), shadeVerticesLand falls back to a
+scalar loop, which still benefits from multiplying the two matrices once per batch.
+*/
+
+#define WINDOWWIDTH 512.0
+#define WINDOWHEIGHT 512.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <GLFW/glfw3.h>
+#include <sys/time.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "040pixel.h"
+
+#include "250vector.c"
+#include "280matrix.c"
+#include "150texture.c"
+#include "351shading.c"
+#include "260depth.c"
+#include "270triangle.c"
+#include "350kernel.c"
+#include "351mesh.c"
+#include "250mesh3D.c"
+#include "300isometry.c"
+#include "300camera.c"
+#include "340landscape.c"
+
+#define LANDSIZE 40
+#define BIGLANDSIZE 200
+#define FRAMENUM 20
+#define ROUNDNUM 9
+#define FARDISTANCE 3200.0
+#define VERTEXREPNUM 100
+
+#define ATTRX 0
+#define ATTRY 1
+#define ATTRZ 2
+#define ATTRS 3
+#define ATTRT 4
+#define ATTRN 5
+#define ATTRO 6
+#define ATTRP 7
+#define VARYX 0
+#define VARYY 1
+#define VARYZ 2
+#define VARYW 3
+#define VARYS 4
+#define VARYT 5
+#define VARYN 6
+#define VARYO 7
+#define VARYP 8
+#define UNIFMODELING 0
+#define UNIFPROJINVISOM 16
+
+/* The per-vertex shader, exactly as in 340mainLandscape.c. */
+void shadeVertexLand(
+        int unifDim, const double unif[], int attrDim, const double attr[],
+        int varyDim, double vary[]) {
+	double attrHomog[4] = {attr[ATTRX], attr[ATTRY], attr[ATTRZ], 1.0};
+	double modHomog[4];
+	mat441Multiply((double(*)[4])(&unif[UNIFMODELING]), attrHomog, modHomog);
+	mat441Multiply((double(*)[4])(&unif[UNIFPROJINVISOM]), modHomog, vary);
+	vecCopy(5, &attr[ATTRS], &vary[VARYS]);
+}
+
+/* The batched shader. Computes the same varyings as shadeVertexLand, up to
+rounding, because the two matrices are multiplied together before the vertices
+are transformed rather than after. */
+void shadeVerticesLand(
+        int unifDim, const double unif[], int vertNum, int attrDim,
+        const double attr[], int varyDim, double vary[]) {
+	double m[4][4];
+	mat444Multiply((double(*)[4])(&unif[UNIFPROJINVISOM]),
+		(double(*)[4])(&unif[UNIFMODELING]), m);
+	int i = 0;
+#ifdef __AVX2__
+	/* Four vertices per iteration. Gather their X, Y, Z into three registers,
+	so that lane j belongs to vertex i + j. Then each row of m, broadcast across
+	the lanes, produces one output coordinate for all four vertices. */
+	__m256i offsets = _mm256_set_epi64x(3 * attrDim, 2 * attrDim, attrDim, 0);
+	__m256d m00 = _mm256_set1_pd(m[0][0]), m01 = _mm256_set1_pd(m[0][1]);
+	__m256d m02 = _mm256_set1_pd(m[0][2]), m03 = _mm256_set1_pd(m[0][3]);
+	__m256d m10 = _mm256_set1_pd(m[1][0]), m11 = _mm256_set1_pd(m[1][1]);
+	__m256d m12 = _mm256_set1_pd(m[1][2]), m13 = _mm256_set1_pd(m[1][3]);
+	__m256d m20 = _mm256_set1_pd(m[2][0]), m21 = _mm256_set1_pd(m[2][1]);
+	__m256d m22 = _mm256_set1_pd(m[2][2]), m23 = _mm256_set1_pd(m[2][3]);
+	__m256d m30 = _mm256_set1_pd(m[3][0]), m31 = _mm256_set1_pd(m[3][1]);
+	__m256d m32 = _mm256_set1_pd(m[3][2]), m33 = _mm256_set1_pd(m[3][3]);
+	for (; i + 4 <= vertNum; i += 4) {
+		const double *a = &attr[i * attrDim];
+		__m256d x = _mm256_i64gather_pd(&a[ATTRX], offsets, 8);
+		__m256d y = _mm256_i64gather_pd(&a[ATTRY], offsets, 8);
+		__m256d z = _mm256_i64gather_pd(&a[ATTRZ], offsets, 8);
+		__m256d r0 = _mm256_add_pd(
+			_mm256_add_pd(_mm256_mul_pd(m00, x), _mm256_mul_pd(m01, y)),
+			_mm256_add_pd(_mm256_mul_pd(m02, z), m03));
+		__m256d r1 = _mm256_add_pd(
+			_mm256_add_pd(_mm256_mul_pd(m10, x), _mm256_mul_pd(m11, y)),
+			_mm256_add_pd(_mm256_mul_pd(m12, z), m13));
+		__m256d r2 = _mm256_add_pd(
+			_mm256_add_pd(_mm256_mul_pd(m20, x), _mm256_mul_pd(m21, y)),
+			_mm256_add_pd(_mm256_mul_pd(m22, z), m23));
+		__m256d r3 = _mm256_add_pd(
+			_mm256_add_pd(_mm256_mul_pd(m30, x), _mm256_mul_pd(m31, y)),
+			_mm256_add_pd(_mm256_mul_pd(m32, z), m33));
+		/* Transpose, so that each register holds one vertex's X, Y, Z, W. */
+		__m256d t0 = _mm256_unpacklo_pd(r0, r1);
+		__m256d t1 = _mm256_unpackhi_pd(r0, r1);
+		__m256d t2 = _mm256_unpacklo_pd(r2, r3);
+		__m256d t3 = _mm256_unpackhi_pd(r2, r3);
+		double *v = &vary[i * varyDim];
+		_mm256_storeu_pd(&v[0], _mm256_permute2f128_pd(t0, t2, 0x20));
+		_mm256_storeu_pd(&v[varyDim], _mm256_permute2f128_pd(t1, t3, 0x20));
+		_mm256_storeu_pd(&v[2 * varyDim], _mm256_permute2f128_pd(t0, t2, 0x31));
+		_mm256_storeu_pd(&v[3 * varyDim], _mm256_permute2f128_pd(t1, t3, 0x31));
+		for (int j = 0; j < 4; j += 1)
+			vecCopy(5, &a[j * attrDim + ATTRS], &v[j * varyDim + VARYS]);
+	}
+#endif
+	/* The leftover vertices (or all of them, without AVX2). */
+	for (; i < vertNum; i += 1) {
+		const double *a = &attr[i * attrDim];
+		double *v = &vary[i * varyDim];
+		for (int k = 0; k < 4; k += 1)
+			v[k] = (m[k][0] * a[ATTRX] + m[k][1] * a[ATTRY]) +
+				(m[k][2] * a[ATTRZ] + m[k][3]);
+		vecCopy(5, &a[ATTRS], &v[VARYS]);
+	}
+}
+
+void shadeFragmentLand(
+        int unifDim, const double unif[], int texNum, const texTexture *tex[],
+        int varyDim, const double vary[], double rgbd[4]) {
+	double sample[tex[0]->texelDim];
+	texSample(tex[0], vary[VARYS], vary[VARYT], sample);
+	sample[0] = sample[1] * 0.2 + 0.8;
+	sample[1] = sample[1] * 0.2 + 0.6;
+	sample[2] = 0.3;
+	double intensity = vary[VARYP] / vecLength(3, &vary[VARYN]);
+	vecScale(3, intensity, sample, rgbd);
+	rgbd[3] = vary[VARYZ];
+}
+
+#define KERNELNAME land
+#define KERNELUNIFDIM (16 + 16)
+#define KERNELTEXNUM 1
+#define KERNELVARYDIM (4 + 2 + 3)
+#define KERNELSHADEFRAGMENT shadeFragmentLand
+#include "350specialize.c"
+
+depthBuffer buf;
+shaShading sha;
+texTexture texture;
+const texTexture *textures[1] = {&texture};
+meshMesh landMesh, bigLandMesh;
+double unif[16 + 16] = {
+	1.0, 0.0, 0.0, 0.0,
+	0.0, 1.0, 0.0, 0.0,
+	0.0, 0.0, 1.0, 0.0,
+	0.0, 0.0, 0.0, 1.0};
+double viewport[4][4];
+camCamera cam;
+
+/* Returns the current time in seconds. */
+double benchTime(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (double)tv.tv_sec + (double)tv.tv_usec * 0.000001;
+}
+
+/* Builds a landscape mesh from a fixed seed, as 340mainLandscape.c does from a
+random one. Returns an error code (0 on success). */
+int initializeLandscape(meshMesh *mesh, int size) {
+	double *landData = (double *)malloc(size * size * sizeof(double));
+	if (landData == NULL)
+		return 2;
+	landFlat(size, landData, 0.0);
+	srand(311);
+	for (int i = 0; i < 12; i += 1)
+		landFaultRandomly(size, landData, 1.0 - i * 0.04);
+	for (int i = 0; i < 4; i += 1)
+		landBlur(size, landData);
+	for (int i = 0; i < 4; i += 1)
+		landBump(size, landData, landInt(0, size - 1), landInt(0, size - 1),
+			5.0, 1.0);
+	int error = mesh3DInitializeLandscape(mesh, size, 1.0, landData);
+	free(landData);
+	if (error != 0)
+		return 1;
+	for (int i = 0; i < mesh->vertNum; i += 1) {
+		double *vertPtr = meshGetVertexPointer(mesh, i);
+		vertPtr[ATTRS] = 0.0;
+		vertPtr[ATTRT] = vertPtr[ATTRZ];
+	}
+	return 0;
+}
+
+/* Times shaShadeVertices over the big landscape, with or without the batched
+shader. Returns the mean seconds per pass. */
+double benchVertices(void (*shadeVertices)(int, const double[], int, int,
+		const double[], int, double[]), double *vary) {
+	sha.shadeVertices = shadeVertices;
+	shaShadeVertices(&sha, unif, bigLandMesh.vertNum, bigLandMesh.vert, vary);
+	double start = benchTime();
+	for (int i = 0; i < VERTEXREPNUM; i += 1)
+		shaShadeVertices(&sha, unif, bigLandMesh.vertNum, bigLandMesh.vert, vary);
+	return (benchTime() - start) / VERTEXREPNUM;
+}
+
+/* Times whole frames of the mesh, with or without the batched shader. Returns
+the mean seconds per frame. */
+double benchFrames(const meshMesh *mesh, void (*shadeVertices)(int,
+		const double[], int, int, const double[], int, double[])) {
+	sha.shadeVertices = shadeVertices;
+	double start = benchTime();
+	for (int i = 0; i < FRAMENUM; i += 1) {
+		pixClearRGB(0.8, 0.8, 1.0);
+		depthClearDepths(&buf, 1000000000.0);
+		meshRender(mesh, &buf, viewport, &sha, unif, textures);
+	}
+	return (benchTime() - start) / FRAMENUM;
+}
+
+/* Sorts the n times and returns the middle one. */
+double benchMedian(int n, double times[]) {
+	for (int i = 1; i < n; i += 1)
+		for (int k = i; k > 0 && times[k - 1] > times[k]; k -= 1) {
+			double t = times[k];
+			times[k] = times[k - 1];
+			times[k - 1] = t;
+		}
+	return times[n / 2];
+}
+
+/* Times whole frames of the mesh both ways, alternating round after round, so
+that a slow stretch of the machine hits both, and prints the medians. */
+void benchFramesBothWays(const meshMesh *mesh, const char *name) {
+	double adaptedFrames[ROUNDNUM], batchedFrames[ROUNDNUM];
+	for (int k = 0; k < ROUNDNUM; k += 1) {
+		adaptedFrames[k] = benchFrames(mesh, NULL);
+		batchedFrames[k] = benchFrames(mesh, shadeVerticesLand);
+	}
+	double adaptedFrame = benchMedian(ROUNDNUM, adaptedFrames);
+	double batchedFrame = benchMedian(ROUNDNUM, batchedFrames);
+	printf("frames, %s (%d vertices, median of %d rounds): ", name,
+		mesh->vertNum, ROUNDNUM);
+	printf("adapted %f ms/frame, batched %f ms/frame, speedup %fx\n",
+		adaptedFrame * 1000.0, batchedFrame * 1000.0,
+		adaptedFrame / batchedFrame);
+}
+
+int main(void) {
+	if (pixInitialize(WINDOWWIDTH, WINDOWHEIGHT, "Benchmark") != 0)
+		return 1;
+	if (depthInitialize(&buf, WINDOWWIDTH, WINDOWHEIGHT) != 0) {
+		pixFinalize();
+		return 2;
+	}
+	if (texInitializeFile(&texture, "awesome.png") != 0) {
+		depthFinalize(&buf);
+		pixFinalize();
+		return 3;
+	}
+	if (initializeLandscape(&landMesh, LANDSIZE) != 0) {
+		texFinalize(&texture);
+		depthFinalize(&buf);
+		pixFinalize();
+		return 4;
+	}
+	if (initializeLandscape(&bigLandMesh, BIGLANDSIZE) != 0) {
+		meshFinalize(&landMesh);
+		texFinalize(&texture);
+		depthFinalize(&buf);
+		pixFinalize();
+		return 5;
+	}
+	int varyNum = bigLandMesh.vertNum * (4 + 2 + 3);
+	double *varyAdapted = (double *)malloc(varyNum * sizeof(double));
+	double *varyBatched = (double *)malloc(varyNum * sizeof(double));
+	if (varyAdapted == NULL || varyBatched == NULL) {
+		fprintf(stderr, "error: main: malloc failed\n");
+		free(varyAdapted);
+		free(varyBatched);
+		meshFinalize(&bigLandMesh);
+		meshFinalize(&landMesh);
+		texFinalize(&texture);
+		depthFinalize(&buf);
+		pixFinalize();
+		return 6;
+	}
+	texSetFiltering(&texture, texNEAREST);
+	texSetLeftRight(&texture, texREPEAT);
+	texSetTopBottom(&texture, texREPEAT);
+	sha.unifDim = 16 + 16;
+	sha.attrDim = 3 + 2 + 3;
+	sha.varyDim = 4 + 2 + 3;
+	sha.shadeVertex = shadeVertexLand;
+	sha.shadeFragment = shadeFragmentLand;
+	sha.shadeVertices = NULL;
+	sha.texNum = 1;
+	landRegister();
+	mat44Viewport(WINDOWWIDTH, WINDOWHEIGHT, viewport);
+	camSetProjectionType(&cam, camPERSPECTIVE);
+	camSetFrustum(&cam, M_PI / 6.0, 10.0, 10.0, WINDOWWIDTH, WINDOWHEIGHT);
+	double position[3] = {-5.0, -5.0, 20.0};
+	camLookFrom(&cam, position, M_PI * 0.6, M_PI * 0.25);
+	double projInvIsom[4][4];
+	camGetProjectionInverseIsometry(&cam, projInvIsom);
+	vecCopy(16, (double *)projInvIsom, &unif[UNIFPROJINVISOM]);
+#ifdef __AVX2__
+	printf("shadeVerticesLand: using AVX2\n");
+#else
+	printf("shadeVerticesLand: using the scalar fallback\n");
+#endif
+	/* The vertex stage on its own. */
+	double adaptedTime = benchVertices(NULL, varyAdapted);
+	double batchedTime = benchVertices(shadeVerticesLand, varyBatched);
+	double maxDiff = 0.0;
+	for (int i = 0; i < varyNum; i += 1)
+		if (fabs(varyAdapted[i] - varyBatched[i]) > maxDiff)
+			maxDiff = fabs(varyAdapted[i] - varyBatched[i]);
+	printf("vertices (%d): adapted %f ms, batched %f ms, speedup %fx, ",
+		bigLandMesh.vertNum, adaptedTime * 1000.0, batchedTime * 1000.0,
+		adaptedTime / batchedTime);
+	printf("max difference %g\n", maxDiff);
+	/* Whole frames of the small landscape, up close. */
+	benchFramesBothWays(&landMesh, "up close");
+	/* Whole frames of the large landscape, from far away. The frustum moves
+	out with the camera, so that the landscape stays between near and far. */
+	camSetFrustum(&cam, M_PI / 6.0, FARDISTANCE, 10.0, WINDOWWIDTH,
+		WINDOWHEIGHT);
+	double center[3] = {BIGLANDSIZE * 0.5, BIGLANDSIZE * 0.5, 0.0};
+	camLookAt(&cam, center, FARDISTANCE, M_PI * 0.25, M_PI * 0.25);
+	camGetProjectionInverseIsometry(&cam, projInvIsom);
+	vecCopy(16, (double *)projInvIsom, &unif[UNIFPROJINVISOM]);
+	benchFramesBothWays(&bigLandMesh, "far away");
+	/* Clean up. */
+	free(varyBatched);
+	free(varyAdapted);
+	meshFinalize(&bigLandMesh);
+	meshFinalize(&landMesh);
+	texFinalize(&texture);
+	depthFinalize(&buf);
+	pixFinalize();
+	return 0;
+}
@@ -0,0 +1,42 @@
+/*
+    351shading.c
+    Creates the shaShading struct for storing information about uniform, attribute, texture, and varyings arrays.
+    Differs from 260shading.c by adding an optional batched vertex shader, shadeVertices, which
+    transforms a whole run of vertices in one call instead of one vertex per call. Leave it NULL if
+    you don't have one; shaShadeVertices then falls back to calling shadeVertex once per vertex.
+
+    Written by Cole Weinstein and Robbie Young for Carleton College's
+    CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+typedef struct shaShading shaShading;
+
+struct shaShading {
+    int unifDim;
+    int attrDim;
+    int texNum;
+    int varyDim;
+    void (*shadeVertex)(int, const double[], int, const double[], int, double[]);
+    void (*shadeFragment)(int, const double[], int, const texTexture *[], int, const double[], double[4]);
+    /* Optional. Arguments are unifDim, unif, vertNum, attrDim, attr, varyDim,
+    vary. attr holds vertNum * attrDim doubles, packed vertex after vertex as in
+    meshMesh, and vary receives vertNum * varyDim doubles packed the same way. */
+    void (*shadeVertices)(int, const double[], int, int, const double[], int, double[]);
+};
+
+/* Shades vertNum consecutive vertices, whose attributes start at attr, into
+vary. Uses the batched sha->shadeVertices if there is one, and otherwise adapts
+sha->shadeVertex by looping over the vertices. */
+void shaShadeVertices(
+        const shaShading *sha, const double unif[], int vertNum,
+        const double attr[], double vary[]) {
+    if (sha->shadeVertices != NULL)
+        sha->shadeVertices(
+            sha->unifDim, unif, vertNum, sha->attrDim, attr, sha->varyDim,
+            vary);
+    else
+        for (int i = 0; i < vertNum; i += 1)
+            sha->shadeVertex(
+                sha->unifDim, unif, sha->attrDim, &attr[i * sha->attrDim],
+                sha->varyDim, &vary[i * sha->varyDim]);
+}
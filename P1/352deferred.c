@@ -0,0 +1,292 @@
+/*
+    352deferred.c
+    A deferred alternative to meshRender. In the forward path (351mesh.c and 270triangle.c), every
+    fragment is shaded before it is depth-tested, so a pixel covered by five triangles pays for five
+    calls to shadeFragment, four of which are thrown away. Here rendering happens in two passes over
+    a G-buffer. Pass one, defMeshRender, rasterizes the meshes but does not shade. For each pixel it
+    keeps only the nearest fragment's depth, its interpolated varyings, and which draw it came from.
+    Pass two, defShade, calls that draw's shadeFragment exactly once per covered pixel.
+    Works with any shaShading, unchanged, as long as its shadeFragment outputs the interpolated
+    vary[2] as its depth (rgbd[3] = vary[VARYZ]), as every shader since 270 does. Pass one must
+    know each fragment's depth without running the shader, so that is the depth it uses.
+    Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+/* The maximum number of defMeshRender calls between defClear and defShade. */
+#define defMAXDRAWNUM 64
+
+/* One call to defMeshRender. The shading, uniforms, and textures are not
+copied, so they must stay unchanged until defShade. */
+typedef struct defDraw defDraw;
+struct defDraw {
+    const shaShading *sha;
+    const double *unif;
+    const texTexture **tex;
+};
+
+/* Feel free to read the struct's members, but don't write them, except through
+the functions below. fragNum counts the fragments rasterized since the last
+defClear, and shadeNum counts the pixels shaded by the last defShade. Each of
+those would have cost one shadeFragment call in the forward path. */
+typedef struct defBuffer defBuffer;
+struct defBuffer {
+    int width, height, varyDim;
+    double *depths;         /* width * height doubles */
+    double *varys;          /* width * height * varyDim doubles */
+    int *draws;             /* width * height ints, -1 where nothing was drawn */
+    int drawNum;
+    defDraw drawList[defMAXDRAWNUM];
+    int fragNum, shadeNum;
+};
+
+/* Initializes a G-buffer that can hold up to varyDim varyings per pixel. When
+you are finished with the buffer, you must call defFinalize to deallocate its
+backing resources. Returns an error code (0 on success). */
+int defInitialize(defBuffer *buf, int width, int height, int varyDim) {
+    buf->depths = (double *)malloc(width * height * (1 + varyDim) * sizeof(double) +
+        width * height * sizeof(int));
+    if (buf->depths == NULL) {
+        fprintf(stderr, "error: defInitialize: malloc failed\n");
+        return 1;
+    }
+    buf->varys = &buf->depths[width * height];
+    buf->draws = (int *)&buf->varys[width * height * varyDim];
+    buf->width = width;
+    buf->height = height;
+    buf->varyDim = varyDim;
+    buf->drawNum = 0;
+    buf->fragNum = 0;
+    buf->shadeNum = 0;
+    return 0;
+}
+
+/* Deallocates the resources backing the buffer. */
+void defFinalize(defBuffer *buf) {
+    free(buf->depths);
+}
+
+/* Starts a new frame. Sets every depth to the given depth, marks every pixel
+as empty, and forgets the previous frame's draws. */
+void defClear(defBuffer *buf, double depth) {
+    for (int i = 0; i < buf->width * buf->height; i += 1) {
+        buf->depths[i] = depth;
+        buf->draws[i] = -1;
+    }
+    buf->drawNum = 0;
+    buf->fragNum = 0;
+}
+
+/* Pass one's counterpart to setPixel in 270triangle.c. Interpolates only the
+depth at first, and the rest of the varyings only if the fragment is nearer
+than what is already there. The rounding matches setPixel, so that the two
+paths produce identical images. */
+void defSetPixel(
+        defBuffer *buf, int draw, int varyDim, const double x[2],
+        const double a[], const double invertedItpCoeffs[2][2],
+        const double bMinusA[], const double cMinusA[]) {
+    int i = (int)x[0], j = (int)x[1];
+    if (i < 0 || i >= buf->width || j < 0 || j >= buf->height)
+        return;
+    buf->fragNum += 1;
+    double xMinusA[2];
+    double pq[2];
+    vecSubtract(2, x, a, xMinusA);
+    mat221Multiply(invertedItpCoeffs, xMinusA, pq);
+    double depth = a[2] + (pq[0] * bMinusA[2] + pq[1] * cMinusA[2]);
+    int index = i + buf->width * j;
+    if (buf->depths[index] > depth) {
+        buf->depths[index] = depth;
+        buf->draws[index] = draw;
+        double *chi = &buf->varys[index * buf->varyDim];
+        for (int k = 0; k < varyDim; k += 1)
+            chi[k] = a[k] + (pq[0] * bMinusA[k] + pq[1] * cMinusA[k]);
+    }
+}
+
+/* Pass one's counterpart to triRenderHelper in 270triangle.c. a is the
+leftmost vertex. */
+void defTriRenderHelper(
+        defBuffer *buf, int draw, int varyDim,
+        const double a[], const double b[], const double c[]) {
+    double x[2];
+    x[0] = ceil(a[0]);
+
+    double interpolateCoeffs[2][2];
+    double invertedItpCoeffs[2][2];
+    createA(a, b, c, interpolateCoeffs);
+    // backface culling, exactly as in the forward path.
+    if (mat22Invert(interpolateCoeffs, invertedItpCoeffs) <= 0) {
+        return;
+    }
+
+    double bMinusA[varyDim];
+    double cMinusA[varyDim];
+    vecSubtract(varyDim, b, a, bMinusA);
+    vecSubtract(varyDim, c, a, cMinusA);
+
+    // the five cases below mirror those of 270triangle.c. see there for details.
+    if (a[0] == c[0]) {
+        while (x[0] <= floor(b[0])){
+            x[1] = ceil(a[1] + (b[1]-a[1])/(b[0]-a[0])*(x[0]-a[0]));
+            while (x[1] <= floor(c[1] + (b[1]-c[1])/(b[0]-c[0])*(x[0]-c[0]))) {
+                defSetPixel(buf, draw, varyDim, x, a, invertedItpCoeffs, bMinusA, cMinusA);
+                x[1] = x[1] + 1;
+            }
+            x[0] = x[0] + 1;
+        }
+    }
+    else if (a[0] == b[0]) {
+        while (x[0] <= floor(c[0])){
+            x[1] = ceil(b[1] + (c[1]-b[1])/(c[0]-b[0])*(x[0]-b[0]));
+            while (x[1] <= floor(a[1] + (c[1]-a[1])/(c[0]-a[0])*(x[0]-a[0]))) {
+                defSetPixel(buf, draw, varyDim, x, a, invertedItpCoeffs, bMinusA, cMinusA);
+                x[1] = x[1] + 1;
+            }
+            x[0] = x[0] + 1;
+        }
+    }
+    else if (b[0] == c[0]) {
+        while (x[0] <= floor(c[0])){
+            x[1] = ceil(a[1] + (b[1]-a[1])/(b[0]-a[0])*(x[0]-a[0]));
+            while (x[1] <= floor(a[1] + (c[1]-a[1])/(c[0]-a[0])*(x[0]-a[0]))) {
+                defSetPixel(buf, draw, varyDim, x, a, invertedItpCoeffs, bMinusA, cMinusA);
+                x[1] = x[1] + 1;
+            }
+            x[0] = x[0] + 1;
+        }
+    }
+    else if (b[0] < c[0]) {
+        while (x[0] <= floor(b[0])){
+            x[1] = ceil(a[1] + (a[1]-b[1])/(a[0]-b[0])*(x[0]-a[0]));
+            while (x[1] <= floor(a[1] + (c[1]-a[1])/(c[0]-a[0])*(x[0]-a[0]))) {
+                defSetPixel(buf, draw, varyDim, x, a, invertedItpCoeffs, bMinusA, cMinusA);
+                x[1] = x[1] + 1;
+            }
+            x[0] = x[0] + 1;
+        }
+        while (x[0] <= floor(c[0])){
+            x[1] = ceil(c[1] + (c[1]-b[1])/(c[0]-b[0])*(x[0]-c[0]));
+            while (x[1] <= floor(a[1] + (c[1]-a[1])/(c[0]-a[0])*(x[0]-a[0]))) {
+                defSetPixel(buf, draw, varyDim, x, a, invertedItpCoeffs, bMinusA, cMinusA);
+                x[1] = x[1] + 1;
+            }
+            x[0] = x[0] + 1;
+        }
+    }
+    else {
+        while (x[0] <= floor(c[0])){
+            x[1] = ceil(a[1] + (b[1]-a[1])/(b[0]-a[0])*(x[0]-a[0]));
+            while (x[1] <= floor(a[1] + (c[1]-a[1])/(c[0]-a[0])*(x[0]-a[0]))) {
+                defSetPixel(buf, draw, varyDim, x, a, invertedItpCoeffs, bMinusA, cMinusA);
+                x[1] = x[1] + 1;
+            }
+            x[0] = x[0] + 1;
+        }
+        while (x[0] <= floor(b[0])){
+            x[1] = ceil(a[1] + (b[1]-a[1])/(b[0]-a[0])*(x[0]-a[0]));
+            while (x[1] <= floor(b[1] + (c[1]-b[1])/(c[0]-b[0])*(x[0]-b[0]))) {
+                defSetPixel(buf, draw, varyDim, x, a, invertedItpCoeffs, bMinusA, cMinusA);
+                x[1] = x[1] + 1;
+            }
+            x[0] = x[0] + 1;
+        }
+    }
+}
+
+/* Pass one's counterpart to triRender. */
+void defTriRender(
+        defBuffer *buf, int draw, int varyDim,
+        const double a[], const double b[], const double c[]) {
+    if (a[0] <= b[0] && a[0] <= c[0])
+        defTriRenderHelper(buf, draw, varyDim, a, b, c);
+    else if(b[0] <= a[0] && b[0] <= c[0])
+        defTriRenderHelper(buf, draw, varyDim, b, c, a);
+    else
+        defTriRenderHelper(buf, draw, varyDim, c, a, b);
+}
+
+/* Pass one. Takes the same arguments as meshRender in 351mesh.c, and shades
+the vertices in the same way, but only records the mesh's nearest fragments in
+the G-buffer. unif and tex are kept by reference until defShade, so don't
+change them in between. Returns an error code (0 on success). */
+int defMeshRender(
+        const meshMesh *mesh, defBuffer *buf, const double viewport[4][4],
+        const shaShading *sha, const double unif[], const texTexture *tex[]) {
+    if (mesh->attrDim != sha->attrDim) {
+        fprintf(stderr, "error: defMeshRender: attrDim mismatch\n");
+        return 1;
+    }
+    if (sha->varyDim > buf->varyDim) {
+        fprintf(stderr, "error: defMeshRender: varyDim exceeds the G-buffer's\n");
+        return 2;
+    }
+    if (buf->drawNum >= defMAXDRAWNUM) {
+        fprintf(stderr, "error: defMeshRender: too many draws\n");
+        return 3;
+    }
+    double *vary = (double *)malloc(mesh->vertNum * sha->varyDim * sizeof(double));
+    if (vary == NULL) {
+        fprintf(stderr, "error: defMeshRender: malloc failed\n");
+        return 4;
+    }
+    int draw = buf->drawNum;
+    buf->drawList[draw].sha = sha;
+    buf->drawList[draw].unif = unif;
+    buf->drawList[draw].tex = tex;
+    buf->drawNum += 1;
+    double varyTransformed[sha->varyDim];
+    shaShadeVertices(sha, unif, mesh->vertNum, mesh->vert, vary);
+    for (int i = 0; i < mesh->vertNum; i += 1) {
+        double *varyI = &vary[i * sha->varyDim];
+        vecCopy(sha->varyDim, varyI, varyTransformed);
+        mat441Multiply(viewport, varyI, varyTransformed);
+        vecScale(sha->varyDim, 1/varyTransformed[3], varyTransformed, varyI);
+    }
+    for (int i = 0; i < mesh->triNum; i += 1) {
+        int *tri = meshGetTrianglePointer(mesh, i);
+        defTriRender(buf, draw, sha->varyDim, &vary[tri[0] * sha->varyDim],
+            &vary[tri[1] * sha->varyDim], &vary[tri[2] * sha->varyDim]);
+    }
+    free(vary);
+    return 0;
+}
+
+/* Pass two. Runs shadeFragment exactly once for each pixel that pass one
+covered, and writes the results to the window. Pixels that no mesh covered are
+left as they are, so clear the window first if you need to. Each run of covered
+pixels in a row is written with one pixSetSpanRGB. */
+void defShade(defBuffer *buf) {
+    double rgbd[4];
+    double span[3 * buf->width];
+    buf->shadeNum = 0;
+    for (int j = 0; j < buf->height; j += 1) {
+        int start = -1;
+        for (int i = 0; i <= buf->width; i += 1) {
+            int index = i + buf->width * j;
+            if (i == buf->width || buf->draws[index] < 0) {
+                if (start >= 0)
+                    pixSetSpanRGB(start, j, i - start, &span[3 * start]);
+                start = -1;
+                continue;
+            }
+            const defDraw *draw = &buf->drawList[buf->draws[index]];
+            const shaShading *sha = draw->sha;
+            vec3Set(1.0, 1.0, 1.0, rgbd);
+            sha->shadeFragment(sha->unifDim, draw->unif, sha->texNum, draw->tex,
+                sha->varyDim, &buf->varys[index * buf->varyDim], rgbd);
+            vecCopy(3, rgbd, &span[3 * i]);
+            if (start < 0)
+                start = i;
+            buf->shadeNum += 1;
+        }
+    }
+}
+
+/* Returns the overdraw factor of the last frame: the number of fragments
+rasterized per pixel covered. That's how many times more often the forward path
+calls shadeFragment than defShade does. Call it after defShade. */
+double defGetOverdraw(const defBuffer *buf) {
+    if (buf->shadeNum == 0)
+        return 0.0;
+    return (double)buf->fragNum / buf->shadeNum;
+}
@@ -0,0 +1,387 @@
+/*
+	352mainDeferred.c
+	Times forward rendering (351mesh.c) against deferred rendering (352deferred.c), and measures
+	the overdraw factor that the deferred path saves on. There are two scenes, with their shaders
+	unchanged: the five meshes of 291mainWorld.c, seen through the 300-series perspective pipeline
+	(jondich.jpeg doesn't load in this directory, so jondich.jpg stands in for it), and the
+	landscape of 340mainLandscape.c. Each scene is rendered the same number of times along each
+	path, and the two resulting images are compared pixel by pixel.
+	Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+
+/* On macOS, compile with...
+    clang -O3 352mainDeferred.c 040pixel.o -lglfw -framework OpenGL -framework Cocoa -framework IOKit
+On Ubuntu, compile with...
+    cc -O3 352mainDeferred.c 040pixel.o -lglfw -lGL -lm -ldl
+*/
+
+#define WINDOWWIDTH 512.0
+#define WINDOWHEIGHT 512.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <GLFW/glfw3.h>
+#include <sys/time.h>
+
+#include "040pixel.h"
+
+#include "250vector.c"
+#include "280matrix.c"
+#include "150texture.c"
+#include "351shading.c"
+#include "260depth.c"
+#include "270triangle.c"
+#include "350kernel.c"
+#include "351mesh.c"
+#include "352deferred.c"
+#include "250mesh3D.c"
+#include "300isometry.c"
+#include "300camera.c"
+#include "340landscape.c"
+
+#define LANDSIZE 40
+#define WARMUPNUM 5
+#define FRAMENUM 100
+
+#define ATTRX 0
+#define ATTRY 1
+#define ATTRZ 2
+#define ATTRS 3
+#define ATTRT 4
+#define ATTRN 5
+#define ATTRO 6
+#define ATTRP 7
+#define VARYX 0
+#define VARYY 1
+#define VARYZ 2
+#define VARYW 3
+#define VARYS 4
+#define VARYT 5
+#define VARYN 6
+#define VARYO 7
+#define VARYP 8
+#define TEXR 0
+#define TEXG 1
+#define TEXB 2
+
+/* The world's uniforms, as in 291mainWorld.c. */
+#define WORLDUNIFR 0
+#define WORLDUNIFG 1
+#define WORLDUNIFB 2
+#define WORLDUNIFMODELING 3
+#define WORLDUNIFPROJECTION 19
+
+/* The landscape's uniforms, as in 340mainLandscape.c. */
+#define LANDUNIFMODELING 0
+#define LANDUNIFPROJINVISOM 16
+
+void shadeVertexWorld(
+        int unifDim, const double unif[], int attrDim, const double attr[],
+        int varyDim, double vary[]) {
+	double attrHomog[4] = {attr[ATTRX], attr[ATTRY], attr[ATTRZ], 1.0};
+	double modelHomog[4] = {0.0, 0.0, 0.0, 0.0};
+	mat441Multiply((double(*)[4])(&unif[WORLDUNIFMODELING]), attrHomog, modelHomog);
+	mat441Multiply((double(*)[4])(&unif[WORLDUNIFPROJECTION]), modelHomog, vary);
+	vary[VARYS] = attr[ATTRS];
+	vary[VARYT] = attr[ATTRT];
+}
+
+void shadeFragmentWorld(
+        int unifDim, const double unif[], int texNum, const texTexture *tex[],
+        int varyDim, const double vary[], double rgbd[4]) {
+	double sample[tex[0]->texelDim];
+	texSample(tex[0], vary[VARYS], vary[VARYT], sample);
+	rgbd[0] = sample[TEXR] * 0.4 + unif[WORLDUNIFR] * 0.6;
+	rgbd[1] = sample[TEXG] * 0.4 + unif[WORLDUNIFG] * 0.6;
+	rgbd[2] = sample[TEXB] * 0.4 + unif[WORLDUNIFB] * 0.6;
+	rgbd[3] = vary[VARYZ];
+}
+
+void shadeVertexLand(
+        int unifDim, const double unif[], int attrDim, const double attr[],
+        int varyDim, double vary[]) {
+	double attrHomog[4] = {attr[ATTRX], attr[ATTRY], attr[ATTRZ], 1.0};
+	double modHomog[4];
+	mat441Multiply((double(*)[4])(&unif[LANDUNIFMODELING]), attrHomog, modHomog);
+	mat441Multiply((double(*)[4])(&unif[LANDUNIFPROJINVISOM]), modHomog, vary);
+	vecCopy(5, &attr[ATTRS], &vary[VARYS]);
+}
+
+void shadeFragmentLand(
+        int unifDim, const double unif[], int texNum, const texTexture *tex[],
+        int varyDim, const double vary[], double rgbd[4]) {
+	double sample[tex[0]->texelDim];
+	texSample(tex[0], vary[VARYS], vary[VARYT], sample);
+	sample[0] = sample[1] * 0.2 + 0.8;
+	sample[1] = sample[1] * 0.2 + 0.6;
+	sample[2] = 0.3;
+	double intensity = vary[VARYP] / vecLength(3, &vary[VARYN]);
+	vecScale(3, intensity, sample, rgbd);
+	rgbd[3] = vary[VARYZ];
+}
+
+depthBuffer buf;
+defBuffer gBuf;
+shaShading shaWorld, shaLand;
+texTexture texWorld, texLand;
+const texTexture *texturesWorld[1] = {&texWorld};
+const texTexture *texturesLand[1] = {&texLand};
+meshMesh meshGround, meshHouse, meshTrunk, meshLeaves, meshBox, meshLand;
+meshMesh *meshesWorld[5] = {&meshGround, &meshHouse, &meshTrunk, &meshLeaves, &meshBox};
+double unifWorld[5][3 + 16 + 16];
+double colorsWorld[5][3] = {
+	{0.0, 1.0, 0.0}, {1.0, 0.0, 0.3}, {0.6, 0.3, 0.0}, {0.3, 1.0, 0.3}, {1.0, 1.0, 1.0}};
+double unifLand[16 + 16] = {
+	1.0, 0.0, 0.0, 0.0,
+	0.0, 1.0, 0.0, 0.0,
+	0.0, 0.0, 1.0, 0.0,
+	0.0, 0.0, 0.0, 1.0};
+double viewport[4][4];
+camCamera cam;
+
+/* Returns the current time in seconds. */
+double benchTime(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (double)tv.tv_sec + (double)tv.tv_usec * 0.000001;
+}
+
+/* Sets the world's modeling transformations as 291mainWorld.c does, except
+that the frame index tilts the scene. */
+void setWorldUniforms(int frame) {
+	double xAxis[3] = {1.0, 0.0, 0.0}, yAxis[3] = {0.0, 1.0, 0.0};
+	double translations[5][3] = {
+		{0.0, -10.0, -50.0}, {-5.0, -4.0, -48.0}, {7.0, -4.0, -50.0},
+		{7.0, 0.0, -50.0}, {0.0, 0.0, -200.0}};
+	double rotations[5][3][3], isom[4][4];
+	mat33AngleAxisRotation(frame * 0.002, xAxis, rotations[0]);
+	mat33AngleAxisRotation(M_PI / 4.0, yAxis, rotations[1]);
+	mat33AngleAxisRotation(-M_PI / 2.0, xAxis, rotations[2]);
+	mat33AngleAxisRotation(-M_PI / 2.0, xAxis, rotations[3]);
+	mat33AngleAxisRotation(frame * 0.002, xAxis, rotations[4]);
+	for (int i = 0; i < 5; i += 1) {
+		mat44Isometry(rotations[i], translations[i], isom);
+		vecCopy(16, (double *)isom, &unifWorld[i][WORLDUNIFMODELING]);
+	}
+}
+
+/* Renders the world along the forward (0) or deferred (1) path. */
+void renderWorld(int frame, int deferred) {
+	pixClearRGB(0.0, 0.0, 0.0);
+	setWorldUniforms(frame);
+	if (deferred) {
+		defClear(&gBuf, 1000.0);
+		for (int i = 0; i < 5; i += 1)
+			defMeshRender(meshesWorld[i], &gBuf, viewport, &shaWorld, unifWorld[i],
+				texturesWorld);
+		defShade(&gBuf);
+	} else {
+		depthClearDepths(&buf, 1000.0);
+		for (int i = 0; i < 5; i += 1)
+			meshRender(meshesWorld[i], &buf, viewport, &shaWorld, unifWorld[i],
+				texturesWorld);
+	}
+}
+
+/* Renders the landscape along the forward (0) or deferred (1) path. The frame
+index slowly spins the camera. */
+void renderLand(int frame, int deferred) {
+	pixClearRGB(0.8, 0.8, 1.0);
+	double position[3] = {-5.0, -5.0, 20.0};
+	camLookFrom(&cam, position, M_PI * 0.6, M_PI * 0.25 + frame * 0.001);
+	double projInvIsom[4][4];
+	camGetProjectionInverseIsometry(&cam, projInvIsom);
+	vecCopy(16, (double *)projInvIsom, &unifLand[LANDUNIFPROJINVISOM]);
+	if (deferred) {
+		defClear(&gBuf, 1000000000.0);
+		defMeshRender(&meshLand, &gBuf, viewport, &shaLand, unifLand, texturesLand);
+		defShade(&gBuf);
+	} else {
+		depthClearDepths(&buf, 1000000000.0);
+		meshRender(&meshLand, &buf, viewport, &shaLand, unifLand, texturesLand);
+	}
+}
+
+/* Renders the scene FRAMENUM times along one path, after a few untimed warm-up
+frames. Returns the mean seconds per frame. Leaves the last frame's pixels in
+image, which must hold width * height * 3 doubles. */
+double benchRun(void (*render)(int, int), int deferred, double *image) {
+	for (int i = 0; i < WARMUPNUM; i += 1)
+		render(i, deferred);
+	double start = benchTime();
+	for (int i = 0; i < FRAMENUM; i += 1)
+		render(i, deferred);
+	double seconds = (benchTime() - start) / FRAMENUM;
+	pixCopyRGB(image);
+	return seconds;
+}
+
+/* Benchmarks one scene along both paths and prints the comparison, including
+the last deferred frame's overdraw. */
+void benchScene(const char *name, void (*render)(int, int), double *forward,
+		double *deferred) {
+	double forwardTime = benchRun(render, 0, forward);
+	double deferredTime = benchRun(render, 1, deferred);
+	int differing = 0;
+	for (int i = 0; i < WINDOWWIDTH * WINDOWHEIGHT * 3; i += 1)
+		if (forward[i] != deferred[i])
+			differing += 1;
+	printf("%s: forward %f ms/frame, deferred %f ms/frame, speedup %fx, ",
+		name, forwardTime * 1000.0, deferredTime * 1000.0,
+		forwardTime / deferredTime);
+	printf("%d differing channels\n", differing);
+	printf("%s: %d fragments over %d pixels, overdraw factor %f\n", name,
+		gBuf.fragNum, gBuf.shadeNum, defGetOverdraw(&gBuf));
+}
+
+int initializeMeshes(void) {
+	if (mesh3DInitializeBox(&meshGround, -15.0, 15.0, -3.0, 3.0, -10.0, 10.0) != 0)
+		return 6;
+	if (mesh3DInitializeBox(&meshHouse, -3.0, 3.0, -3.0, 3.0, -3.0, 3.0) != 0) {
+		meshFinalize(&meshGround);
+		return 5;
+	}
+	if (mesh3DInitializeCylinder(&meshTrunk, 1, 10, 30) != 0) {
+		meshFinalize(&meshHouse);
+		meshFinalize(&meshGround);
+		return 4;
+	}
+	if (mesh3DInitializeSphere(&meshLeaves, 3, 15, 15) != 0) {
+		meshFinalize(&meshTrunk);
+		meshFinalize(&meshHouse);
+		meshFinalize(&meshGround);
+		return 3;
+	}
+	if (mesh3DInitializeBox(&meshBox, -3.0, 3.0, -3.0, 3.0, -3.0, 3.0) != 0) {
+		meshFinalize(&meshLeaves);
+		meshFinalize(&meshTrunk);
+		meshFinalize(&meshHouse);
+		meshFinalize(&meshGround);
+		return 2;
+	}
+	/* The landscape is generated as in 340mainLandscape.c, but from a fixed
+	seed, so that every run draws the same one. */
+	double landData[LANDSIZE][LANDSIZE];
+	landFlat(LANDSIZE, (double *)landData, 0.0);
+	srand(311);
+	for (int i = 0; i < 12; i += 1)
+		landFaultRandomly(LANDSIZE, (double *)landData, 1.0 - i * 0.04);
+	for (int i = 0; i < 4; i += 1)
+		landBlur(LANDSIZE, (double *)landData);
+	for (int i = 0; i < 4; i += 1)
+		landBump(LANDSIZE, (double *)landData, landInt(0, LANDSIZE - 1),
+			landInt(0, LANDSIZE - 1), 5.0, 1.0);
+	if (mesh3DInitializeLandscape(&meshLand, LANDSIZE, 1.0, (double *)landData) != 0) {
+		for (int i = 0; i < 5; i += 1)
+			meshFinalize(meshesWorld[i]);
+		return 1;
+	}
+	for (int i = 0; i < meshLand.vertNum; i += 1) {
+		double *vertPtr = meshGetVertexPointer(&meshLand, i);
+		vertPtr[ATTRS] = 0.0;
+		vertPtr[ATTRT] = vertPtr[ATTRZ];
+	}
+	return 0;
+}
+
+void finalizeMeshes(void) {
+	meshFinalize(&meshLand);
+	for (int i = 0; i < 5; i += 1)
+		meshFinalize(meshesWorld[i]);
+}
+
+int main(void) {
+	if (pixInitialize(WINDOWWIDTH, WINDOWHEIGHT, "Deferred") != 0)
+		return 1;
+	if (depthInitialize(&buf, WINDOWWIDTH, WINDOWHEIGHT) != 0) {
+		pixFinalize();
+		return 2;
+	}
+	if (defInitialize(&gBuf, WINDOWWIDTH, WINDOWHEIGHT, 4 + 2 + 3) != 0) {
+		depthFinalize(&buf);
+		pixFinalize();
+		return 3;
+	}
+	if (texInitializeFile(&texWorld, "jondich.jpg") != 0) {
+		defFinalize(&gBuf);
+		depthFinalize(&buf);
+		pixFinalize();
+		return 4;
+	}
+	if (texInitializeFile(&texLand, "awesome.png") != 0) {
+		texFinalize(&texWorld);
+		defFinalize(&gBuf);
+		depthFinalize(&buf);
+		pixFinalize();
+		return 5;
+	}
+	if (initializeMeshes() != 0) {
+		texFinalize(&texLand);
+		texFinalize(&texWorld);
+		defFinalize(&gBuf);
+		depthFinalize(&buf);
+		pixFinalize();
+		return 6;
+	}
+	double *forward = malloc(WINDOWWIDTH * WINDOWHEIGHT * 3 * sizeof(double));
+	double *deferred = malloc(WINDOWWIDTH * WINDOWHEIGHT * 3 * sizeof(double));
+	if (forward == NULL || deferred == NULL) {
+		fprintf(stderr, "error: main: malloc failed\n");
+		free(forward);
+		free(deferred);
+		finalizeMeshes();
+		texFinalize(&texLand);
+		texFinalize(&texWorld);
+		defFinalize(&gBuf);
+		depthFinalize(&buf);
+		pixFinalize();
+		return 7;
+	}
+	/* Configure textures and shader programs. */
+	texSetFiltering(&texWorld, texNEAREST);
+	texSetLeftRight(&texWorld, texCLIP);
+	texSetTopBottom(&texWorld, texCLIP);
+	texSetFiltering(&texLand, texNEAREST);
+	texSetLeftRight(&texLand, texREPEAT);
+	texSetTopBottom(&texLand, texREPEAT);
+	shaWorld.unifDim = 3 + 16 + 16;
+	shaWorld.attrDim = 3 + 2 + 3;
+	shaWorld.varyDim = 4 + 2;
+	shaWorld.shadeVertex = shadeVertexWorld;
+	shaWorld.shadeFragment = shadeFragmentWorld;
+	shaWorld.shadeVertices = NULL;
+	shaWorld.texNum = 1;
+	shaLand.unifDim = 16 + 16;
+	shaLand.attrDim = 3 + 2 + 3;
+	shaLand.varyDim = 4 + 2 + 3;
+	shaLand.shadeVertex = shadeVertexLand;
+	shaLand.shadeFragment = shadeFragmentLand;
+	shaLand.shadeVertices = NULL;
+	shaLand.texNum = 1;
+	/* Configure viewport and camera. The world is modeled in camera
+	coordinates, so it gets the bare projection, as in 291mainWorld.c. */
+	mat44Viewport(WINDOWWIDTH, WINDOWHEIGHT, viewport);
+	camSetProjectionType(&cam, camPERSPECTIVE);
+	camSetFrustum(&cam, M_PI / 6.0, 10.0, 10.0, WINDOWWIDTH, WINDOWHEIGHT);
+	double proj[4][4];
+	camGetPerspective(&cam, proj);
+	for (int i = 0; i < 5; i += 1) {
+		vecCopy(3, colorsWorld[i], &unifWorld[i][WORLDUNIFR]);
+		vecCopy(16, (double *)proj, &unifWorld[i][WORLDUNIFPROJECTION]);
+	}
+	/* Run the benchmarks. */
+	benchScene("world (291)", renderWorld, forward, deferred);
+	benchScene("landscape (340)", renderLand, forward, deferred);
+	/* Clean up. */
+	free(deferred);
+	free(forward);
+	finalizeMeshes();
+	texFinalize(&texLand);
+	texFinalize(&texWorld);
+	defFinalize(&gBuf);
+	depthFinalize(&buf);
+	pixFinalize();
+	return 0;
+}
@@ -0,0 +1,82 @@
+/*
+    353stats.c
+    Pipeline statistics for the software renderer. 353triangle.c, 353mesh.c, and the kernels of
+    350specialize.c count what happens to every vertex, triangle, and fragment, and time the four
+    stages of the pipeline: vertex (shading, viewport, and homogeneous division), setup (per-triangle
+    culling and interpolation coefficients), raster (walking the triangle's pixels), and fragment
+    (interpolation, shadeFragment, and the depth test).
+    Collection is controlled by STATS, much as diagnostics are controlled by VERBOSE in the Vulkan
+    demos. Define STATS as 1 before including this file to collect. Otherwise STATS defaults to 0,
+    and every STATADD, STATSTART, and STATSTOP compiles to nothing. Timing calls the clock twice
+    per fragment, so expect frames to run noticeably slower with STATS on.
+    Include this file before 350kernel.c, 353triangle.c, and 353mesh.c.
+    Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+#ifndef STATS
+#define STATS 0
+#endif
+
+/* Feel free to read the struct's members, but don't write them, except
+through the macros and functions below. Counts and times accumulate from one
+statReset to the next. */
+typedef struct statStatistics statStatistics;
+struct statStatistics {
+    int frameNum;
+    int vertNum;            /* vertices shaded */
+    int triNum;             /* triangles submitted to the rasterizer */
+    int culledNum;          /* back-facing or degenerate (mat22Invert <= 0) */
+    int offscreenNum;       /* entirely outside the window, so never rasterized */
+    int fragNum;            /* fragments produced by rasterization */
+    int clippedNum;         /* fragments outside the window */
+    int shadedNum;          /* fragments passed to shadeFragment */
+    int rejectedNum;        /* shaded fragments that failed the depth test */
+    int writtenNum;         /* fragments written to the window */
+    double vertexTime, setupTime, rasterTime, fragmentTime;    /* seconds */
+};
+
+statStatistics statStats;
+
+#if STATS
+#define STATADD(member, n) (statStats.member += (n))
+#define STATSTART(start) double start = statTime()
+#define STATSTOP(member, start) (statStats.member += statTime() - (start))
+#else
+#define STATADD(member, n)
+#define STATSTART(start)
+#define STATSTOP(member, start)
+#endif
+
+/* Returns the time, in seconds, from a monotonic clock. */
+double statTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 0.000000001;
+}
+
+/* Zeroes all of the counts and times. */
+void statReset(void) {
+    statStatistics zero = {0};
+    statStats = zero;
+}
+
+/* Prints the frame rate, and, if STATS is on, the counts and times per frame
+averaged since the last statReset. frameTime is the duration of the last frame
+in seconds. Meant to replace the frames/sec line in handleTimeStep. */
+void statPrint(double frameTime) {
+    printf("handleTimeStep: %f frames/sec\n", 1.0 / frameTime);
+    if (!STATS || statStats.frameNum == 0)
+        return;
+    double n = statStats.frameNum;
+    printf("    per frame: %.0f vertices, %.0f triangles (%.0f culled, %.0f off-screen)\n",
+        statStats.vertNum / n, statStats.triNum / n, statStats.culledNum / n,
+        statStats.offscreenNum / n);
+    printf("    per frame: %.0f fragments (%.0f clipped), %.0f shaded, %.0f depth-rejected, %.0f written\n",
+        statStats.fragNum / n, statStats.clippedNum / n, statStats.shadedNum / n,
+        statStats.rejectedNum / n, statStats.writtenNum / n);
+    /* The raster stage includes the fragment stage, so subtract it out. */
+    printf("    ms per frame: vertex %.3f, setup %.3f, raster %.3f, fragment %.3f\n",
+        statStats.vertexTime * 1000.0 / n, statStats.setupTime * 1000.0 / n,
+        (statStats.rasterTime - statStats.fragmentTime) * 1000.0 / n,
+        statStats.fragmentTime * 1000.0 / n);
+}
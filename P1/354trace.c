@@ -0,0 +1,197 @@
+/*
+    354trace.c
+    Implements the span recorder declared in 354trace.h. Each thread gets its own ring buffer the
+    first time it marks a span. The buffers are linked into a list by compare-and-swap, and each one
+    is written only by its own thread, which publishes every finished span by bumping an atomic
+    count. So recording never takes a lock, and traceWrite can read all of the buffers from any
+    thread. A span that its thread is overwriting at the very moment traceWrite reads it may come
+    out garbled, but no other harm is done.
+    Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "354trace.h"
+
+/* The number of spans kept per thread. Must be a power of 2. */
+#define traceCAPACITY 65536
+/* The deepest nesting of open spans that is recorded. */
+#define traceMAXDEPTH 64
+#define traceMAXPATH 1024
+
+typedef struct traceSpan traceSpan;
+struct traceSpan {
+    const char *name;
+    double start, duration;             /* microseconds */
+};
+
+typedef struct traceThread traceThread;
+struct traceThread {
+    int id;
+    const char *name;
+    atomic_ulong count;                 /* spans ever finished on this thread */
+    int depth;
+    const char *openNames[traceMAXDEPTH];
+    double openStarts[traceMAXDEPTH];
+    traceSpan spans[traceCAPACITY];
+    traceThread *next;
+};
+
+_Atomic(traceThread *) traceThreads = NULL;
+atomic_int traceThreadNum = 0;
+atomic_int traceEnabled = 0;
+_Thread_local traceThread *traceSelf = NULL;
+char tracePath[traceMAXPATH];
+double traceOrigin;
+int traceAtExitRegistered = 0;
+
+/* Returns the time, in microseconds, from a monotonic clock. */
+double traceTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000000.0 + (double)ts.tv_nsec * 0.001;
+}
+
+/* Returns the calling thread's buffer, creating and linking it in if this is
+the thread's first span. Returns NULL if memory runs out. */
+traceThread *traceGetSelf(void) {
+    if (traceSelf != NULL)
+        return traceSelf;
+    traceThread *self = (traceThread *)calloc(1, sizeof(traceThread));
+    if (self == NULL) {
+        fprintf(stderr, "error: traceGetSelf: calloc failed\n");
+        return NULL;
+    }
+    self->id = atomic_fetch_add(&traceThreadNum, 1) + 1;
+    atomic_init(&self->count, 0);
+    self->next = atomic_load(&traceThreads);
+    while (!atomic_compare_exchange_weak(&traceThreads, &self->next, self))
+        ;
+    traceSelf = self;
+    return self;
+}
+
+void traceBegin(const char *name) {
+    if (!atomic_load_explicit(&traceEnabled, memory_order_relaxed))
+        return;
+    traceThread *self = traceGetSelf();
+    if (self == NULL)
+        return;
+    if (self->depth < traceMAXDEPTH) {
+        self->openNames[self->depth] = name;
+        self->openStarts[self->depth] = traceTime();
+    }
+    self->depth += 1;
+}
+
+void traceEnd(void) {
+    if (!atomic_load_explicit(&traceEnabled, memory_order_relaxed))
+        return;
+    traceThread *self = traceSelf;
+    if (self == NULL || self->depth == 0)
+        return;
+    self->depth -= 1;
+    if (self->depth >= traceMAXDEPTH)
+        return;
+    unsigned long count = atomic_load_explicit(&self->count, memory_order_relaxed);
+    traceSpan *span = &self->spans[count & (traceCAPACITY - 1)];
+    span->name = self->openNames[self->depth];
+    span->start = self->openStarts[self->depth];
+    span->duration = traceTime() - span->start;
+    atomic_store_explicit(&self->count, count + 1, memory_order_release);
+}
+
+void traceEndScope(int *scope) {
+    traceEnd();
+}
+
+void traceSetThreadName(const char *name) {
+    traceThread *self = traceGetSelf();
+    if (self != NULL)
+        self->name = name;
+}
+
+/* Writes name as a JSON string, escaping the characters that need it. */
+void traceWriteString(FILE *file, const char *name) {
+    fputc('"', file);
+    for (const char *c = name; *c != '\0'; c += 1)
+        if (*c == '"' || *c == '\\')
+            fprintf(file, "\\%c", *c);
+        else if ((unsigned char)*c < 0x20)
+            fprintf(file, "\\u%04x", *c);
+        else
+            fputc(*c, file);
+    fputc('"', file);
+}
+
+int traceWrite(void) {
+    if (tracePath[0] == '\0') {
+        fprintf(stderr, "error: traceWrite: traceStart was never called\n");
+        return 1;
+    }
+    FILE *file = fopen(tracePath, "w");
+    if (file == NULL) {
+        fprintf(stderr, "error: traceWrite: could not open %s\n", tracePath);
+        return 2;
+    }
+    fprintf(file, "{\"traceEvents\":[\n");
+    int first = 1;
+    traceThread *thread = atomic_load(&traceThreads);
+    while (thread != NULL) {
+        if (thread->name != NULL) {
+            fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+                first ? "" : ",\n", thread->id);
+            traceWriteString(file, thread->name);
+            fprintf(file, "}}");
+            first = 0;
+        }
+        unsigned long count = atomic_load_explicit(&thread->count, memory_order_acquire);
+        unsigned long i = (count > traceCAPACITY) ? count - traceCAPACITY : 0;
+        for (; i < count; i += 1) {
+            traceSpan *span = &thread->spans[i & (traceCAPACITY - 1)];
+            fprintf(file, "%s{\"name\":", first ? "" : ",\n");
+            traceWriteString(file, span->name);
+            fprintf(file, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                span->start - traceOrigin, span->duration, thread->id);
+            first = 0;
+        }
+        thread = thread->next;
+    }
+    fprintf(file, "\n]}\n");
+    if (fclose(file) != 0) {
+        fprintf(stderr, "error: traceWrite: could not finish %s\n", tracePath);
+        return 3;
+    }
+    fprintf(stderr, "info: traceWrite: wrote %s\n", tracePath);
+    return 0;
+}
+
+/* Registered with atexit by traceStart. */
+void traceWriteAtExit(void) {
+    traceWrite();
+}
+
+int traceStart(const char *path) {
+    if (strlen(path) >= traceMAXPATH) {
+        fprintf(stderr, "error: traceStart: path too long\n");
+        return 1;
+    }
+    strcpy(tracePath, path);
+    if (!traceAtExitRegistered) {
+        if (atexit(traceWriteAtExit) != 0) {
+            fprintf(stderr, "error: traceStart: atexit failed\n");
+            return 2;
+        }
+        traceAtExitRegistered = 1;
+        traceOrigin = traceTime();
+    }
+    atomic_store(&traceEnabled, 1);
+    return 0;
+}
+
+void traceStop(void) {
+    atomic_store(&traceEnabled, 0);
+}
@@ -0,0 +1,102 @@
+/* This is a C header file. It declares the public functions and macros of the
+354trace.o library, which records timelines of named spans and writes them out
+in the Chrome trace format, for viewing in chrome://tracing or in Perfetto
+(ui.perfetto.dev). The implementation details are hidden in 354trace.c.
+
+Tracing is controlled by TRACE, much as diagnostics are controlled by VERBOSE in
+the Vulkan demos. Define TRACE as 1 before including this header to trace.
+Otherwise TRACE defaults to 0, and all of the macros below compile to nothing.
+With TRACE on, the markers still cost only a flag check until traceStart is
+called.
+
+On macOS, compile with...
+    clang -c -DTRACE=1 354trace.c
+...and then link with a main program by for example...
+    clang main.c 040pixel.o 354trace.o -lglfw -framework OpenGL -framework Cocoa -framework IOKit
+
+On Ubuntu, compile with...
+    cc -c -DTRACE=1 354trace.c
+...and then link with a main program by for example...
+    cc main.c 040pixel.o 354trace.o -lglfw -lGL -lm -ldl
+
+To see the pixel system's own spans, also compile 040pixel.c with -DTRACE=1, into its
+own object (cc -c -DTRACE=1 040pixel.c -o 040pixelTrace.o), and link that instead. The
+Vulkan demos include this header from ../P1 and link ../P1/354trace.o. */
+
+/* A trace program usually proceeds like this:
+    A. traceStart is called, to begin recording.
+    B. Spans are marked, either by TRACESCOPE at the top of a block, which ends
+       the span when the block is left, or by TRACEBEGIN and TRACEEND pairs.
+    C. The trace is written, by traceWrite (perhaps from a key handler) or
+       automatically when the program exits.
+Each thread records into its own ring buffer, without locks, so markers may be
+used from any thread. Each buffer holds the most recent 65536 spans; older
+spans are overwritten. Span names must be string literals (or must otherwise
+outlive the trace), because only the pointers are stored. */
+
+#ifndef TRACE
+#define TRACE 0
+#endif
+
+
+
+/*** Functions ***/
+
+/* Begins recording. When the program exits, the trace is written to the file
+at path, as it is by traceWrite. Returns an error code (0 on success). Call it
+outside of any marked span. */
+int traceStart(const char *path);
+
+/* Stops recording. Spans already recorded are kept, and can still be written.
+Call it outside of any marked span. */
+void traceStop(void);
+
+/* Writes every recorded span to the file named in traceStart, replacing that
+file. May be called any number of times, for example from a key handler.
+Returns an error code (0 on success). */
+int traceWrite(void);
+
+/* Opens a span with the given name on the calling thread. Spans nest. Usually
+you use TRACESCOPE or TRACEBEGIN instead of calling this function directly. */
+void traceBegin(const char *name);
+
+/* Closes the calling thread's innermost open span. */
+void traceEnd(void);
+
+/* Used by TRACESCOPE. Don't call it directly. */
+void traceEndScope(int *scope);
+
+/* Names the calling thread in the trace viewer. */
+void traceSetThreadName(const char *name);
+
+
+
+/*** Macros ***/
+
+#if TRACE
+#define tracePaste(a, b) a##b
+#define tracePasteExpanded(a, b) tracePaste(a, b)
+/* Marks a span from here to the end of the enclosing block, however the block
+is left. Use it as a statement of its own, for example
+    void render(void) {
+        TRACESCOPE("render");
+        ...
+    } */
+#define TRACESCOPE(name) traceBegin(name); \
+    int tracePasteExpanded(traceScope, __LINE__) \
+        __attribute__((cleanup(traceEndScope))) = 0
+#define TRACEBEGIN(name) traceBegin(name)
+#define TRACEEND() traceEnd()
+#define TRACESTART(path) traceStart(path)
+#define TRACESTOP() traceStop()
+#define TRACEWRITE() traceWrite()
+#define TRACETHREADNAME(name) traceSetThreadName(name)
+#else
+#define TRACESCOPE(name) ((void)0)
+#define TRACEBEGIN(name) ((void)0)
+#define TRACEEND() ((void)0)
+#define TRACESTART(path) ((void)0)
+#define TRACESTOP() ((void)0)
+#define TRACEWRITE() ((void)0)
+#define TRACETHREADNAME(name) ((void)0)
+#endif
@@ -0,0 +1,225 @@
+/*
+	355mainFormat.c
+	Compares the two framebuffer formats of the pixel system (see pixSetFormat in 040pixel.h) on the
+	landscape of 340mainLandscape.c. For each format, it renders the landscape a number of times,
+	reports the milliseconds per frame and the bytes that each upload to the screen would send, and
+	checks that the pixRGBA8 image matches the pixRGBFLOAT one to within rounding. Before it times
+	pixRGBA8, it shows the landscape slowly spinning in that format, where the uploads go through
+	pixel buffer objects. Close the window to finish.
+	Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+
+/* On macOS, compile with...
+    clang -O3 -c 040pixel.c -Wno-deprecated
+    clang -O3 355mainFormat.c 040pixel.o -lglfw -framework OpenGL -framework Cocoa -framework IOKit
+On Ubuntu, compile with...
+    cc -O3 -c 040pixel.c
+    cc -O3 355mainFormat.c 040pixel.o -lglfw -lGL -lm -ldl -lpthread
+*/
+
+#define WINDOWWIDTH 512.0
+#define WINDOWHEIGHT 512.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <GLFW/glfw3.h>
+#include <sys/time.h>
+
+#include "040pixel.h"
+
+#include "250vector.c"
+#include "280matrix.c"
+#include "150texture.c"
+#include "351shading.c"
+#include "260depth.c"
+#include "270triangle.c"
+#include "350kernel.c"
+#include "351mesh.c"
+#include "250mesh3D.c"
+#include "300isometry.c"
+#include "300camera.c"
+#include "340landscape.c"
+
+#define LANDSIZE 40
+#define FRAMENUM 100
+
+#define ATTRX 0
+#define ATTRY 1
+#define ATTRZ 2
+#define ATTRS 3
+#define ATTRT 4
+#define ATTRN 5
+#define ATTRO 6
+#define ATTRP 7
+#define VARYX 0
+#define VARYY 1
+#define VARYZ 2
+#define VARYW 3
+#define VARYS 4
+#define VARYT 5
+#define VARYN 6
+#define VARYO 7
+#define VARYP 8
+#define UNIFMODELING 0
+#define UNIFPROJINVISOM 16
+
+void shadeVertex(
+        int unifDim, const double unif[], int attrDim, const double attr[],
+        int varyDim, double vary[]) {
+	double attrHomog[4] = {attr[ATTRX], attr[ATTRY], attr[ATTRZ], 1.0};
+	double modHomog[4];
+	mat441Multiply((double(*)[4])(&unif[UNIFMODELING]), attrHomog, modHomog);
+	mat441Multiply((double(*)[4])(&unif[UNIFPROJINVISOM]), modHomog, vary);
+	vecCopy(5, &attr[ATTRS], &vary[VARYS]);
+}
+
+void shadeFragment(
+        int unifDim, const double unif[], int texNum, const texTexture *tex[],
+        int varyDim, const double vary[], double rgbd[4]) {
+	double sample[tex[0]->texelDim];
+	texSample(tex[0], vary[VARYS], vary[VARYT], sample);
+	sample[0] = sample[1] * 0.2 + 0.8;
+	sample[1] = sample[1] * 0.2 + 0.6;
+	sample[2] = 0.3;
+	double intensity = vary[VARYP] / vecLength(3, &vary[VARYN]);
+	vecScale(3, intensity, sample, rgbd);
+	rgbd[3] = vary[VARYZ];
+}
+
+depthBuffer buf;
+shaShading sha;
+texTexture texture;
+const texTexture *textures[1] = {&texture};
+meshMesh landMesh;
+double unif[16 + 16] = {
+	1.0, 0.0, 0.0, 0.0,
+	0.0, 1.0, 0.0, 0.0,
+	0.0, 0.0, 1.0, 0.0,
+	0.0, 0.0, 0.0, 1.0};
+double viewport[4][4];
+camCamera cam;
+double angle = M_PI * 0.25;
+
+/* Returns the current time in seconds. */
+double benchTime(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (double)tv.tv_sec + (double)tv.tv_usec * 0.000001;
+}
+
+void render(void) {
+	pixClearRGB(0.8, 0.8, 1.0);
+	depthClearDepths(&buf, 1000000000.0);
+	double position[3] = {-5.0, -5.0, 20.0};
+	camLookFrom(&cam, position, M_PI * 0.6, angle);
+	double projInvIsom[4][4];
+	camGetProjectionInverseIsometry(&cam, projInvIsom);
+	vecCopy(16, (double *)projInvIsom, &unif[UNIFPROJINVISOM]);
+	meshRender(&landMesh, &buf, viewport, &sha, unif, textures);
+}
+
+void handleTimeStep(double oldTime, double newTime) {
+	if (floor(newTime) - floor(oldTime) >= 1.0)
+		printf("handleTimeStep: %f frames/sec\n", 1.0 / (newTime - oldTime));
+	angle += (newTime - oldTime) * 0.1;
+	render();
+}
+
+/* Opens the window in the given format. If run is 1, then runs the user
+interface until the window is closed. Then renders FRAMENUM frames, and copies
+the last one into image. Returns
+the mean seconds per frame, or a negative number on error. */
+double benchFormat(int format, double *image, int run) {
+	pixSetFormat(format);
+	if (pixInitialize(WINDOWWIDTH, WINDOWHEIGHT, "Formats") != 0)
+		return -1.0;
+	if (run) {
+		pixSetTimeStepHandler(handleTimeStep);
+		pixRun();
+		angle = M_PI * 0.25;
+	}
+	double start = benchTime();
+	for (int i = 0; i < FRAMENUM; i += 1)
+		render();
+	double seconds = (benchTime() - start) / FRAMENUM;
+	pixCopyRGB(image);
+	pixFinalize();
+	return seconds;
+}
+
+int main(void) {
+	double landData[LANDSIZE * LANDSIZE];
+	landFlat(LANDSIZE, landData, 0.0);
+	srand(311);
+	for (int i = 0; i < 12; i += 1)
+		landFaultRandomly(LANDSIZE, landData, 1.0 - i * 0.04);
+	for (int i = 0; i < 4; i += 1)
+		landBlur(LANDSIZE, landData);
+	for (int i = 0; i < 4; i += 1)
+		landBump(LANDSIZE, landData, landInt(0, LANDSIZE - 1),
+			landInt(0, LANDSIZE - 1), 5.0, 1.0);
+	if (depthInitialize(&buf, WINDOWWIDTH, WINDOWHEIGHT) != 0)
+		return 1;
+	if (texInitializeFile(&texture, "awesome.png") != 0) {
+		depthFinalize(&buf);
+		return 2;
+	}
+	if (mesh3DInitializeLandscape(&landMesh, LANDSIZE, 1.0, landData) != 0) {
+		texFinalize(&texture);
+		depthFinalize(&buf);
+		return 3;
+	}
+	for (int i = 0; i < landMesh.vertNum; i += 1) {
+		double *vertPtr = meshGetVertexPointer(&landMesh, i);
+		vertPtr[ATTRS] = 0.0;
+		vertPtr[ATTRT] = vertPtr[ATTRZ];
+	}
+	double *imageFloat = malloc(WINDOWWIDTH * WINDOWHEIGHT * 3 * sizeof(double));
+	double *imageBytes = malloc(WINDOWWIDTH * WINDOWHEIGHT * 3 * sizeof(double));
+	if (imageFloat == NULL || imageBytes == NULL) {
+		fprintf(stderr, "error: main: malloc failed\n");
+		free(imageFloat);
+		free(imageBytes);
+		meshFinalize(&landMesh);
+		texFinalize(&texture);
+		depthFinalize(&buf);
+		return 4;
+	}
+	texSetFiltering(&texture, texNEAREST);
+	texSetLeftRight(&texture, texREPEAT);
+	texSetTopBottom(&texture, texREPEAT);
+	sha.unifDim = 16 + 16;
+	sha.attrDim = 3 + 2 + 3;
+	sha.varyDim = 4 + 2 + 3;
+	sha.shadeVertex = shadeVertex;
+	sha.shadeFragment = shadeFragment;
+	sha.shadeVertices = NULL;
+	sha.texNum = 1;
+	mat44Viewport(WINDOWWIDTH, WINDOWHEIGHT, viewport);
+	camSetProjectionType(&cam, camPERSPECTIVE);
+	camSetFrustum(&cam, M_PI / 6.0, 10.0, 10.0, WINDOWWIDTH, WINDOWHEIGHT);
+	/* Compare the formats, and then run the compact one. */
+	double floatTime = benchFormat(pixRGBFLOAT, imageFloat, 0);
+	double bytesTime = benchFormat(pixRGBA8, imageBytes, 1);
+	if (floatTime >= 0.0 && bytesTime >= 0.0) {
+		double maxDiff = 0.0;
+		for (int i = 0; i < WINDOWWIDTH * WINDOWHEIGHT * 3; i += 1) {
+			double clamped = fmin(fmax(imageFloat[i], 0.0), 1.0);
+			if (fabs(clamped - imageBytes[i]) > maxDiff)
+				maxDiff = fabs(clamped - imageBytes[i]);
+		}
+		printf("pixRGBFLOAT: %f ms/frame, %d bytes per upload\n",
+			floatTime * 1000.0, (int)(WINDOWWIDTH * WINDOWHEIGHT * 3 * sizeof(float)));
+		printf("pixRGBA8: %f ms/frame, %d bytes per upload\n",
+			bytesTime * 1000.0, (int)(WINDOWWIDTH * WINDOWHEIGHT * 4));
+		printf("max difference %f (rounding allows %f)\n", maxDiff, 0.5 / 255.0);
+	}
+	free(imageBytes);
+	free(imageFloat);
+	meshFinalize(&landMesh);
+	texFinalize(&texture);
+	depthFinalize(&buf);
+	return 0;
+}
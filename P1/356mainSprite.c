@@ -0,0 +1,114 @@
+/*
+	356mainSprite.c
+	A ball bouncing over a static background, to show the partial uploads of the pixel system (see
+	pixGetUploadedNum in 040pixel.h). Each frame repaints only the background under the ball's old
+	position and then the ball at its new position, so only those pixels are sent to the screen.
+	Once per second it prints how many pixels the last update sent. Press the space bar to switch to
+	repainting the whole window every frame, which sends every pixel, for comparison.
+	Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+
+/* On macOS, compile with...
+    clang -c 040pixel.c -Wno-deprecated
+    clang 356mainSprite.c 040pixel.o -lglfw -framework OpenGL -framework Cocoa -framework IOKit
+On Ubuntu, compile with...
+    cc -c 040pixel.c
+    cc 356mainSprite.c 040pixel.o -lglfw -lGL -lm -ldl -lpthread
+*/
+
+#define WINDOWWIDTH 512
+#define WINDOWHEIGHT 512
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <GLFW/glfw3.h>
+
+#include "040pixel.h"
+
+#define RADIUS 16
+
+double *background;
+double ballX = 100.0, ballY = 200.0;
+double ballVelX = 150.0, ballVelY = 110.0;
+int oldX = -1, oldY = -1;
+int repaintAll = 0;
+
+/* Fills the background with a checkerboard shaded by a gradient. */
+void makeBackground(void) {
+	int k = 0;
+	for (int j = 0; j < WINDOWHEIGHT; j += 1)
+		for (int i = 0; i < WINDOWWIDTH; i += 1) {
+			double shade = ((i / 32 + j / 32) % 2 == 0) ? 0.9 : 0.7;
+			background[k++] = shade * i / WINDOWWIDTH;
+			background[k++] = shade * j / WINDOWHEIGHT;
+			background[k++] = shade * 0.5;
+		}
+}
+
+/* Repaints the background in the square of side 2 * RADIUS + 1 centered on
+(x, y). */
+void eraseBall(int x, int y) {
+	int i = (x - RADIUS < 0) ? 0 : x - RADIUS;
+	for (int j = y - RADIUS; j <= y + RADIUS; j += 1)
+		if (0 <= j && j < WINDOWHEIGHT)
+			pixSetSpanRGB(i, j, x + RADIUS + 1 - i, &background[3 * (i + WINDOWWIDTH * j)]);
+}
+
+void drawBall(int x, int y) {
+	for (int j = -RADIUS; j <= RADIUS; j += 1)
+		for (int i = -RADIUS; i <= RADIUS; i += 1)
+			if (i * i + j * j <= RADIUS * RADIUS)
+				pixSetRGB(x + i, y + j, 1.0, 1.0 - (double)(j + RADIUS) / (4 * RADIUS), 0.2);
+}
+
+void handleKeyUp(
+        int key, int shiftIsDown, int controlIsDown, int altOptionIsDown,
+        int superCommandIsDown) {
+	if (key == GLFW_KEY_SPACE) {
+		repaintAll = 1 - repaintAll;
+		printf("handleKeyUp: repainting %s\n", repaintAll ? "everything" : "the ball only");
+	}
+}
+
+void handleTimeStep(double oldTime, double newTime) {
+	if (floor(newTime) - floor(oldTime) >= 1.0)
+		printf("handleTimeStep: %f frames/sec, %d of %d pixels uploaded\n",
+			1.0 / (newTime - oldTime), pixGetUploadedNum(), WINDOWWIDTH * WINDOWHEIGHT);
+	/* Bounce off of the edges of the window. */
+	ballX += ballVelX * (newTime - oldTime);
+	ballY += ballVelY * (newTime - oldTime);
+	if (ballX < RADIUS || ballX > WINDOWWIDTH - 1 - RADIUS)
+		ballVelX = -ballVelX;
+	if (ballY < RADIUS || ballY > WINDOWHEIGHT - 1 - RADIUS)
+		ballVelY = -ballVelY;
+	ballX = fmin(fmax(ballX, RADIUS), WINDOWWIDTH - 1 - RADIUS);
+	ballY = fmin(fmax(ballY, RADIUS), WINDOWHEIGHT - 1 - RADIUS);
+	if (repaintAll)
+		pixPasteRGB(background);
+	else
+		eraseBall(oldX, oldY);
+	oldX = (int)ballX;
+	oldY = (int)ballY;
+	drawBall(oldX, oldY);
+}
+
+int main(void) {
+	if (pixInitialize(WINDOWWIDTH, WINDOWHEIGHT, "Sprite") != 0)
+		return 1;
+	background = malloc(WINDOWWIDTH * WINDOWHEIGHT * 3 * sizeof(double));
+	if (background == NULL) {
+		fprintf(stderr, "error: main: malloc failed\n");
+		pixFinalize();
+		return 2;
+	}
+	makeBackground();
+	pixPasteRGB(background);
+	pixSetKeyUpHandler(handleKeyUp);
+	pixSetTimeStepHandler(handleTimeStep);
+	pixRun();
+	free(background);
+	pixFinalize();
+	return 0;
+}
@@ -0,0 +1,165 @@
+/*
+	361mainCoverage.c
+	Checks that the rasterizer covers every pixel of a landscape exactly once. The landscape mesh of
+	340mainLandscape.c is laid flat on the screen, as if seen from straight above, at several
+	positions, angles, and spacings, some of them chosen so that many edges pass exactly through pixels.
+	Seen this way, no two triangles overlap, so every pixel well inside the landscape should be shaded
+	exactly once. The fragment shader counts how many times each pixel is shaded, and the program
+	reports, for each placement, the pixels shaded more than once and the pixels inside the landscape
+	that were missed. It runs without a window. Set FIXEDPOINT to 0 below to check the floating-point
+	rasterizer of 270triangle.c instead of the fixed-point one of 361triangle.c, which shades the pixels
+	on shared edges twice.
+	Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+
+/* On macOS, compile with...
+    clang -c 040pixel.c -Wno-deprecated
+    clang 361mainCoverage.c 040pixel.o -lglfw -framework OpenGL -framework Cocoa -framework IOKit
+On Ubuntu, compile with...
+    cc -c 040pixel.c
+    cc 361mainCoverage.c 040pixel.o -lglfw -lGL -lm -ldl -lpthread
+*/
+
+#define WINDOWWIDTH 512.0
+#define WINDOWHEIGHT 512.0
+#define FIXEDPOINT 1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <GLFW/glfw3.h>
+
+#include "040pixel.h"
+
+#include "250vector.c"
+#include "280matrix.c"
+#include "150texture.c"
+#include "351shading.c"
+#include "260depth.c"
+#if FIXEDPOINT
+#include "361triangle.c"
+#else
+#include "270triangle.c"
+#endif
+#include "350kernel.c"
+#include "351mesh.c"
+#include "190mesh2D.c"
+#include "250mesh3D.c"
+#include "340landscape.c"
+
+#define LANDSIZE 40
+#define CASENUM 8
+
+#define VARYX 0
+#define VARYY 1
+
+depthBuffer buf;
+shaShading sha;
+meshMesh landMesh;
+int coverage[(int)WINDOWWIDTH * (int)WINDOWHEIGHT];
+
+/* Counts the pixel. The interpolated X and Y are the pixel's coordinates, up to
+rounding error. */
+void shadeFragment(
+        int unifDim, const double unif[], int texNum, const texTexture *tex[],
+        int varyDim, const double vary[], double rgbd[4]) {
+	int i = (int)floor(vary[VARYX] + 0.5);
+	int j = (int)floor(vary[VARYY] + 0.5);
+	if (0 <= i && i < WINDOWWIDTH && 0 <= j && j < WINDOWHEIGHT)
+		coverage[i + (int)WINDOWWIDTH * j] += 1;
+	vec3Set(0.5, 0.5, 0.5, rgbd);
+	rgbd[3] = 0.0;
+}
+
+/* Lays the landscape flat, rotated by angle and scaled so that neighboring
+vertices are spacing pixels apart, with vertex 0 at (x, y). Rasterizes it and
+checks the coverage. Returns the number of bad pixels. */
+int checkCoverage(double angle, double spacing, double x, double y) {
+	memset(coverage, 0, sizeof(coverage));
+	depthClearDepths(&buf, 1000000000.0);
+	double c = cos(angle), s = sin(angle);
+	double unif[1] = {0.0};
+	for (int t = 0; t < landMesh.triNum; t += 1) {
+		int *tri = meshGetTrianglePointer(&landMesh, t);
+		double vary[3][2];
+		for (int k = 0; k < 3; k += 1) {
+			double *vert = meshGetVertexPointer(&landMesh, tri[k]);
+			vary[k][VARYX] = x + spacing * (c * vert[0] - s * vert[1]);
+			vary[k][VARYY] = y + spacing * (s * vert[0] + c * vert[1]);
+		}
+		triRender(&sha, &buf, unif, NULL, vary[0], vary[1], vary[2]);
+	}
+	/* A pixel counts as inside if it is more than a pixel from the edge of the
+	landscape. */
+	double side = spacing * (LANDSIZE - 1);
+	int overlapNum = 0, gapNum = 0, insideNum = 0;
+	for (int j = 0; j < WINDOWHEIGHT; j += 1)
+		for (int i = 0; i < WINDOWWIDTH; i += 1) {
+			double u = c * (i - x) + s * (j - y);
+			double w = -s * (i - x) + c * (j - y);
+			int count = coverage[i + (int)WINDOWWIDTH * j];
+			if (count >= 2)
+				overlapNum += 1;
+			if (1.0 < u && u < side - 1.0 && 1.0 < w && w < side - 1.0) {
+				insideNum += 1;
+				if (count == 0)
+					gapNum += 1;
+			}
+		}
+	printf("checkCoverage: angle %f, spacing %f, origin (%f, %f): ", angle,
+		spacing, x, y);
+	printf("%d of %d inside pixels missed, %d pixels shaded more than once\n",
+		gapNum, insideNum, overlapNum);
+	return gapNum + overlapNum;
+}
+
+int main(void) {
+	/* The same landscape every time. Only its diagonals matter here. */
+	double landData[LANDSIZE * LANDSIZE];
+	landFlat(LANDSIZE, landData, 0.0);
+	srand(311);
+	for (int i = 0; i < 12; i += 1)
+		landFaultRandomly(LANDSIZE, landData, 1.0 - i * 0.04);
+	pixSetHeadless(1);
+	if (pixInitialize(WINDOWWIDTH, WINDOWHEIGHT, "Coverage") != 0)
+		return 1;
+	if (depthInitialize(&buf, WINDOWWIDTH, WINDOWHEIGHT) != 0) {
+		pixFinalize();
+		return 2;
+	}
+	if (mesh3DInitializeLandscape(&landMesh, LANDSIZE, 1.0, landData) != 0) {
+		depthFinalize(&buf);
+		pixFinalize();
+		return 3;
+	}
+	sha.unifDim = 1;
+	sha.attrDim = 3 + 2 + 3;
+	sha.varyDim = 2;
+	sha.shadeVertex = NULL;
+	sha.shadeFragment = shadeFragment;
+	sha.shadeVertices = NULL;
+	sha.texNum = 0;
+	/* The first two placements put every vertex on a pixel, so that many edges
+	pass exactly through pixels. The rest are arbitrary. */
+	double cases[CASENUM][4] = {
+		{0.0, 8.0, 64.0, 64.0},
+		{M_PI / 4.0, 8.0 * sqrt(2.0), 256.0, 20.0},
+		{0.0, 7.5, 50.25, 60.75},
+		{0.3, 9.3, 200.0, 30.0},
+		{1.0, 6.1, 300.5, 10.2},
+		{2.5, 11.0, 400.0, 300.0},
+		{-0.7, 4.05, 100.3, 300.7},
+		{M_PI / 2.0, 12.5, 500.0, 8.0}};
+	int badNum = 0;
+	for (int k = 0; k < CASENUM; k += 1)
+		badNum += checkCoverage(cases[k][0], cases[k][1], cases[k][2],
+			cases[k][3]);
+	printf("main: %s, %d bad pixels in all\n",
+		FIXEDPOINT ? "361triangle.c" : "270triangle.c", badNum);
+	meshFinalize(&landMesh);
+	depthFinalize(&buf);
+	pixFinalize();
+	return (badNum == 0) ? 0 : 4;
+}
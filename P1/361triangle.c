@@ -0,0 +1,177 @@
+/*
+    361triangle.c
+    C file to rasterize a given triangle and render it. triRender and its subcalls interpolate the varyings passed into it, then invoke sha->shadeFragment for a fragment color and depth (after any number and type of artistic transformations). Only set pixel if fragment is
+    the closest fragment to screen so far.
+    Differs from 270triangle.c by rasterizing in fixed point. The vertices are snapped to a grid of 1 / 256 of a pixel, and each
+    pixel is tested against the three edge functions of the triangle, which are stepped with integer additions. A pixel that lies
+    exactly on an edge belongs to the triangle only if that edge is a top or left edge (the 'top-left rule'), so a pixel on an edge
+    shared by two triangles is drawn by exactly one of them. In 270triangle.c, such a pixel is drawn by both.
+    Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+/* Vertices are snapped to multiples of 1 / triSUBPIXELS of a pixel. */
+#define triSUBPIXELBITS 8
+#define triSUBPIXELS (1 << triSUBPIXELBITS)
+/* Triangles reaching farther than this many pixels from the origin are not drawn, because their edge functions could
+overflow. The window is much smaller than this guard band, so in practice only triangles that graze the near plane are lost. */
+#define triGUARDBAND 524288.0
+
+void createA(const double a[], const double b[], const double c[], double m[2][2]) {
+    double bMinusA[2];
+    double cMinusA[2];
+    vecSubtract(2, b, a, bMinusA);
+    vecSubtract(2, c, a, cMinusA);
+    mat22Columns(bMinusA, cMinusA, m);
+}
+
+/* Unlike in 270triangle.c, x is always inside the depth buffer, because triRenderHelper() only visits pixels in it. */
+void setPixel(
+    const shaShading *sha, depthBuffer *buf, const double unif[], const texTexture *tex[], const double x[2],
+    const double a[], const double invertedItpCoeffs[2][2],
+    const double bMinusA[], const double cMinusA[]) {
+    // variables which depend on the position of x, and therefore need to be calculated every time
+    // setPixel() is called.
+    double xMinusA[2];
+    double pq[2];
+    double pBetaMinusAlpha[sha->varyDim]; // represents p(b - a)
+    double qGammaMinusAlpha[sha->varyDim]; // represents q(c - a)
+    double pBetaMinusAlphaPlusqGammaMinusAlpha[sha->varyDim]; // represents pBetaMinusAlpha + qGammaMinusAlpha = p(b - a) + q(c - a)
+    double chi[sha->varyDim];  // interpolated varyings vector for x
+    double rgbd[4]; // rgbd for sha->shadeFragment
+
+    // computes p and q.
+    vecSubtract(2, x, a, xMinusA);
+    mat221Multiply(invertedItpCoeffs, xMinusA, pq);
+
+    // linearly interpolates the texture coordinate at current pixel.
+    vecScale(sha->varyDim, pq[0], bMinusA, pBetaMinusAlpha);
+    vecScale(sha->varyDim, pq[1], cMinusA, qGammaMinusAlpha);
+    vecAdd(sha->varyDim, pBetaMinusAlpha, qGammaMinusAlpha, pBetaMinusAlphaPlusqGammaMinusAlpha);
+    vecAdd(sha->varyDim, a, pBetaMinusAlphaPlusqGammaMinusAlpha, chi);
+
+    // initializes rgb to 'white' and calls sha->shadeFragment to get final rgb values.
+    // Writes new values to rgb.
+    vec3Set(1.0, 1.0, 1.0, rgbd);
+    sha->shadeFragment(sha->unifDim, unif, sha->texNum, tex, sha->varyDim, chi, rgbd);
+
+    // checks if pixel should be rendered by comparing depth value from shadeFragment to depth value
+    // currently stored at the pixel.
+    double currDepth = depthGetDepth(buf, x[0], x[1]);
+    if (currDepth > rgbd[3]) {
+        depthSetDepth(buf, x[0], x[1], rgbd[3]);
+        // sets the pixel to the color calculated by sha->shadeFragment.
+        pixSetRGB((int)x[0], (int)x[1], rgbd[0], rgbd[1], rgbd[2]);
+    }
+}
+
+/* Returns 1 if the edge from p to q, in snapped coordinates, is a top edge or a left edge of a counterclockwise
+triangle, and 0 otherwise. Going counterclockwise, a left edge runs downward, and a top edge runs horizontally to the
+left. */
+int triIsTopLeft(const long long p[2], const long long q[2]) {
+    return (q[1] < p[1]) || (q[1] == p[1] && q[0] < p[0]);
+}
+
+/* Rasterizes the triangle and renders it. Assumes that the 0th and 1th elements of a, b, c are the 'x' and 'y'
+coordinates of the vertices, respectively (used in rasterization, and to interpolate the other elements of a, b, c).
+The vertices may come in any order. */
+void triRenderHelper(
+        const shaShading *sha, depthBuffer *buf, const double unif[], const texTexture *tex[],
+        const double a[], const double b[], const double c[]) {
+    // snaps the vertices to the subpixel grid.
+    const double *verts[3] = {a, b, c};
+    long long v[3][2];
+    for (int k = 0; k < 3; k += 1)
+        for (int i = 0; i < 2; i += 1) {
+            if (fabs(verts[k][i]) > triGUARDBAND)
+                return;
+            v[k][i] = llround(verts[k][i] * triSUBPIXELS);
+        }
+
+    // twice the signed area, in square subpixels. Implements backface culling: if it is negative or zero, the
+    // triangle does not render. Because it is exact, triangles that snapping has made degenerate are culled too.
+    long long area = (v[1][0] - v[0][0]) * (v[2][1] - v[0][1]) - (v[1][1] - v[0][1]) * (v[2][0] - v[0][0]);
+    if (area <= 0)
+        return;
+
+    // creates the matrix A (to find p and q for the purposes of linear interpolation) and inverts it. The
+    // interpolation uses the unsnapped vertices, as in 270triangle.c.
+    double interpolateCoeffs[2][2];
+    double invertedItpCoeffs[2][2];
+    createA(a, b, c, interpolateCoeffs);
+    if (mat22Invert(interpolateCoeffs, invertedItpCoeffs) <= 0)
+        return;
+
+    // computes 'b - a' and 'c - a', used later in linear interpolation calculations.
+    double bMinusA[sha->varyDim];
+    double cMinusA[sha->varyDim];
+    vecSubtract(sha->varyDim, b, a, bMinusA);
+    vecSubtract(sha->varyDim, c, a, cMinusA);
+
+    // finds the pixels in the bounding box of the snapped triangle, clipped to the depth buffer. Pixel (i, j) is
+    // sampled at the point (i, j), as in 270triangle.c.
+    long long minX = v[0][0], maxX = v[0][0], minY = v[0][1], maxY = v[0][1];
+    for (int k = 1; k < 3; k += 1) {
+        minX = (v[k][0] < minX) ? v[k][0] : minX;
+        maxX = (v[k][0] > maxX) ? v[k][0] : maxX;
+        minY = (v[k][1] < minY) ? v[k][1] : minY;
+        maxY = (v[k][1] > maxY) ? v[k][1] : maxY;
+    }
+    int iMin = (int)ceil((double)minX / triSUBPIXELS);
+    int iMax = (int)floor((double)maxX / triSUBPIXELS);
+    int jMin = (int)ceil((double)minY / triSUBPIXELS);
+    int jMax = (int)floor((double)maxY / triSUBPIXELS);
+    iMin = (iMin < 0) ? 0 : iMin;
+    jMin = (jMin < 0) ? 0 : jMin;
+    iMax = (iMax > buf->width - 1) ? buf->width - 1 : iMax;
+    jMax = (jMax > buf->height - 1) ? buf->height - 1 : jMax;
+    if (iMin > iMax || jMin > jMax)
+        return;
+
+    // sets up the edge function of each edge, from v[k] to v[k + 1], at pixel (iMin, jMin). It is positive inside
+    // the triangle. On edges that aren't top or left, it is biased down by 1, so that a pixel exactly on such an
+    // edge tests as outside. Moving one pixel right or up changes it by a constant step.
+    long long edge[3], stepI[3], stepJ[3];
+    for (int k = 0; k < 3; k += 1) {
+        const long long *p = v[k], *q = v[(k + 1) % 3];
+        long long dx = q[0] - p[0], dy = q[1] - p[1];
+        edge[k] = dx * ((long long)jMin * triSUBPIXELS - p[1]) - dy * ((long long)iMin * triSUBPIXELS - p[0]);
+        if (!triIsTopLeft(p, q))
+            edge[k] -= 1;
+        stepI[k] = -dy * triSUBPIXELS;
+        stepJ[k] = dx * triSUBPIXELS;
+    }
+
+    // now, we render the triangle, a row at a time. a pixel is inside when all three edge functions are
+    // nonnegative, which is when their bitwise OR is. since the triangle is convex, once a row has entered and left
+    // it, the rest of the row is outside.
+    double x[2];
+    for (int j = jMin; j <= jMax; j += 1) {
+        long long e0 = edge[0], e1 = edge[1], e2 = edge[2];
+        int entered = 0;
+        x[1] = j;
+        for (int i = iMin; i <= iMax; i += 1) {
+            if ((e0 | e1 | e2) >= 0) {
+                x[0] = i;
+                setPixel(sha, buf, unif, tex, x, a, invertedItpCoeffs, bMinusA, cMinusA);
+                entered = 1;
+            } else if (entered)
+                break;
+            e0 += stepI[0];
+            e1 += stepI[1];
+            e2 += stepI[2];
+        }
+        edge[0] += stepJ[0];
+        edge[1] += stepJ[1];
+        edge[2] += stepJ[2];
+    }
+}
+
+/* Assumes that the 0th and 1th elements of a, b, c are the 'x' and 'y' coordinates of the vertices,
+respectively (used in rasterization, and to interpolate the other elements of a, b, c). */
+/* Backface culling check performed in triRenderHelper(); unlike in 270triangle.c, there's no need to find the left-most
+vertex first. */
+void triRender(
+        const shaShading *sha, depthBuffer *buf, const double unif[], const texTexture *tex[],
+        const double a[], const double b[], const double c[]) {
+    triRenderHelper(sha, buf, unif, tex, a, b, c);
+}
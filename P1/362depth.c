@@ -0,0 +1,113 @@
+/*
+    362depth.c
+    C file defining a depth buffer and providing methods for interaction.
+    Differs from 260depth.c by storing floats rather than doubles, which halves the memory traffic of the depth test,
+    and by adding depthTestGroup, which tests and writes the depths of a whole group of fragments (see 362shading.c) at
+    once. With AVX2, it does so in a single 8-lane register.
+    Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/*** Creating and destroying (once per program?) ***/
+
+/* Feel free to read the struct's members, but don't write them, except through
+the accessors below such as depthSetDepth, etc. */
+typedef struct depthBuffer depthBuffer;
+struct depthBuffer {
+	int width, height;
+	float *depths;			/* width * height floats */
+};
+
+/* Initializes a depth buffer. When you are finished with the buffer, you must
+call depthFinalize to deallocate its backing resources. */
+int depthInitialize(depthBuffer *buf, int width, int height) {
+	buf->depths = (float *)malloc(width * height * sizeof(float));
+	if (buf->depths != NULL) {
+		buf->width = width;
+		buf->height = height;
+	}
+	return (buf->depths == NULL);
+}
+
+/* Deallocates the resources backing the buffer. This function must be called
+when you are finished using a buffer. */
+void depthFinalize(depthBuffer *buf) {
+	free(buf->depths);
+}
+
+
+
+/*** Regular use (on each frame) ***/
+
+/* Sets every depth-value to the given depth. Typically you use this function
+at the start of each frame, passing a large positive value for depth. */
+void depthClearDepths(depthBuffer *buf, double depth) {
+	int n = buf->width * buf->height;
+	for (int k = 0; k < n; k += 1)
+		buf->depths[k] = (float)depth;
+}
+
+/* Sets the depth-value at pixel (i, j) to the given depth. */
+void depthSetDepth(depthBuffer *buf, int i, int j, double depth) {
+	if (0 <= i && i < buf->width && 0 <= j && j < buf->height)
+		buf->depths[i + buf->width * j] = (float)depth;
+}
+
+/* Returns the depth-value at pixel (i, j). */
+double depthGetDepth(const depthBuffer *buf, int i, int j) {
+	if (0 <= i && i < buf->width && 0 <= j && j < buf->height)
+		return buf->depths[i + buf->width * j];
+	else
+		/* There's no right answer, but we have to return something. */
+		return 0.0;
+}
+
+/* Depth-tests the group of fragments whose lower left pixel is (i, j), laid out
+as in 362shading.c. depths holds one depth per lane. Only the lanes whose bits
+are set in mask take part, and each of their pixels must be in the buffer. A
+lane passes if its depth is less than the one stored, in which case its depth
+is stored. Returns the mask of the lanes that passed. */
+int depthTestGroup(depthBuffer *buf, int i, int j, int mask,
+		const double depths[shaGROUPSIZE]) {
+	float *row0 = &buf->depths[i + buf->width * j];
+	float *row1 = row0 + buf->width;
+#ifdef __AVX2__
+	/* Masked loads and stores never touch the lanes that are off, so they are
+	safe even where the group hangs over the edge of the buffer. */
+	__m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+	__m256i on = _mm256_cmpeq_epi32(
+		_mm256_and_si256(_mm256_set1_epi32(mask), bits), bits);
+	__m128i on0 = _mm256_castsi256_si128(on);
+	__m128i on1 = _mm256_extracti128_si256(on, 1);
+	__m128 old0 = _mm_maskload_ps(row0, on0);
+	__m128 old1 = _mm_maskload_ps(row1, on1);
+	__m256 old = _mm256_set_m128(old1, old0);
+	__m256 new = _mm256_set_m128(
+		_mm256_cvtpd_ps(_mm256_loadu_pd(&depths[4])),
+		_mm256_cvtpd_ps(_mm256_loadu_pd(&depths[0])));
+	__m256 pass = _mm256_and_ps(_mm256_cmp_ps(new, old, _CMP_LT_OQ),
+		_mm256_castsi256_ps(on));
+	__m256i passI = _mm256_castps_si256(pass);
+	_mm_maskstore_ps(row0, _mm256_castsi256_si128(passI),
+		_mm256_castps256_ps128(new));
+	_mm_maskstore_ps(row1, _mm256_extracti128_si256(passI, 1),
+		_mm256_extractf128_ps(new, 1));
+	return _mm256_movemask_ps(pass);
+#else
+	int passMask = 0;
+	for (int l = 0; l < shaGROUPSIZE; l += 1)
+		if (mask & (1 << l)) {
+			float *old = (shaLANEY(l) == 0) ? &row0[shaLANEX(l)] :
+				&row1[shaLANEX(l)];
+			float new = (float)depths[l];
+			if (new < *old) {
+				*old = new;
+				passMask |= 1 << l;
+			}
+		}
+	return passMask;
+#endif
+}
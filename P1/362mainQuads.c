@@ -0,0 +1,319 @@
+/*
+	362mainQuads.c
+	Times the group rasterizer of 362triangle.c on the landscape of 340mainLandscape.c. The landscape's
+	fragment shader gets a group version, shadeFragmentsLand, that samples the texture once per covered
+	fragment and then lights all eight fragments of the group in plain loops over the lanes, which the
+	compiler turns into vector instructions. Whole frames are timed with the default adapter, which calls
+	shadeFragmentLand once per fragment, and with the group shader, in alternating rounds, and the median
+	rounds are reported. The two images are compared.
+	Then the landscape is shown as in 340mainLandscape.c.
+	Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+
+/* On macOS (Intel), compile with...
+    clang -O3 -c 040pixel.c -Wno-deprecated
+    clang -O3 -mavx2 362mainQuads.c 040pixel.o -lglfw -framework OpenGL -framework Cocoa -framework IOKit
+On Ubuntu, compile with...
+    cc -O3 -c 040pixel.c
+    cc -O3 -mavx2 362mainQuads.c 040pixel.o -lglfw -lGL -lm -ldl -lpthread
+Without -mavx2 (for example on Apple silicon), depthTestGroup in 362depth.c falls
+back to a scalar loop, and the compiler vectorizes the loops over the lanes with
+whatever the machine has.
+*/
+
+#define WINDOWWIDTH 512.0
+#define WINDOWHEIGHT 512.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <GLFW/glfw3.h>
+#include <sys/time.h>
+
+#include "040pixel.h"
+
+#include "250vector.c"
+#include "280matrix.c"
+#include "150texture.c"
+#include "362shading.c"
+#include "362depth.c"
+#include "362triangle.c"
+#include "350kernel.c"
+#include "351mesh.c"
+#include "250mesh3D.c"
+#include "300isometry.c"
+#include "300camera.c"
+#include "340landscape.c"
+
+#define LANDSIZE 40
+#define FRAMENUM 20
+#define ROUNDNUM 9
+
+#define ATTRX 0
+#define ATTRY 1
+#define ATTRZ 2
+#define ATTRS 3
+#define ATTRT 4
+#define ATTRN 5
+#define ATTRO 6
+#define ATTRP 7
+#define VARYX 0
+#define VARYY 1
+#define VARYZ 2
+#define VARYW 3
+#define VARYS 4
+#define VARYT 5
+#define VARYN 6
+#define VARYO 7
+#define VARYP 8
+#define UNIFMODELING 0
+#define UNIFPROJINVISOM 16
+
+/* The first four entries of vary are assumed to be X, Y, Z, W. */
+void shadeVertexLand(
+        int unifDim, const double unif[], int attrDim, const double attr[],
+        int varyDim, double vary[]) {
+	double attrHomog[4] = {attr[ATTRX], attr[ATTRY], attr[ATTRZ], 1.0};
+	double modHomog[4];
+	mat441Multiply((double(*)[4])(&unif[UNIFMODELING]), attrHomog, modHomog);
+	mat441Multiply((double(*)[4])(&unif[UNIFPROJINVISOM]), modHomog, vary);
+	vecCopy(5, &attr[ATTRS], &vary[VARYS]);
+}
+
+/* The per-fragment shader, exactly as in 340mainLandscape.c. */
+void shadeFragmentLand(
+        int unifDim, const double unif[], int texNum, const texTexture *tex[],
+        int varyDim, const double vary[], double rgbd[4]) {
+	double sample[tex[0]->texelDim];
+	texSample(tex[0], vary[VARYS], vary[VARYT], sample);
+	sample[0] = sample[1] * 0.2 + 0.8;
+	sample[1] = sample[1] * 0.2 + 0.6;
+	sample[2] = 0.3;
+	double intensity = vary[VARYP] / vecLength(3, &vary[VARYN]);
+	vecScale(3, intensity, sample, rgbd);
+	rgbd[3] = vary[VARYZ];
+}
+
+/* The group shader. Computes the same colors as shadeFragmentLand, up to
+rounding. The texture has no mipmaps, so dVary goes unused. */
+void shadeFragmentsLand(
+        int unifDim, const double unif[], int texNum, const texTexture *tex[],
+        int varyDim, const double vary[], const double dVary[], int mask,
+        double rgbd[]) {
+	const int n = shaGROUPSIZE;
+	/* Texture sampling doesn't vectorize, so do it only where it's needed. */
+	double green[shaGROUPSIZE] = {0.0};
+	double sample[tex[0]->texelDim];
+	for (int l = 0; l < n; l += 1)
+		if (mask & (1 << l)) {
+			texSample(tex[0], vary[VARYS * n + l], vary[VARYT * n + l], sample);
+			green[l] = sample[1];
+		}
+	/* The rest is the same arithmetic in every lane. */
+	for (int l = 0; l < n; l += 1) {
+		double nx = vary[VARYN * n + l], ny = vary[VARYO * n + l];
+		double nz = vary[VARYP * n + l];
+		double intensity = nz / sqrt(nx * nx + ny * ny + nz * nz);
+		rgbd[l] = intensity * (green[l] * 0.2 + 0.8);
+		rgbd[n + l] = intensity * (green[l] * 0.2 + 0.6);
+		rgbd[2 * n + l] = intensity * 0.3;
+		rgbd[3 * n + l] = vary[VARYZ * n + l];
+	}
+}
+
+depthBuffer buf;
+shaShading sha;
+texTexture texture;
+const texTexture *textures[1] = {&texture};
+meshMesh landMesh;
+double unif[16 + 16] = {
+	1.0, 0.0, 0.0, 0.0,
+	0.0, 1.0, 0.0, 0.0,
+	0.0, 0.0, 1.0, 0.0,
+	0.0, 0.0, 0.0, 1.0};
+double viewport[4][4];
+camCamera cam;
+double angle = M_PI * 0.25;
+
+/* Returns the current time in seconds. */
+double benchTime(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (double)tv.tv_sec + (double)tv.tv_usec * 0.000001;
+}
+
+/* Builds a landscape mesh from a fixed seed, as 340mainLandscape.c does from a
+random one. Returns an error code (0 on success). */
+int initializeLandscape(meshMesh *mesh, int size) {
+	double *landData = (double *)malloc(size * size * sizeof(double));
+	if (landData == NULL)
+		return 2;
+	landFlat(size, landData, 0.0);
+	srand(311);
+	for (int i = 0; i < 12; i += 1)
+		landFaultRandomly(size, landData, 1.0 - i * 0.04);
+	for (int i = 0; i < 4; i += 1)
+		landBlur(size, landData);
+	for (int i = 0; i < 4; i += 1)
+		landBump(size, landData, landInt(0, size - 1), landInt(0, size - 1),
+			5.0, 1.0);
+	int error = mesh3DInitializeLandscape(mesh, size, 1.0, landData);
+	free(landData);
+	if (error != 0)
+		return 1;
+	for (int i = 0; i < mesh->vertNum; i += 1) {
+		double *vertPtr = meshGetVertexPointer(mesh, i);
+		vertPtr[ATTRS] = 0.0;
+		vertPtr[ATTRT] = vertPtr[ATTRZ];
+	}
+	return 0;
+}
+
+void render(void) {
+	pixClearRGB(0.8, 0.8, 1.0);
+	depthClearDepths(&buf, 1000000000.0);
+	double projInvIsom[4][4];
+	camGetProjectionInverseIsometry(&cam, projInvIsom);
+	vecCopy(16, (double *)projInvIsom, &unif[UNIFPROJINVISOM]);
+	meshRender(&landMesh, &buf, viewport, &sha, unif, textures);
+}
+
+/* Times whole frames, with or without the group shader, and leaves the last
+frame's image in rgb. Returns the mean seconds per frame. */
+double benchFrames(void (*shadeFragments)(int, const double[], int,
+		const texTexture *[], int, const double[], const double[], int,
+		double[]), double *rgb) {
+	sha.shadeFragments = shadeFragments;
+	render();
+	double start = benchTime();
+	for (int i = 0; i < FRAMENUM; i += 1)
+		render();
+	double frameTime = (benchTime() - start) / FRAMENUM;
+	pixCopyRGB(rgb);
+	return frameTime;
+}
+
+/* Sorts the n times and returns the middle one. */
+double benchMedian(int n, double times[]) {
+	for (int i = 1; i < n; i += 1)
+		for (int k = i; k > 0 && times[k - 1] > times[k]; k -= 1) {
+			double t = times[k];
+			times[k] = times[k - 1];
+			times[k - 1] = t;
+		}
+	return times[n / 2];
+}
+
+void handleKeyDownAndRepeat(
+        int key, int shiftIsDown, int controlIsDown, int altOptionIsDown,
+        int superCommandIsDown) {
+	double position[3];
+	vecCopy(3, cam.isometry.translation, position);
+	if (key == GLFW_KEY_W) {
+		double delta[3] = {cos(angle), sin(angle), 0.0};
+		vecAdd(3, position, delta, position);
+	} else if (key == GLFW_KEY_S) {
+		double delta[3] = {cos(angle), sin(angle), 0.0};
+		vecSubtract(3, position, delta, position);
+	} else if (key == GLFW_KEY_A)
+		angle += M_PI / 12.0;
+	else if (key == GLFW_KEY_D)
+		angle -= M_PI / 12.0;
+	else if (key == GLFW_KEY_Q)
+		position[2] -= 1.0;
+	else if (key == GLFW_KEY_E)
+		position[2] += 1.0;
+	camLookFrom(&cam, position, M_PI * 0.6, angle);
+}
+
+void handleTimeStep(double oldTime, double newTime) {
+	if (floor(newTime) - floor(oldTime) >= 1.0)
+		printf("handleTimeStep: %f frames/sec\n", 1.0 / (newTime - oldTime));
+	render();
+}
+
+int main(void) {
+	if (pixInitialize(WINDOWWIDTH, WINDOWHEIGHT, "Quads") != 0)
+		return 1;
+	if (depthInitialize(&buf, WINDOWWIDTH, WINDOWHEIGHT) != 0) {
+		pixFinalize();
+		return 2;
+	}
+	if (texInitializeFile(&texture, "awesome.png") != 0) {
+		depthFinalize(&buf);
+		pixFinalize();
+		return 3;
+	}
+	if (initializeLandscape(&landMesh, LANDSIZE) != 0) {
+		texFinalize(&texture);
+		depthFinalize(&buf);
+		pixFinalize();
+		return 4;
+	}
+	int rgbNum = (int)WINDOWWIDTH * (int)WINDOWHEIGHT * 3;
+	double *rgbAdapted = (double *)malloc(rgbNum * sizeof(double));
+	double *rgbGroup = (double *)malloc(rgbNum * sizeof(double));
+	if (rgbAdapted == NULL || rgbGroup == NULL) {
+		fprintf(stderr, "error: main: malloc failed\n");
+		free(rgbAdapted);
+		free(rgbGroup);
+		meshFinalize(&landMesh);
+		texFinalize(&texture);
+		depthFinalize(&buf);
+		pixFinalize();
+		return 5;
+	}
+	texSetFiltering(&texture, texNEAREST);
+	texSetLeftRight(&texture, texREPEAT);
+	texSetTopBottom(&texture, texREPEAT);
+	sha.unifDim = 16 + 16;
+	sha.attrDim = 3 + 2 + 3;
+	sha.varyDim = 4 + 2 + 3;
+	sha.shadeVertex = shadeVertexLand;
+	sha.shadeFragment = shadeFragmentLand;
+	sha.shadeVertices = NULL;
+	sha.shadeFragments = NULL;
+	sha.texNum = 1;
+	mat44Viewport(WINDOWWIDTH, WINDOWHEIGHT, viewport);
+	camSetProjectionType(&cam, camPERSPECTIVE);
+	camSetFrustum(&cam, M_PI / 6.0, 10.0, 10.0, WINDOWWIDTH, WINDOWHEIGHT);
+	double position[3] = {-5.0, -5.0, 20.0};
+	camLookFrom(&cam, position, M_PI * 0.6, angle);
+#ifdef __AVX2__
+	printf("depthTestGroup: using AVX2\n");
+#else
+	printf("depthTestGroup: using the scalar fallback\n");
+#endif
+	/* Whole frames, both ways. The two alternate, round after round, so that
+	a slow stretch of the machine hits both, and the medians are compared. */
+	double adaptedFrames[ROUNDNUM], groupFrames[ROUNDNUM];
+	for (int k = 0; k < ROUNDNUM; k += 1) {
+		adaptedFrames[k] = benchFrames(NULL, rgbAdapted);
+		groupFrames[k] = benchFrames(shadeFragmentsLand, rgbGroup);
+	}
+	double adaptedFrame = benchMedian(ROUNDNUM, adaptedFrames);
+	double groupFrame = benchMedian(ROUNDNUM, groupFrames);
+	double maxDiff = 0.0;
+	for (int i = 0; i < rgbNum; i += 1)
+		if (fabs(rgbAdapted[i] - rgbGroup[i]) > maxDiff)
+			maxDiff = fabs(rgbAdapted[i] - rgbGroup[i]);
+	printf("frames (median of %d rounds): adapted %f ms/frame, ", ROUNDNUM,
+		adaptedFrame * 1000.0);
+	printf("group %f ms/frame, speedup %fx, ",
+		groupFrame * 1000.0, adaptedFrame / groupFrame);
+	printf("max difference %g\n", maxDiff);
+	free(rgbGroup);
+	free(rgbAdapted);
+	/* Run user interface. */
+	pixSetKeyDownHandler(handleKeyDownAndRepeat);
+	pixSetKeyRepeatHandler(handleKeyDownAndRepeat);
+	pixSetTimeStepHandler(handleTimeStep);
+	pixRun();
+	/* Clean up. */
+	meshFinalize(&landMesh);
+	texFinalize(&texture);
+	depthFinalize(&buf);
+	pixFinalize();
+	return 0;
+}
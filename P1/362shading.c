@@ -0,0 +1,88 @@
+/*
+    362shading.c
+    Creates the shaShading struct for storing information about uniform, attribute, texture, and varyings arrays.
+    Differs from 351shading.c by adding an optional group fragment shader, shadeFragments, which
+    shades a group of shaGROUPSIZE neighboring fragments in one call, as the rasterizer of
+    362triangle.c produces them. Leave it NULL if you don't have one; shaShadeFragments then falls
+    back to calling shadeFragment once per covered fragment.
+
+    Written by Cole Weinstein and Robbie Young for Carleton College's
+    CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+/* A group is a 4 x 2 block of pixels, made of two 2 x 2 quads side by side. Its
+lower left pixel has even coordinates (i, j). Lane l of the group is the pixel
+(i + shaLANEX(l), j + shaLANEY(l)), so lanes 0 to 3 are the bottom row and 4 to
+7 are the top row. The left quad is lanes 0, 1, 4, 5. */
+#define shaGROUPSIZE 8
+#define shaLANEX(l) ((l) & 3)
+#define shaLANEY(l) ((l) >> 2)
+
+typedef struct shaShading shaShading;
+
+struct shaShading {
+    int unifDim;
+    int attrDim;
+    int texNum;
+    int varyDim;
+    void (*shadeVertex)(int, const double[], int, const double[], int, double[]);
+    void (*shadeFragment)(int, const double[], int, const texTexture *[], int, const double[], double[4]);
+    /* Optional. Arguments are unifDim, unif, vertNum, attrDim, attr, varyDim,
+    vary. attr holds vertNum * attrDim doubles, packed vertex after vertex as in
+    meshMesh, and vary receives vertNum * varyDim doubles packed the same way. */
+    void (*shadeVertices)(int, const double[], int, int, const double[], int, double[]);
+    /* Optional. Arguments are unifDim, unif, texNum, tex, varyDim, vary,
+    dVary, mask, rgbd. vary holds varyDim * shaGROUPSIZE doubles, one varying
+    at a time, so that vary[v * shaGROUPSIZE + l] is varying v in lane l. dVary
+    holds the rates of change of the varyings, per pixel, first to the right
+    (varyDim doubles) and then upward (varyDim more). They are the differences
+    across each quad, which is what texture level-of-detail selection needs. Bit
+    l of mask is set if lane l is inside the triangle. The other lanes hold
+    varyings extrapolated from the triangle, so they are safe to shade, but
+    their results are thrown away. rgbd receives 4 * shaGROUPSIZE doubles, laid
+    out like vary. */
+    void (*shadeFragments)(int, const double[], int, const texTexture *[], int, const double[], const double[], int, double[]);
+};
+
+/* Shades vertNum consecutive vertices, whose attributes start at attr, into
+vary. Uses the batched sha->shadeVertices if there is one, and otherwise adapts
+sha->shadeVertex by looping over the vertices. */
+void shaShadeVertices(
+        const shaShading *sha, const double unif[], int vertNum,
+        const double attr[], double vary[]) {
+    if (sha->shadeVertices != NULL)
+        sha->shadeVertices(
+            sha->unifDim, unif, vertNum, sha->attrDim, attr, sha->varyDim,
+            vary);
+    else
+        for (int i = 0; i < vertNum; i += 1)
+            sha->shadeVertex(
+                sha->unifDim, unif, sha->attrDim, &attr[i * sha->attrDim],
+                sha->varyDim, &vary[i * sha->varyDim]);
+}
+
+/* Shades a group of fragments, laid out as for shadeFragments. Uses the group
+sha->shadeFragments if there is one, and otherwise adapts sha->shadeFragment by
+looping over the lanes in mask. */
+void shaShadeFragments(
+        const shaShading *sha, const double unif[], const texTexture *tex[],
+        const double vary[], const double dVary[], int mask, double rgbd[]) {
+    if (sha->shadeFragments != NULL) {
+        sha->shadeFragments(
+            sha->unifDim, unif, sha->texNum, tex, sha->varyDim, vary, dVary,
+            mask, rgbd);
+        return;
+    }
+    double chi[sha->varyDim], rgbdLane[4];
+    for (int l = 0; l < shaGROUPSIZE; l += 1)
+        if (mask & (1 << l)) {
+            for (int v = 0; v < sha->varyDim; v += 1)
+                chi[v] = vary[v * shaGROUPSIZE + l];
+            vec3Set(1.0, 1.0, 1.0, rgbdLane);
+            sha->shadeFragment(
+                sha->unifDim, unif, sha->texNum, tex, sha->varyDim, chi,
+                rgbdLane);
+            for (int c = 0; c < 4; c += 1)
+                rgbd[c * shaGROUPSIZE + l] = rgbdLane[c];
+        }
+}
@@ -0,0 +1,398 @@
+/*
+    363depth.c
+    C file defining a depth buffer and providing methods for interaction.
+    Differs from 362depth.c by letting the buffer store its depths in one of several formats, chosen when
+    it is initialized. depthFLOAT is 362depth.c's format, and depthDOUBLE is 260depth.c's. depthUNORM24
+    and depthUNORM16 store depths between 0 and 1 as 24- or 16-bit unsigned integers, as GPUs do. In
+    depthFLOATREVERSED, 1 - depth is stored instead of depth, which spends float's fine precision near 0
+    on the far end of the view volume, where perspective crowds the depths together. However the depths
+    are stored, the accessors take and return depths as usual, with smaller depths closer to the camera.
+    Adds depthTestDepth, which tests and writes one pixel's depth, and has depthTestGroup specialized to
+    each format, with AVX2 versions for all of them but depthDOUBLE.
+    Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+#include <stdint.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#define depthDOUBLE 0
+#define depthFLOAT 1
+#define depthFLOATREVERSED 2
+#define depthUNORM24 3
+#define depthUNORM16 4
+
+/* The largest stored values of the integer formats, which stand for depth 1. */
+#define depthUNORM24MAX 16777215
+#define depthUNORM16MAX 65535
+
+/*** Creating and destroying (once per program?) ***/
+
+/* Feel free to read the struct's members, but don't write them, except through
+the accessors below such as depthSetDepth, etc. depths points to doubles,
+floats, uint32_ts (for depthUNORM24), or uint16_ts, depending on format. */
+typedef struct depthBuffer depthBuffer;
+struct depthBuffer {
+	int width, height;
+	int format;
+	void *depths;			/* width * height values */
+};
+
+/* Returns the number of bytes that the format uses per pixel, or 0 if the
+format is unknown. */
+int depthGetFormatSize(int format) {
+	if (format == depthDOUBLE)
+		return sizeof(double);
+	else if (format == depthFLOAT || format == depthFLOATREVERSED)
+		return sizeof(float);
+	else if (format == depthUNORM24)
+		return sizeof(uint32_t);
+	else if (format == depthUNORM16)
+		return sizeof(uint16_t);
+	else
+		return 0;
+}
+
+/* Initializes a depth buffer, whose depths are stored in the given format.
+When you are finished with the buffer, you must call depthFinalize to
+deallocate its backing resources. */
+int depthInitialize(depthBuffer *buf, int width, int height, int format) {
+	int size = depthGetFormatSize(format);
+	if (size == 0) {
+		fprintf(stderr, "error: depthInitialize: unknown format %d\n", format);
+		return 2;
+	}
+	buf->depths = malloc(width * height * size);
+	if (buf->depths != NULL) {
+		buf->width = width;
+		buf->height = height;
+		buf->format = format;
+	}
+	return (buf->depths == NULL);
+}
+
+/* Deallocates the resources backing the buffer. This function must be called
+when you are finished using a buffer. */
+void depthFinalize(depthBuffer *buf) {
+	free(buf->depths);
+}
+
+
+
+/*** Private: encoding ***/
+
+/* Converts a depth to an integer format whose largest value is max. Depths
+outside 0 to 1 are clamped. */
+uint32_t depthEncodeUnorm(double depth, uint32_t max) {
+	if (!(depth > 0.0))
+		return 0;
+	else if (depth >= 1.0)
+		return max;
+	else
+		return (uint32_t)(depth * max + 0.5);
+}
+
+
+
+/*** Regular use (on each frame) ***/
+
+/* Sets every depth-value to the given depth. Typically you use this function
+at the start of each frame, passing a large positive value for depth. */
+void depthClearDepths(depthBuffer *buf, double depth) {
+	int n = buf->width * buf->height;
+	if (buf->format == depthDOUBLE) {
+		double *depths = (double *)buf->depths;
+		for (int k = 0; k < n; k += 1)
+			depths[k] = depth;
+	} else if (buf->format == depthFLOAT || buf->format == depthFLOATREVERSED) {
+		float *depths = (float *)buf->depths;
+		float value = (buf->format == depthFLOAT) ? depth : 1.0 - depth;
+		for (int k = 0; k < n; k += 1)
+			depths[k] = value;
+	} else if (buf->format == depthUNORM24) {
+		uint32_t *depths = (uint32_t *)buf->depths;
+		uint32_t value = depthEncodeUnorm(depth, depthUNORM24MAX);
+		for (int k = 0; k < n; k += 1)
+			depths[k] = value;
+	} else {
+		uint16_t *depths = (uint16_t *)buf->depths;
+		uint16_t value = depthEncodeUnorm(depth, depthUNORM16MAX);
+		for (int k = 0; k < n; k += 1)
+			depths[k] = value;
+	}
+}
+
+/* Sets the depth-value at pixel (i, j) to the given depth. */
+void depthSetDepth(depthBuffer *buf, int i, int j, double depth) {
+	if (0 <= i && i < buf->width && 0 <= j && j < buf->height) {
+		int k = i + buf->width * j;
+		if (buf->format == depthDOUBLE)
+			((double *)buf->depths)[k] = depth;
+		else if (buf->format == depthFLOAT)
+			((float *)buf->depths)[k] = depth;
+		else if (buf->format == depthFLOATREVERSED)
+			((float *)buf->depths)[k] = 1.0 - depth;
+		else if (buf->format == depthUNORM24)
+			((uint32_t *)buf->depths)[k] = depthEncodeUnorm(depth,
+				depthUNORM24MAX);
+		else
+			((uint16_t *)buf->depths)[k] = depthEncodeUnorm(depth,
+				depthUNORM16MAX);
+	}
+}
+
+/* Returns the depth-value at pixel (i, j), as precisely as the format
+stores it. */
+double depthGetDepth(const depthBuffer *buf, int i, int j) {
+	if (0 <= i && i < buf->width && 0 <= j && j < buf->height) {
+		int k = i + buf->width * j;
+		if (buf->format == depthDOUBLE)
+			return ((double *)buf->depths)[k];
+		else if (buf->format == depthFLOAT)
+			return ((float *)buf->depths)[k];
+		else if (buf->format == depthFLOATREVERSED)
+			return 1.0 - ((float *)buf->depths)[k];
+		else if (buf->format == depthUNORM24)
+			return ((uint32_t *)buf->depths)[k] / (double)depthUNORM24MAX;
+		else
+			return ((uint16_t *)buf->depths)[k] / (double)depthUNORM16MAX;
+	} else
+		/* There's no right answer, but we have to return something. */
+		return 0.0;
+}
+
+/* Depth-tests a fragment at pixel (i, j), which must be in the buffer. If the
+depth is less than the one stored, then stores it and returns 1. Otherwise
+returns 0. Unlike a depthGetDepth followed by a depthSetDepth, this compares in
+the stored format, so depths that the format can't tell apart never pass. */
+int depthTestDepth(depthBuffer *buf, int i, int j, double depth) {
+	int k = i + buf->width * j;
+	if (buf->format == depthDOUBLE) {
+		double *old = &((double *)buf->depths)[k];
+		if (depth < *old) {
+			*old = depth;
+			return 1;
+		}
+	} else if (buf->format == depthFLOAT) {
+		float *old = &((float *)buf->depths)[k];
+		float new = depth;
+		if (new < *old) {
+			*old = new;
+			return 1;
+		}
+	} else if (buf->format == depthFLOATREVERSED) {
+		float *old = &((float *)buf->depths)[k];
+		float new = 1.0 - depth;
+		if (new > *old) {
+			*old = new;
+			return 1;
+		}
+	} else if (buf->format == depthUNORM24) {
+		uint32_t *old = &((uint32_t *)buf->depths)[k];
+		uint32_t new = depthEncodeUnorm(depth, depthUNORM24MAX);
+		if (new < *old) {
+			*old = new;
+			return 1;
+		}
+	} else {
+		uint16_t *old = &((uint16_t *)buf->depths)[k];
+		uint16_t new = depthEncodeUnorm(depth, depthUNORM16MAX);
+		if (new < *old) {
+			*old = new;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+
+
+/*** Private: group depth tests ***/
+
+/* The scalar group tests, one per format, stamped out by this macro. Each tests
+the lanes one at a time, with the test on the format done once per group
+rather than once per lane. encode turns the double depth d into the stored
+type, and pass compares new with old. */
+#define depthGROUPSCALAR(name, type, encode, pass) \
+int name(depthBuffer *buf, int i, int j, int mask, \
+		const double depths[shaGROUPSIZE]) { \
+	type *row = &((type *)buf->depths)[i + buf->width * j]; \
+	int passMask = 0; \
+	for (int l = 0; l < shaGROUPSIZE; l += 1) \
+		if (mask & (1 << l)) { \
+			type *old = &row[shaLANEX(l) + buf->width * shaLANEY(l)]; \
+			double d = depths[l]; \
+			type new = (encode); \
+			if (pass) { \
+				*old = new; \
+				passMask |= 1 << l; \
+			} \
+		} \
+	return passMask; \
+}
+
+depthGROUPSCALAR(depthTestGroupDouble, double, d, new < *old)
+depthGROUPSCALAR(depthTestGroupFloatScalar, float, d, new < *old)
+depthGROUPSCALAR(depthTestGroupReversedScalar, float, 1.0 - d, new > *old)
+depthGROUPSCALAR(depthTestGroupUnorm24Scalar, uint32_t,
+	depthEncodeUnorm(d, depthUNORM24MAX), new < *old)
+depthGROUPSCALAR(depthTestGroupUnorm16Scalar, uint16_t,
+	depthEncodeUnorm(d, depthUNORM16MAX), new < *old)
+
+#ifdef __AVX2__
+/* Returns all ones in lane l if bit l of mask is set, and zeros otherwise. */
+__m256i depthMaskLanes(int mask) {
+	__m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+	return _mm256_cmpeq_epi32(
+		_mm256_and_si256(_mm256_set1_epi32(mask), bits), bits);
+}
+
+/* For depthFLOAT and depthFLOATREVERSED, as in 362depth.c. Masked loads and
+stores never touch the lanes that are off, so they are safe even where the
+group hangs over the edge of the buffer. */
+int depthTestGroupFloat(depthBuffer *buf, int i, int j, int mask,
+		const double depths[shaGROUPSIZE]) {
+	float *row0 = &((float *)buf->depths)[i + buf->width * j];
+	float *row1 = row0 + buf->width;
+	__m256i on = depthMaskLanes(mask);
+	__m256 old = _mm256_set_m128(
+		_mm_maskload_ps(row1, _mm256_extracti128_si256(on, 1)),
+		_mm_maskload_ps(row0, _mm256_castsi256_si128(on)));
+	__m256d new0 = _mm256_loadu_pd(&depths[0]);
+	__m256d new1 = _mm256_loadu_pd(&depths[4]);
+	__m256 pass;
+	if (buf->format == depthFLOATREVERSED) {
+		/* Subtracting in double keeps the precision that reversing is for. */
+		__m256d one = _mm256_set1_pd(1.0);
+		new0 = _mm256_sub_pd(one, new0);
+		new1 = _mm256_sub_pd(one, new1);
+	}
+	__m256 new = _mm256_set_m128(_mm256_cvtpd_ps(new1), _mm256_cvtpd_ps(new0));
+	if (buf->format == depthFLOATREVERSED)
+		pass = _mm256_cmp_ps(new, old, _CMP_GT_OQ);
+	else
+		pass = _mm256_cmp_ps(new, old, _CMP_LT_OQ);
+	pass = _mm256_and_ps(pass, _mm256_castsi256_ps(on));
+	__m256i passI = _mm256_castps_si256(pass);
+	_mm_maskstore_ps(row0, _mm256_castsi256_si128(passI),
+		_mm256_castps256_ps128(new));
+	_mm_maskstore_ps(row1, _mm256_extracti128_si256(passI, 1),
+		_mm256_extractf128_ps(new, 1));
+	return _mm256_movemask_ps(pass);
+}
+
+/* For depthUNORM24. The stored values are less than 2^24, so the signed 32-bit
+comparison is correct. */
+int depthTestGroupUnorm24(depthBuffer *buf, int i, int j, int mask,
+		const double depths[shaGROUPSIZE]) {
+	int *row0 = (int *)&((uint32_t *)buf->depths)[i + buf->width * j];
+	int *row1 = row0 + buf->width;
+	__m256i on = depthMaskLanes(mask);
+	__m256i old = _mm256_set_m128i(
+		_mm_maskload_epi32(row1, _mm256_extracti128_si256(on, 1)),
+		_mm_maskload_epi32(row0, _mm256_castsi256_si128(on)));
+	/* Clamps and rounds as depthEncodeUnorm does. */
+	__m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1.0);
+	__m256d max = _mm256_set1_pd(depthUNORM24MAX), half = _mm256_set1_pd(0.5);
+	__m256d new0 = _mm256_min_pd(_mm256_max_pd(_mm256_loadu_pd(&depths[0]),
+		zero), one);
+	__m256d new1 = _mm256_min_pd(_mm256_max_pd(_mm256_loadu_pd(&depths[4]),
+		zero), one);
+	new0 = _mm256_add_pd(_mm256_mul_pd(new0, max), half);
+	new1 = _mm256_add_pd(_mm256_mul_pd(new1, max), half);
+	__m256i new = _mm256_set_m128i(_mm256_cvttpd_epi32(new1),
+		_mm256_cvttpd_epi32(new0));
+	__m256i pass = _mm256_and_si256(_mm256_cmpgt_epi32(old, new), on);
+	_mm_maskstore_epi32(row0, _mm256_castsi256_si128(pass),
+		_mm256_castsi256_si128(new));
+	_mm_maskstore_epi32(row1, _mm256_extracti128_si256(pass, 1),
+		_mm256_extracti128_si256(new, 1));
+	return _mm256_movemask_ps(_mm256_castsi256_ps(pass));
+}
+
+/* For depthUNORM16. AVX2 has no 16-bit masked loads or stores. So a full
+group, which lies inside the buffer, is read and written a row of four depths
+at a time, with the lanes that fail rewritten with their old values. A partial
+group is read and written a lane at a time. Either way, the depths are encoded
+and compared as 32-bit integers, as in depthTestGroupUnorm24. */
+int depthTestGroupUnorm16(depthBuffer *buf, int i, int j, int mask,
+		const double depths[shaGROUPSIZE]) {
+	uint16_t *row0 = &((uint16_t *)buf->depths)[i + buf->width * j];
+	uint16_t *row1 = row0 + buf->width;
+	__m128i old16;
+	if (mask == 0xff)
+		old16 = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)row0),
+			_mm_loadl_epi64((const __m128i *)row1));
+	else {
+		uint16_t olds[shaGROUPSIZE] = {0};
+		for (int l = 0; l < shaGROUPSIZE; l += 1)
+			if (mask & (1 << l))
+				olds[l] = row0[shaLANEX(l) + buf->width * shaLANEY(l)];
+		old16 = _mm_loadu_si128((const __m128i *)olds);
+	}
+	__m256i old = _mm256_cvtepu16_epi32(old16);
+	/* Clamps and rounds as depthEncodeUnorm does. */
+	__m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1.0);
+	__m256d max = _mm256_set1_pd(depthUNORM16MAX), half = _mm256_set1_pd(0.5);
+	__m256d new0 = _mm256_min_pd(_mm256_max_pd(_mm256_loadu_pd(&depths[0]),
+		zero), one);
+	__m256d new1 = _mm256_min_pd(_mm256_max_pd(_mm256_loadu_pd(&depths[4]),
+		zero), one);
+	new0 = _mm256_add_pd(_mm256_mul_pd(new0, max), half);
+	new1 = _mm256_add_pd(_mm256_mul_pd(new1, max), half);
+	__m256i new = _mm256_set_m128i(_mm256_cvttpd_epi32(new1),
+		_mm256_cvttpd_epi32(new0));
+	__m256i pass = _mm256_and_si256(_mm256_cmpgt_epi32(old, new),
+		depthMaskLanes(mask));
+	int passMask = _mm256_movemask_ps(_mm256_castsi256_ps(pass));
+	__m128i new16 = _mm_packus_epi32(_mm256_castsi256_si128(new),
+		_mm256_extracti128_si256(new, 1));
+	if (mask == 0xff) {
+		__m128i pass16 = _mm_packs_epi32(_mm256_castsi256_si128(pass),
+			_mm256_extracti128_si256(pass, 1));
+		__m128i out = _mm_blendv_epi8(old16, new16, pass16);
+		_mm_storel_epi64((__m128i *)row0, out);
+		_mm_storel_epi64((__m128i *)row1, _mm_unpackhi_epi64(out, out));
+	} else if (passMask != 0) {
+		uint16_t news[shaGROUPSIZE];
+		_mm_storeu_si128((__m128i *)news, new16);
+		for (int l = 0; l < shaGROUPSIZE; l += 1)
+			if (passMask & (1 << l))
+				row0[shaLANEX(l) + buf->width * shaLANEY(l)] = news[l];
+	}
+	return passMask;
+}
+#endif
+
+
+
+/*** Regular use, continued ***/
+
+/* Depth-tests the group of fragments whose lower left pixel is (i, j), laid out
+as in 362shading.c. depths holds one depth per lane. Only the lanes whose bits
+are set in mask take part, and each of their pixels must be in the buffer. Each
+lane is tested as in depthTestDepth. Returns the mask of the lanes that
+passed. */
+int depthTestGroup(depthBuffer *buf, int i, int j, int mask,
+		const double depths[shaGROUPSIZE]) {
+	if (buf->format == depthDOUBLE)
+		return depthTestGroupDouble(buf, i, j, mask, depths);
+#ifdef __AVX2__
+	else if (buf->format == depthUNORM24)
+		return depthTestGroupUnorm24(buf, i, j, mask, depths);
+	else if (buf->format == depthUNORM16)
+		return depthTestGroupUnorm16(buf, i, j, mask, depths);
+	else
+		return depthTestGroupFloat(buf, i, j, mask, depths);
+#else
+	else if (buf->format == depthUNORM24)
+		return depthTestGroupUnorm24Scalar(buf, i, j, mask, depths);
+	else if (buf->format == depthUNORM16)
+		return depthTestGroupUnorm16Scalar(buf, i, j, mask, depths);
+	else if (buf->format == depthFLOAT)
+		return depthTestGroupFloatScalar(buf, i, j, mask, depths);
+	else
+		return depthTestGroupReversedScalar(buf, i, j, mask, depths);
+#endif
+}
@@ -0,0 +1,367 @@
+/*
+	363mainDepthFormats.c
+	Compares the depth buffer formats of 363depth.c. First, for each format, it times clearing a
+	BIGSIZE x BIGSIZE depth buffer and depth-testing every pixel of it, which is all memory traffic.
+	Then it renders a wide landscape twice, the second copy tinted and LAYERHEIGHT higher than the
+	first, with the near plane very close and the far plane very far. Perspective crowds the depths of
+	the distant hills together, so there the format may not be able to tell that the second copy is in
+	front, and the first copy shows through. The program counts the pixels that come out differently
+	than with depthDOUBLE. Then the landscape is shown. Press ENTER to switch to the next format.
+	Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+
+/* On macOS (Intel), compile with...
+    clang -O3 -c 040pixel.c -Wno-deprecated
+    clang -O3 -mavx2 363mainDepthFormats.c 040pixel.o -lglfw -framework OpenGL -framework Cocoa -framework IOKit
+On Ubuntu, compile with...
+    cc -O3 -c 040pixel.c
+    cc -O3 -mavx2 363mainDepthFormats.c 040pixel.o -lglfw -lGL -lm -ldl -lpthread
+Without -mavx2 (for example on Apple silicon), every format uses the scalar
+depth tests of 363depth.c.
+*/
+
+#define WINDOWWIDTH 512.0
+#define WINDOWHEIGHT 512.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <GLFW/glfw3.h>
+#include <sys/time.h>
+
+#include "040pixel.h"
+
+#include "250vector.c"
+#include "280matrix.c"
+#include "150texture.c"
+#include "362shading.c"
+#include "363depth.c"
+#include "362triangle.c"
+#include "350kernel.c"
+#include "351mesh.c"
+#include "250mesh3D.c"
+#include "300isometry.c"
+#include "300camera.c"
+#include "340landscape.c"
+
+#define LANDSIZE 60
+#define LANDSPACING 4.0
+#define FRAMENUM 20
+#define BIGSIZE 2048
+#define DEPTHREPNUM 10
+#define FORMATNUM 5
+#define LAYERHEIGHT 0.1
+
+#define ATTRX 0
+#define ATTRY 1
+#define ATTRZ 2
+#define ATTRS 3
+#define ATTRT 4
+#define ATTRN 5
+#define ATTRO 6
+#define ATTRP 7
+#define VARYX 0
+#define VARYY 1
+#define VARYZ 2
+#define VARYW 3
+#define VARYS 4
+#define VARYT 5
+#define VARYN 6
+#define VARYO 7
+#define VARYP 8
+#define UNIFMODELING 0
+#define UNIFPROJINVISOM 16
+#define UNIFTINT 32
+
+/* The first four entries of vary are assumed to be X, Y, Z, W. */
+void shadeVertexLand(
+        int unifDim, const double unif[], int attrDim, const double attr[],
+        int varyDim, double vary[]) {
+	double attrHomog[4] = {attr[ATTRX], attr[ATTRY], attr[ATTRZ], 1.0};
+	double modHomog[4];
+	mat441Multiply((double(*)[4])(&unif[UNIFMODELING]), attrHomog, modHomog);
+	mat441Multiply((double(*)[4])(&unif[UNIFPROJINVISOM]), modHomog, vary);
+	vecCopy(5, &attr[ATTRS], &vary[VARYS]);
+}
+
+void shadeFragmentLand(
+        int unifDim, const double unif[], int texNum, const texTexture *tex[],
+        int varyDim, const double vary[], double rgbd[4]) {
+	double sample[tex[0]->texelDim];
+	texSample(tex[0], vary[VARYS], vary[VARYT], sample);
+	sample[0] = sample[1] * 0.2 + 0.8;
+	sample[1] = sample[1] * 0.2 + 0.6;
+	sample[2] = 0.3;
+	double intensity = vary[VARYP] / vecLength(3, &vary[VARYN]) * unif[UNIFTINT];
+	vecScale(3, intensity, sample, rgbd);
+	rgbd[3] = vary[VARYZ];
+}
+
+/* The group shader of 362mainQuads.c. */
+void shadeFragmentsLand(
+        int unifDim, const double unif[], int texNum, const texTexture *tex[],
+        int varyDim, const double vary[], const double dVary[], int mask,
+        double rgbd[]) {
+	const int n = shaGROUPSIZE;
+	double green[shaGROUPSIZE] = {0.0};
+	double sample[tex[0]->texelDim];
+	for (int l = 0; l < n; l += 1)
+		if (mask & (1 << l)) {
+			texSample(tex[0], vary[VARYS * n + l], vary[VARYT * n + l], sample);
+			green[l] = sample[1];
+		}
+	for (int l = 0; l < n; l += 1) {
+		double nx = vary[VARYN * n + l], ny = vary[VARYO * n + l];
+		double nz = vary[VARYP * n + l];
+		double intensity = nz / sqrt(nx * nx + ny * ny + nz * nz);
+		intensity *= unif[UNIFTINT];
+		rgbd[l] = intensity * (green[l] * 0.2 + 0.8);
+		rgbd[n + l] = intensity * (green[l] * 0.2 + 0.6);
+		rgbd[2 * n + l] = intensity * 0.3;
+		rgbd[3 * n + l] = vary[VARYZ * n + l];
+	}
+}
+
+const int formats[FORMATNUM] = {
+	depthDOUBLE, depthFLOAT, depthFLOATREVERSED, depthUNORM24, depthUNORM16};
+const char *formatNames[FORMATNUM] = {
+	"depthDOUBLE", "depthFLOAT", "depthFLOATREVERSED", "depthUNORM24",
+	"depthUNORM16"};
+depthBuffer bufs[FORMATNUM];
+int formatIndex = 0;
+shaShading sha;
+texTexture texture;
+const texTexture *textures[1] = {&texture};
+meshMesh landMesh;
+double unif[16 + 16 + 1] = {
+	1.0, 0.0, 0.0, 0.0,
+	0.0, 1.0, 0.0, 0.0,
+	0.0, 0.0, 1.0, 0.0,
+	0.0, 0.0, 0.0, 1.0};
+double viewport[4][4];
+camCamera cam;
+double angle = M_PI * 0.25;
+
+/* Returns the current time in seconds. */
+double benchTime(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (double)tv.tv_sec + (double)tv.tv_usec * 0.000001;
+}
+
+/* Builds a landscape mesh from a fixed seed, as 340mainLandscape.c does from a
+random one. Returns an error code (0 on success). */
+int initializeLandscape(meshMesh *mesh, int size, double spacing) {
+	double *landData = (double *)malloc(size * size * sizeof(double));
+	if (landData == NULL)
+		return 2;
+	landFlat(size, landData, 0.0);
+	srand(311);
+	for (int i = 0; i < 24; i += 1)
+		landFaultRandomly(size, landData, 2.0 - i * 0.04);
+	for (int i = 0; i < 4; i += 1)
+		landBlur(size, landData);
+	int error = mesh3DInitializeLandscape(mesh, size, spacing, landData);
+	free(landData);
+	if (error != 0)
+		return 1;
+	for (int i = 0; i < mesh->vertNum; i += 1) {
+		double *vertPtr = meshGetVertexPointer(mesh, i);
+		vertPtr[ATTRS] = 0.0;
+		vertPtr[ATTRT] = vertPtr[ATTRZ];
+	}
+	return 0;
+}
+
+/* Times clearing a BIGSIZE x BIGSIZE buffer of the given format and then
+depth-testing every pixel in it, a group at a time, with depths that all pass.
+The depths change from group to group, as a rasterizer's would, so that the
+compiler can't convert them to the stored format once, outside the loops.
+Returns the mean seconds per repetition, or a negative number on error. */
+double benchDepth(int format) {
+	depthBuffer big;
+	if (depthInitialize(&big, BIGSIZE, BIGSIZE, format) != 0)
+		return -1.0;
+	double depths[shaGROUPSIZE];
+	int passNum = 0;
+	double start = benchTime();
+	for (int rep = 0; rep < DEPTHREPNUM; rep += 1) {
+		depthClearDepths(&big, 1000000000.0);
+		for (int j = 0; j < BIGSIZE; j += 2)
+			for (int i = 0; i < BIGSIZE; i += 4) {
+				double base = 0.25 + (i + j) * (0.1 / BIGSIZE);
+				for (int l = 0; l < shaGROUPSIZE; l += 1)
+					depths[l] = base + l * 0.0625;
+				passNum += depthTestGroup(&big, i, j, 0xff, depths) == 0xff;
+			}
+	}
+	double repTime = (benchTime() - start) / DEPTHREPNUM;
+	depthFinalize(&big);
+	if (passNum != DEPTHREPNUM * (BIGSIZE / 2) * (BIGSIZE / 4)) {
+		fprintf(stderr, "error: benchDepth: %s: depth test failed\n",
+			formatNames[format]);
+		return -1.0;
+	}
+	return repTime;
+}
+
+void render(void) {
+	pixClearRGB(0.8, 0.8, 1.0);
+	depthClearDepths(&bufs[formatIndex], 1000000000.0);
+	double projInvIsom[4][4];
+	camGetProjectionInverseIsometry(&cam, projInvIsom);
+	vecCopy(16, (double *)projInvIsom, &unif[UNIFPROJINVISOM]);
+	/* The first copy, and then the second, raised and darker. */
+	unif[UNIFMODELING + 11] = 0.0;
+	unif[UNIFTINT] = 1.0;
+	meshRender(&landMesh, &bufs[formatIndex], viewport, &sha, unif, textures);
+	unif[UNIFMODELING + 11] = LAYERHEIGHT;
+	unif[UNIFTINT] = 0.7;
+	meshRender(&landMesh, &bufs[formatIndex], viewport, &sha, unif, textures);
+}
+
+/* Times whole frames with the current format, and leaves the last frame's image
+in rgb. Returns the mean seconds per frame. */
+double benchFrames(double *rgb) {
+	render();
+	double start = benchTime();
+	for (int i = 0; i < FRAMENUM; i += 1)
+		render();
+	double frameTime = (benchTime() - start) / FRAMENUM;
+	pixCopyRGB(rgb);
+	return frameTime;
+}
+
+void handleKeyUp(
+        int key, int shiftIsDown, int controlIsDown, int altOptionIsDown,
+        int superCommandIsDown) {
+	if (key == GLFW_KEY_ENTER) {
+		formatIndex = (formatIndex + 1) % FORMATNUM;
+		printf("handleKeyUp: %s\n", formatNames[formatIndex]);
+	}
+}
+
+void handleKeyDownAndRepeat(
+        int key, int shiftIsDown, int controlIsDown, int altOptionIsDown,
+        int superCommandIsDown) {
+	double position[3];
+	vecCopy(3, cam.isometry.translation, position);
+	if (key == GLFW_KEY_W) {
+		double delta[3] = {cos(angle), sin(angle), 0.0};
+		vecAdd(3, position, delta, position);
+	} else if (key == GLFW_KEY_S) {
+		double delta[3] = {cos(angle), sin(angle), 0.0};
+		vecSubtract(3, position, delta, position);
+	} else if (key == GLFW_KEY_A)
+		angle += M_PI / 12.0;
+	else if (key == GLFW_KEY_D)
+		angle -= M_PI / 12.0;
+	else if (key == GLFW_KEY_Q)
+		position[2] -= 1.0;
+	else if (key == GLFW_KEY_E)
+		position[2] += 1.0;
+	camLookFrom(&cam, position, M_PI * 0.55, angle);
+}
+
+void handleTimeStep(double oldTime, double newTime) {
+	if (floor(newTime) - floor(oldTime) >= 1.0)
+		printf("handleTimeStep: %f frames/sec\n", 1.0 / (newTime - oldTime));
+	render();
+}
+
+/* Finalizes the first bufNum depth buffers. */
+void finalizeBuffers(int bufNum) {
+	for (int k = 0; k < bufNum; k += 1)
+		depthFinalize(&bufs[k]);
+}
+
+int main(void) {
+	if (pixInitialize(WINDOWWIDTH, WINDOWHEIGHT, "Depth Formats") != 0)
+		return 1;
+	for (int k = 0; k < FORMATNUM; k += 1)
+		if (depthInitialize(&bufs[k], WINDOWWIDTH, WINDOWHEIGHT,
+				formats[k]) != 0) {
+			finalizeBuffers(k);
+			pixFinalize();
+			return 2;
+		}
+	if (texInitializeFile(&texture, "awesome.png") != 0) {
+		finalizeBuffers(FORMATNUM);
+		pixFinalize();
+		return 3;
+	}
+	if (initializeLandscape(&landMesh, LANDSIZE, LANDSPACING) != 0) {
+		texFinalize(&texture);
+		finalizeBuffers(FORMATNUM);
+		pixFinalize();
+		return 4;
+	}
+	int rgbNum = (int)WINDOWWIDTH * (int)WINDOWHEIGHT * 3;
+	double *rgbDouble = (double *)malloc(rgbNum * sizeof(double));
+	double *rgb = (double *)malloc(rgbNum * sizeof(double));
+	if (rgbDouble == NULL || rgb == NULL) {
+		fprintf(stderr, "error: main: malloc failed\n");
+		free(rgbDouble);
+		free(rgb);
+		meshFinalize(&landMesh);
+		texFinalize(&texture);
+		finalizeBuffers(FORMATNUM);
+		pixFinalize();
+		return 5;
+	}
+	texSetFiltering(&texture, texNEAREST);
+	texSetLeftRight(&texture, texREPEAT);
+	texSetTopBottom(&texture, texREPEAT);
+	sha.unifDim = 16 + 16 + 1;
+	sha.attrDim = 3 + 2 + 3;
+	sha.varyDim = 4 + 2 + 3;
+	sha.shadeVertex = shadeVertexLand;
+	sha.shadeFragment = shadeFragmentLand;
+	sha.shadeVertices = NULL;
+	sha.shadeFragments = shadeFragmentsLand;
+	sha.texNum = 1;
+	/* near = -0.01 and far = -10000.0, so the distant hills are crowded into
+	the last ten-thousandth of the depth range. */
+	mat44Viewport(WINDOWWIDTH, WINDOWHEIGHT, viewport);
+	camSetProjectionType(&cam, camPERSPECTIVE);
+	camSetFrustum(&cam, M_PI / 6.0, 10.0, 1000.0, WINDOWWIDTH, WINDOWHEIGHT);
+	double position[3] = {-10.0, -10.0, 12.0};
+	camLookFrom(&cam, position, M_PI * 0.55, angle);
+#ifdef __AVX2__
+	printf("depthTestGroup: using AVX2 where it can\n");
+#else
+	printf("depthTestGroup: using the scalar fallback\n");
+#endif
+	/* Depth traffic on its own, then whole frames. */
+	for (int k = 0; k < FORMATNUM; k += 1) {
+		double depthTime = benchDepth(formats[k]);
+		formatIndex = k;
+		double frameTime = benchFrames((k == 0) ? rgbDouble : rgb);
+		int wrongNum = 0;
+		for (int i = 0; k != 0 && i < rgbNum; i += 3)
+			if (rgb[i] != rgbDouble[i] || rgb[i + 1] != rgbDouble[i + 1] ||
+					rgb[i + 2] != rgbDouble[i + 2])
+				wrongNum += 1;
+		printf("%-18s: %d bytes/pixel, clear and test %dx%d in %f ms, ",
+			formatNames[k], depthGetFormatSize(formats[k]), BIGSIZE, BIGSIZE,
+			depthTime * 1000.0);
+		printf("%f ms/frame, %d pixels differ from depthDOUBLE\n",
+			frameTime * 1000.0, wrongNum);
+	}
+	free(rgb);
+	free(rgbDouble);
+	/* Run user interface. */
+	formatIndex = 0;
+	pixSetKeyUpHandler(handleKeyUp);
+	pixSetKeyDownHandler(handleKeyDownAndRepeat);
+	pixSetKeyRepeatHandler(handleKeyDownAndRepeat);
+	pixSetTimeStepHandler(handleTimeStep);
+	pixRun();
+	/* Clean up. */
+	meshFinalize(&landMesh);
+	texFinalize(&texture);
+	finalizeBuffers(FORMATNUM);
+	pixFinalize();
+	return 0;
+}
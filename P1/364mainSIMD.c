@@ -0,0 +1,189 @@
+/*
+	364mainSIMD.c
+	Times the fixed-size vector and matrix functions of 364vector.c and 364matrix.c against the
+	general ones that they specialize. For the matrices, the general versions are copied here
+	from 280matrix.c, because 364matrix.c replaces them. Each function runs over arrays of
+	ARRAYSIZE random inputs, REPNUM times, and the program prints the nanoseconds per call, the
+	speedup, and the largest difference between the two versions' outputs. It doesn't open a
+	window.
+	Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+
+/* On macOS (Intel) or Ubuntu, compile with...
+    cc -O3 -mavx2 364mainSIMD.c -lm
+Without -mavx2 (for example on Apple silicon), the fixed-size functions fall
+back to unrolled loops, and the speedups measure only the unrolling.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <sys/time.h>
+
+#include "364vector.c"
+#include "364matrix.c"
+
+#define ARRAYSIZE 1024
+#define REPNUM 2000
+
+/* The general versions, exactly as in 280matrix.c. */
+
+void mat44TransposeGeneral(const double m[4][4], double mT[4][4]) {
+	for (int i = 0 ; i < 4 ; i += 1)
+		for (int j = 0 ; j < 4 ; j += 1)
+			mT[i][j] = m[j][i];
+}
+
+void mat444MultiplyGeneral(
+        const double m[4][4], const double n[4][4], double mTimesN[4][4]) {
+	for (int i = 0 ; i < 4 ; i++) {
+		for (int j = 0 ; j < 4 ; j++) {
+			mTimesN[i][j] = 0;
+			for (int k = 0 ; k < 4 ; k++) {
+				mTimesN[i][j] += m[i][k] * n[k][j];
+			}
+		}
+	}
+}
+
+void mat441MultiplyGeneral(
+        const double m[4][4], const double v[4], double mTimesV[4]) {
+	mTimesV[0] = m[0][0]*v[0] + m[0][1]*v[1] + m[0][2]*v[2] + m[0][3]*v[3];
+	mTimesV[1] = m[1][0]*v[0] + m[1][1]*v[1] + m[1][2]*v[2] + m[1][3]*v[3];
+	mTimesV[2] = m[2][0]*v[0] + m[2][1]*v[1] + m[2][2]*v[2] + m[2][3]*v[3];
+	mTimesV[3] = m[3][0]*v[0] + m[3][1]*v[1] + m[3][2]*v[2] + m[3][3]*v[3];
+}
+
+double mats[ARRAYSIZE][4][4], otherMats[ARRAYSIZE][4][4];
+double vecs[ARRAYSIZE][4], otherVecs[ARRAYSIZE][4];
+double points[ARRAYSIZE][3];
+double matsGeneral[ARRAYSIZE][4][4], matsFixed[ARRAYSIZE][4][4];
+double vecsGeneral[ARRAYSIZE][4], vecsFixed[ARRAYSIZE][4];
+double dotsGeneral[ARRAYSIZE], dotsFixed[ARRAYSIZE];
+
+/* Returns the current time in seconds. */
+double benchTime(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (double)tv.tv_sec + (double)tv.tv_usec * 0.000001;
+}
+
+/* Returns the largest absolute difference between the num doubles of a and
+b. */
+double maxDifference(int num, const double a[], const double b[]) {
+	double maxDiff = 0.0;
+	for (int i = 0; i < num; i += 1)
+		if (fabs(a[i] - b[i]) > maxDiff)
+			maxDiff = fabs(a[i] - b[i]);
+	return maxDiff;
+}
+
+/* Prints one line of results. The times are in seconds for the whole run. */
+void report(const char *name, double generalTime, double fixedTime,
+		double maxDiff) {
+	double scale = 1000000000.0 / ((double)REPNUM * ARRAYSIZE);
+	printf("%-22s general %7.2f ns, fixed %7.2f ns, speedup %5.2fx, ",
+		name, generalTime * scale, fixedTime * scale, generalTime / fixedTime);
+	printf("max difference %g\n", maxDiff);
+}
+
+/* Tells the compiler that memory may have been read, so that it can't skip
+repetitions whose results are overwritten by the next repetition. It costs no
+instructions. */
+#define BARRIER() __asm__ __volatile__("" : : : "memory")
+
+/* Times one statement, which may use the index i, over the arrays. */
+#define TIME(seconds, statement) { \
+	double start = benchTime(); \
+	for (int rep = 0; rep < REPNUM; rep += 1) { \
+		for (int i = 0; i < ARRAYSIZE; i += 1) \
+			statement; \
+		BARRIER(); \
+	} \
+	seconds = benchTime() - start; \
+}
+
+int main(void) {
+	srand(311);
+	for (int i = 0; i < ARRAYSIZE; i += 1) {
+		for (int j = 0; j < 16; j += 1) {
+			mats[i][j / 4][j % 4] = rand() / (double)RAND_MAX - 0.5;
+			otherMats[i][j / 4][j % 4] = rand() / (double)RAND_MAX - 0.5;
+		}
+		for (int j = 0; j < 4; j += 1) {
+			vecs[i][j] = rand() / (double)RAND_MAX - 0.5;
+			otherVecs[i][j] = rand() / (double)RAND_MAX - 0.5;
+		}
+		for (int j = 0; j < 3; j += 1)
+			points[i][j] = rand() / (double)RAND_MAX * 100.0 - 50.0;
+	}
+#ifdef __AVX2__
+	printf("main: using AVX2\n");
+#else
+	printf("main: using the scalar fallbacks\n");
+#endif
+	double generalTime, fixedTime;
+	int matNum = ARRAYSIZE * 16, vecNum = ARRAYSIZE * 4;
+	/* An untimed pass first, so that touching the arrays for the first time,
+	and the processor powering up its wide vector units, don't count against
+	the first test. */
+	TIME(generalTime, vecAdd(4, vecs[i], otherVecs[i], vecsGeneral[i]));
+	TIME(fixedTime, vec4Add(vecs[i], otherVecs[i], vecsFixed[i]));
+	/* Vectors. */
+	TIME(generalTime, vecAdd(4, vecs[i], otherVecs[i], vecsGeneral[i]));
+	TIME(fixedTime, vec4Add(vecs[i], otherVecs[i], vecsFixed[i]));
+	report("vec4Add", generalTime, fixedTime,
+		maxDifference(vecNum, vecsGeneral[0], vecsFixed[0]));
+	TIME(generalTime, vecScale(4, otherVecs[i][0], vecs[i], vecsGeneral[i]));
+	TIME(fixedTime, vec4Scale(otherVecs[i][0], vecs[i], vecsFixed[i]));
+	report("vec4Scale", generalTime, fixedTime,
+		maxDifference(vecNum, vecsGeneral[0], vecsFixed[0]));
+	TIME(generalTime, dotsGeneral[i] = vecDot(4, vecs[i], otherVecs[i]));
+	TIME(fixedTime, dotsFixed[i] = vec4Dot(vecs[i], otherVecs[i]));
+	report("vec4Dot", generalTime, fixedTime,
+		maxDifference(ARRAYSIZE, dotsGeneral, dotsFixed));
+	TIME(generalTime, vecSubtract(3, vecs[i], otherVecs[i], vecsGeneral[i]));
+	TIME(fixedTime, vec3Subtract(vecs[i], otherVecs[i], vecsFixed[i]));
+	report("vec3Subtract", generalTime, fixedTime,
+		maxDifference(vecNum, vecsGeneral[0], vecsFixed[0]));
+	TIME(generalTime, dotsGeneral[i] = vecDot(3, vecs[i], otherVecs[i]));
+	TIME(fixedTime, dotsFixed[i] = vec3Dot(vecs[i], otherVecs[i]));
+	report("vec3Dot", generalTime, fixedTime,
+		maxDifference(ARRAYSIZE, dotsGeneral, dotsFixed));
+	/* Matrices. */
+	TIME(generalTime, mat44TransposeGeneral(mats[i], matsGeneral[i]));
+	TIME(fixedTime, mat44Transpose(mats[i], matsFixed[i]));
+	report("mat44Transpose", generalTime, fixedTime,
+		maxDifference(matNum, matsGeneral[0][0], matsFixed[0][0]));
+	TIME(generalTime, mat444MultiplyGeneral(mats[i], otherMats[i],
+		matsGeneral[i]));
+	TIME(fixedTime, mat444Multiply(mats[i], otherMats[i], matsFixed[i]));
+	report("mat444Multiply", generalTime, fixedTime,
+		maxDifference(matNum, matsGeneral[0][0], matsFixed[0][0]));
+	TIME(generalTime, mat441MultiplyGeneral(mats[i], vecs[i], vecsGeneral[i]));
+	TIME(fixedTime, mat441Multiply(mats[i], vecs[i], vecsFixed[i]));
+	report("mat441Multiply", generalTime, fixedTime,
+		maxDifference(vecNum, vecsGeneral[0], vecsFixed[0]));
+	/* Points, all by the same matrix, as a vertex shader would. The general
+	version is a loop of mat441Multiply on homogeneous points. */
+	double generalStart = benchTime();
+	for (int rep = 0; rep < REPNUM; rep += 1) {
+		for (int i = 0; i < ARRAYSIZE; i += 1) {
+			double homog[4] = {points[i][0], points[i][1], points[i][2], 1.0};
+			mat441MultiplyGeneral(mats[rep % ARRAYSIZE], homog, vecsGeneral[i]);
+		}
+		BARRIER();
+	}
+	generalTime = benchTime() - generalStart;
+	double fixedStart = benchTime();
+	for (int rep = 0; rep < REPNUM; rep += 1) {
+		mat44TransformPoints(ARRAYSIZE, mats[rep % ARRAYSIZE], points,
+			vecsFixed);
+		BARRIER();
+	}
+	fixedTime = benchTime() - fixedStart;
+	report("mat44TransformPoints", generalTime, fixedTime,
+		maxDifference(vecNum, vecsGeneral[0], vecsFixed[0]));
+	return 0;
+}
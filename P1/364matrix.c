@@ -0,0 +1,327 @@
+/*
+    364matrix.c
+    Interface for performing operations on matrices. Upgraded from 280matrix.c 
+    to compute mat44Transpose, mat444Multiply, and mat441Multiply with AVX2 when 
+    it is available, a row of four doubles per register, and to add 
+    mat44TransformPoints, which transforms a whole array of points at once.
+    Designed by Josh Davis for Carleton College's CS311 - Computer Graphics. 
+    Implementations written by Cole Weinstein and Robbie Young.
+*/
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/*** 2 x 2 Matrices ***/
+
+/* Pretty-prints the given matrix, with one line of text per row of matrix. */
+void mat22Print(const double m[2][2]) {
+    int i, j;
+    for (i = 0; i < 2; i += 1) {
+        for (j = 0; j < 2; j += 1)
+            printf("%f    ", m[i][j]);
+        printf("\n");
+    }
+}
+
+/* Returns the determinant of the matrix m. If the determinant is 0.0, then the 
+matrix is not invertible, and mInv is untouched. If the determinant is not 0.0, 
+then the matrix is invertible, and its inverse is placed into mInv. The output 
+CANNOT safely alias the input. */
+double mat22Invert(const double m[2][2], double mInv[2][2]) {
+    double det = m[0][0]*m[1][1] - m[0][1]*m[1][0];
+    if (det != 0){
+        mInv[0][0] = m[1][1] / det;
+        mInv[0][1] = -m[0][1] / det;
+        mInv[1][0] = -m[1][0] / det;
+        mInv[1][1] = m[0][0] / det;
+    }
+    return det;
+}
+
+/* Multiplies a 2x2 matrix m by a 2-column v, storing the result in mTimesV. 
+The output CANNOT safely alias the input. */
+void mat221Multiply(const double m[2][2], const double v[2], 
+        double mTimesV[2]) {
+    mTimesV[0] = m[0][0]*v[0] + m[0][1]*v[1];
+    mTimesV[1] = m[1][0]*v[0] + m[1][1]*v[1];
+}
+
+/* Fills the matrix m from its two columns. The output CANNOT safely alias the 
+input. */
+void mat22Columns(const double col0[2], const double col1[2], double m[2][2]) {
+    m[0][0] = col0[0];
+    m[0][1] = col1[0];
+    m[1][0] = col0[1];
+    m[1][1] = col1[1];
+}
+
+/* The theta parameter is an angle in radians. Sets the matrix m to the 
+rotation matrix corresponding to counterclockwise rotation of the plane through 
+the angle theta. */
+void mat22Rotation(double theta, double m[2][2]) {
+    m[0][0] = cos(theta);
+    m[0][1] = (-1)*sin(theta);
+    m[1][0] = sin(theta);
+    m[1][1] = cos(theta);
+}
+
+
+/*** 3 x 3 Matrices ***/
+
+/* Multiplies the 3x3 matrix m by the 3x3 matrix n. The output CANNOT safely 
+alias the input. */
+void mat333Multiply(
+        const double m[3][3], const double n[3][3], double mTimesN[3][3]) {
+    for (int i = 0 ; i < 3 ; i++) {
+        for (int j = 0 ; j < 3 ; j++) {
+            mTimesN[i][j] = 0;
+            for (int k = 0 ; k < 3 ; k++) {
+                mTimesN[i][j] += m[i][k] * n[k][j];
+            }
+        }
+    }
+}
+/* Multiplies the 3x3 matrix m by the 3x1 matrix v. The output CANNOT safely 
+alias the input. */
+void mat331Multiply(
+        const double m[3][3], const double v[3], double mTimesV[3]) {
+    mTimesV[0] = m[0][0]*v[0] + m[0][1]*v[1] + m[0][2]*v[2];
+    mTimesV[1] = m[1][0]*v[0] + m[1][1]*v[1] + m[1][2]*v[2];
+    mTimesV[2] = m[2][0]*v[0] + m[2][1]*v[1] + m[2][2]*v[2];
+}
+
+/* Computes the transpose M^T of the given 3x3 matrix M. The output CANNOT safely 
+alias the input. */
+void mat33Transpose(const double m[3][3], double mT[3][3]) {
+    for (int i = 0; i < 3; i += 1)
+        for (int j = 0; j < 3; j += 1)
+            mT[i][j] = m[j][i];
+}
+
+/* Builds a 3x3 matrix representing 2D rotation and translation in homogeneous 
+coordinates. More precisely, the transformation first rotates through the angle 
+theta (in radians, counterclockwise), and then translates by the vector t. */
+void mat33Isometry(double theta, const double t[2], double isom[3][3]) {
+    isom[0][0] = cos(theta);
+    isom[0][1] = (-1)*sin(theta);
+    isom[0][2] = t[0];
+    
+    isom[1][0] = sin(theta);
+    isom[1][1] = cos(theta);
+    isom[1][2] = t[1];
+
+    isom[2][0] = 0;
+    isom[2][1] = 0;
+    isom[2][2] = 1;
+}
+
+/* Given a length-1 3D vector axis and an angle theta (in radians), builds the 
+rotation matrix for the rotation about that axis through that angle. */
+void mat33AngleAxisRotation(
+        double theta, const double axis[3], double rot[3][3]) {
+    double matrix[3][3] = {{       0, -axis[2],  axis[1]},
+                           { axis[2],        0, -axis[0]},
+                           {-axis[1],  axis[0],        0}};
+                    
+    double matrixSquared[3][3] = {{    pow(axis[0], 2) - 1,  axis[0] * axis[1], axis[0] * axis[2]},
+                                  {axis[0] * axis[1],      pow(axis[1], 2) - 1, axis[1] * axis[2]},
+                                  {axis[0] * axis[2],  axis[1] * axis[2],     pow(axis[2], 2) - 1}};
+    
+    double identity[3][3] = {{1, 0, 0},
+                             {0, 1, 0},
+                             {0, 0, 1}};
+    
+    // M = I + (sin(theta) * U) + ((1-cos(theta)) * U^2)
+    for (int i = 0 ; i < 3 ; i++) {
+        for (int j = 0 ; j < 3 ; j++) {
+            rot[i][j] = identity[i][j] + sin(theta) * matrix[i][j] + (1 - cos(theta)) * matrixSquared [i][j];
+        }
+    }
+}
+
+/* Given two length-1 3D vectors u, v that are perpendicular to each other. 
+Given two length-1 3D vectors a, b that are perpendicular to each other. Builds 
+the rotation matrix that rotates u to a and v to b. */
+void mat33BasisRotation(
+        const double u[3], const double v[3], const double a[3], 
+        const double b[3], double rot[3][3]) {
+    double aCrossB[3], uCrossV[3];
+    vec3Cross(a, b, aCrossB);
+    vec3Cross(u, v, uCrossV);
+
+    double r[3][3], s[3][3], rTranspose[3][3];
+    for (int i = 0 ; i < 3 ; i++) {
+        r[i][0] = u[i];
+        r[i][1] = v[i];
+        r[i][2] = uCrossV[i];
+        s[i][0] = a[i];
+        s[i][1] = b[i];
+        s[i][2] = aCrossB[i];
+    }
+
+    mat33Transpose(r, rTranspose);
+    mat333Multiply(s, rTranspose, rot);
+}
+
+/* Computes the transpose M^T of the given 4x4 matrix M. The output CANNOT safely 
+alias the input. */
+void mat44Transpose(const double m[4][4], double mT[4][4]) {
+#ifdef __AVX2__
+    __m256d r0 = _mm256_loadu_pd(m[0]), r1 = _mm256_loadu_pd(m[1]);
+    __m256d r2 = _mm256_loadu_pd(m[2]), r3 = _mm256_loadu_pd(m[3]);
+    __m256d t0 = _mm256_unpacklo_pd(r0, r1), t1 = _mm256_unpackhi_pd(r0, r1);
+    __m256d t2 = _mm256_unpacklo_pd(r2, r3), t3 = _mm256_unpackhi_pd(r2, r3);
+    _mm256_storeu_pd(mT[0], _mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm256_storeu_pd(mT[1], _mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm256_storeu_pd(mT[2], _mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm256_storeu_pd(mT[3], _mm256_permute2f128_pd(t1, t3, 0x31));
+#else
+    for (int i = 0 ; i < 4 ; i += 1)
+        for (int j = 0 ; j < 4 ; j += 1)
+            mT[i][j] = m[j][i];
+#endif
+}
+
+/* Multiplies m by n, placing the answer in mTimesN. The output CANNOT safely 
+alias the input. */
+void mat444Multiply(
+        const double m[4][4], const double n[4][4], double mTimesN[4][4]) {
+#ifdef __AVX2__
+    /* Row i of the product is the sum of the rows of n, weighted by the 
+    entries of row i of m. */
+    __m256d n0 = _mm256_loadu_pd(n[0]), n1 = _mm256_loadu_pd(n[1]);
+    __m256d n2 = _mm256_loadu_pd(n[2]), n3 = _mm256_loadu_pd(n[3]);
+    for (int i = 0 ; i < 4 ; i++) {
+        __m256d row = _mm256_mul_pd(_mm256_set1_pd(m[i][0]), n0);
+        row = _mm256_add_pd(row, _mm256_mul_pd(_mm256_set1_pd(m[i][1]), n1));
+        row = _mm256_add_pd(row, _mm256_mul_pd(_mm256_set1_pd(m[i][2]), n2));
+        row = _mm256_add_pd(row, _mm256_mul_pd(_mm256_set1_pd(m[i][3]), n3));
+        _mm256_storeu_pd(mTimesN[i], row);
+    }
+#else
+    for (int i = 0 ; i < 4 ; i++) {
+        for (int j = 0 ; j < 4 ; j++) {
+            mTimesN[i][j] = 0;
+            for (int k = 0 ; k < 4 ; k++) {
+                mTimesN[i][j] += m[i][k] * n[k][j];
+            }
+        }
+    }
+#endif
+}
+
+/* Multiplies m by v, placing the answer in mTimesV. The output CANNOT safely 
+alias the input. */
+void mat441Multiply(
+        const double m[4][4], const double v[4], double mTimesV[4]) {
+#ifdef __AVX2__
+    /* Multiplies each row by v, then adds up each product's four lanes, two 
+    products at a time. */
+    __m256d vv = _mm256_loadu_pd(v);
+    __m256d p0 = _mm256_mul_pd(_mm256_loadu_pd(m[0]), vv);
+    __m256d p1 = _mm256_mul_pd(_mm256_loadu_pd(m[1]), vv);
+    __m256d p2 = _mm256_mul_pd(_mm256_loadu_pd(m[2]), vv);
+    __m256d p3 = _mm256_mul_pd(_mm256_loadu_pd(m[3]), vv);
+    __m256d h01 = _mm256_hadd_pd(p0, p1), h23 = _mm256_hadd_pd(p2, p3);
+    _mm256_storeu_pd(mTimesV, _mm256_add_pd(
+        _mm256_permute2f128_pd(h01, h23, 0x20), 
+        _mm256_permute2f128_pd(h01, h23, 0x31)));
+#else
+    mTimesV[0] = m[0][0]*v[0] + m[0][1]*v[1] + m[0][2]*v[2] + m[0][3]*v[3];
+    mTimesV[1] = m[1][0]*v[0] + m[1][1]*v[1] + m[1][2]*v[2] + m[1][3]*v[3];
+    mTimesV[2] = m[2][0]*v[0] + m[2][1]*v[1] + m[2][2]*v[2] + m[2][3]*v[3];
+    mTimesV[3] = m[3][0]*v[0] + m[3][1]*v[1] + m[3][2]*v[2] + m[3][3]*v[3];
+#endif
+}
+
+/* Transforms the n 3-dimensional points by m, treating each as the 
+homogeneous point (x, y, z, 1), and places the n homogeneous results in 
+mTimesPoints. This is n calls to mat441Multiply, except that the columns of m 
+are loaded once for the whole array. The output CANNOT safely alias the input. */
+void mat44TransformPoints(
+        int n, const double m[4][4], const double points[][3], 
+        double mTimesPoints[][4]) {
+#ifdef __AVX2__
+    /* The product is the sum of the columns of m, weighted by x, y, z, and 1. */
+    double mT[4][4];
+    mat44Transpose(m, mT);
+    __m256d c0 = _mm256_loadu_pd(mT[0]), c1 = _mm256_loadu_pd(mT[1]);
+    __m256d c2 = _mm256_loadu_pd(mT[2]), c3 = _mm256_loadu_pd(mT[3]);
+    for (int i = 0 ; i < n ; i++) {
+        __m256d p = _mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(points[i][0]), c0), 
+                _mm256_mul_pd(_mm256_set1_pd(points[i][1]), c1)), 
+            _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(points[i][2]), c2), c3));
+        _mm256_storeu_pd(mTimesPoints[i], p);
+    }
+#else
+    for (int i = 0 ; i < n ; i++)
+        for (int j = 0 ; j < 4 ; j++)
+            mTimesPoints[i][j] = (m[j][0] * points[i][0] + m[j][1] * points[i][1]) + 
+                (m[j][2] * points[i][2] + m[j][3]);
+#endif
+}
+
+/* Given a rotation and a translation, forms the 4x4 homogeneous matrix 
+representing the rotation followed in time by the translation. */
+void mat44Isometry(
+        const double rot[3][3], const double trans[3], double isom[4][4]) {
+    for (int i = 0 ; i < 3 ; i++) {
+        for (int j = 0 ; j < 3 ; j++) {
+            isom[i][j] = rot[i][j];
+        }
+        isom[i][3] = trans[i];
+    }
+    isom[3][0] = 0;
+    isom[3][1] = 0;
+    isom[3][2] = 0;
+    isom[3][3] = 1;
+}
+
+
+/* Sets its argument to the 4x4 zero matrix (which consists entirely of 0s). */
+void mat44Zero(double m[4][4]) {
+    for (int i = 0 ; i < 4 ; i++) {
+        for (int j = 0 ; j < 4 ; j++) {
+            m[i][j] = 0;
+        }
+    }
+}
+
+/* Multiplies the transpose of the 3x3 matrix m by the 3x1 matrix v. To 
+clarify, in math notation it computes M^T v. The output CANNOT safely alias the 
+input. */
+void mat331TransposeMultiply(
+        const double m[3][3], const double v[3], double mTTimesV[3]) {
+    mTTimesV[0] = m[0][0]*v[0] + m[1][0]*v[1] + m[2][0]*v[2];
+    mTTimesV[1] = m[0][1]*v[0] + m[1][1]*v[1] + m[2][1]*v[2];
+    mTTimesV[2] = m[0][2]*v[0] + m[1][2]*v[1] + m[2][2]*v[2];
+}
+
+/* Builds a 4x4 matrix for a viewport with lower left (0, 0) and upper right 
+(width, height). This matrix maps a projected viewing volume 
+[-1, 1] x [-1, 1] x [-1, 1] to screen [0, w] x [0, h] x [0, 1] (each interval 
+in that order). */
+void mat44Viewport(double width, double height, double view[4][4]) {
+    mat44Zero(view);
+    view[0][0] = width / 2.0;
+    view[0][3] = width / 2.0;
+    view[1][1] = height / 2.0;
+    view[1][3] = height / 2.0;
+    view[2][2] = 0.5;
+    view[2][3] = 0.5;
+    view[3][3] = 1;
+}
+
+/* Inverse to the matrix produced by mat44Viewport. */
+void mat44InverseViewport(double width, double height, double view[4][4]) {
+    mat44Zero(view);
+    view[0][0] = 2.0 / width;
+    view[0][3] = -1.0;
+    view[1][1] = 2.0 / height;
+    view[1][3] = -1.0;
+    view[2][2] = 2.0;
+    view[2][3] = -1.0;
+    view[3][3] = 1;
+}
\ No newline at end of file
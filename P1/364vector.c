@@ -0,0 +1,250 @@
+/*
+    364vector.c
+    A simple program to modify vectors and teach basic vector arithmetic. Upgraded from 250vector.c
+    to add fixed-size versions of the arithmetic for 3- and 4-dimensional vectors, which are the
+    sizes that the hot paths use. With AVX2, a 4-dimensional vector of doubles fits in one register,
+    and these functions use it. Otherwise, they fall back to unrolled loops.
+    Written by Josh Davis for Carleton College's CS311 - Computer Graphics.
+    Implementations written by Cole Weinstein and Robbie Young.
+*/
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/*** In general dimensions ***/
+
+/* Copies the dim-dimensional vector v to the dim-dimensional vector copy. The 
+output can safely alias the input. */
+void vecCopy(int dim, const double v[], double copy[]) {
+    for (int i = 0; i < dim; i += 1)
+        copy[i] = v[i];
+}
+
+/* Adds the dim-dimensional vectors v and w. The output can safely alias the 
+input. */
+void vecAdd(int dim, const double v[], const double w[], double vPlusW[]) {
+    for (int i = 0; i < dim; i += 1)
+        vPlusW[i] = v[i] + w[i];
+}
+
+/* Subtracts the dim-dimensional vectors v and w. The output can safely alias 
+the input. */
+void vecSubtract(
+        int dim, const double v[], const double w[], double vMinusW[]) {
+    for (int i = 0; i < dim; i += 1)
+        vMinusW[i] = v[i] - w[i];
+}
+
+/* Scales the dim-dimensional vector w by the number c. The output can safely 
+alias the input.*/
+void vecScale(int dim, double c, const double w[], double cTimesW[]) {
+    for (int i = 0; i < dim; i += 1)
+        cTimesW[i] = c * w[i];
+}
+
+/* Given two vectors v and w of the same dimension, produces a third vector of 
+the same dimension, obtained by multiplying v and w component-wise. The output 
+can safely alias the input. */
+void vecModulate(int dim, const double v[], const double w[], double vw[]) {
+    for (int i = 0; i < dim; i += 1)
+        vw[i] = v[i] * w[i];
+}
+
+
+
+/*** In specific dimensions ***/
+
+/* By the way, it is possible, using stdarg.h, to write a single vecSet function 
+that works in all dimensions. We're not going to take this approach for two 
+reasons. First, I try not to burden you with learning a lot of C that isn't 
+strictly necessary. Second, it's dangerous, in that it provides no type 
+checking. */
+
+/* Copies three numbers into a three-dimensional vector. */
+void vec3Set(double a0, double a1, double a2, double a[3]) {
+    a[0] = a0;
+    a[1] = a1;
+    a[2] = a2;
+}
+
+/* Copies four numbers into a four-dimensional vector. */
+void vec4Set(double a0, double a1, double a2, double a3, double a[4]) {
+    a[0] = a0;
+    a[1] = a1;
+    a[2] = a2;
+    a[3] = a3;
+}
+
+/* Copies eight numbers into an eight-dimensional vector. */
+void vec8Set(
+        double a0, double a1, double a2, double a3, double a4, double a5, 
+        double a6, double a7, double a[8]) {
+    a[0] = a0;
+    a[1] = a1;
+    a[2] = a2;
+    a[3] = a3;
+    a[4] = a4;
+    a[5] = a5;
+    a[6] = a6;
+    a[7] = a7;
+}
+
+/* Returns the dot product of the vectors v and w. */
+double vecDot(int dim, const double v[], const double w[]) {
+    double dot = 0;
+    for (int i = 0 ; i < dim ; i++) {
+        dot += (v[i] * w[i]);
+    }
+    return dot;
+}
+
+/* Returns the length of the vector v. */
+double vecLength(int dim, const double v[]) {
+    double length = 0;
+    for (int i = 0 ; i < dim ; i++) {
+        length += pow(v[i], 2);
+    }
+    return sqrt(length);
+}
+
+/* Returns the length of the vector v. If the length is non-zero, then also 
+places a normalized (length-1) version of v into unit. The output can safely 
+alias the input. */
+double vecUnit(int dim, const double v[], double unit[]) {
+    double length = vecLength(dim, v);
+    if (length != 0) {
+        for (int i = 0 ; i < dim ; i++) {
+            unit[i] = v[i]/length;
+        }
+    }
+    return length;
+}
+
+/* Computes the cross product of v and w, and places it into vCrossW. The 
+output CANNOT safely alias the input. */
+void vec3Cross(const double v[3], const double w[3], double vCrossW[3]) {
+    vCrossW[0] = v[1] * w[2] - v[2] * w[1];
+    vCrossW[1] = v[2] * w[0] - v[0] * w[2];
+    vCrossW[2] = v[0] * w[1] - v[1] * w[0];
+}
+
+/* Computes the vector v from its spherical coordinates. rho >= 0.0 is the 
+radius. 0 <= phi <= pi is the co-latitude. -pi <= theta <= pi is the longitude 
+or azimuth. */
+void vec3Spherical(double rho, double phi, double theta, double v[3]) {
+    v[0] = rho * sin(phi) * cos(theta);
+    v[1] = rho * sin(phi) * sin(theta);
+    v[2] = rho * cos(phi);
+}
+
+
+
+/*** In specific dimensions, with SIMD ***/
+
+/* These do the same as the general-dimension functions above with dim equal to
+3 or 4, and their outputs can safely alias their inputs in the same way. The
+3-dimensional ones touch only the three entries of each vector, so they are
+safe on vectors packed inside larger arrays, such as varyings. The dot products
+add in the same order with or without AVX2, so they agree exactly. */
+
+#ifdef __AVX2__
+/* Masks selecting the first three lanes of a register of four doubles. */
+#define vecMASK3 _mm256_setr_epi64x(-1, -1, -1, 0)
+
+/* Adds up the four lanes of a register. */
+double vecHorizontalSum(__m256d v) {
+    __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+#endif
+
+/* Adds the 3-dimensional vectors v and w. */
+void vec3Add(const double v[3], const double w[3], double vPlusW[3]) {
+#ifdef __AVX2__
+    __m256d sum = _mm256_add_pd(_mm256_maskload_pd(v, vecMASK3), _mm256_maskload_pd(w, vecMASK3));
+    _mm256_maskstore_pd(vPlusW, vecMASK3, sum);
+#else
+    vPlusW[0] = v[0] + w[0];
+    vPlusW[1] = v[1] + w[1];
+    vPlusW[2] = v[2] + w[2];
+#endif
+}
+
+/* Subtracts the 3-dimensional vectors v and w. */
+void vec3Subtract(const double v[3], const double w[3], double vMinusW[3]) {
+#ifdef __AVX2__
+    __m256d diff = _mm256_sub_pd(_mm256_maskload_pd(v, vecMASK3), _mm256_maskload_pd(w, vecMASK3));
+    _mm256_maskstore_pd(vMinusW, vecMASK3, diff);
+#else
+    vMinusW[0] = v[0] - w[0];
+    vMinusW[1] = v[1] - w[1];
+    vMinusW[2] = v[2] - w[2];
+#endif
+}
+
+/* Scales the 3-dimensional vector w by the number c. */
+void vec3Scale(double c, const double w[3], double cTimesW[3]) {
+#ifdef __AVX2__
+    __m256d prod = _mm256_mul_pd(_mm256_set1_pd(c), _mm256_maskload_pd(w, vecMASK3));
+    _mm256_maskstore_pd(cTimesW, vecMASK3, prod);
+#else
+    cTimesW[0] = c * w[0];
+    cTimesW[1] = c * w[1];
+    cTimesW[2] = c * w[2];
+#endif
+}
+
+/* Returns the dot product of the 3-dimensional vectors v and w. */
+double vec3Dot(const double v[3], const double w[3]) {
+#ifdef __AVX2__
+    return vecHorizontalSum(_mm256_mul_pd(_mm256_maskload_pd(v, vecMASK3), _mm256_maskload_pd(w, vecMASK3)));
+#else
+    return (v[0] * w[0] + v[2] * w[2]) + v[1] * w[1];
+#endif
+}
+
+/* Adds the 4-dimensional vectors v and w. */
+void vec4Add(const double v[4], const double w[4], double vPlusW[4]) {
+#ifdef __AVX2__
+    _mm256_storeu_pd(vPlusW, _mm256_add_pd(_mm256_loadu_pd(v), _mm256_loadu_pd(w)));
+#else
+    vPlusW[0] = v[0] + w[0];
+    vPlusW[1] = v[1] + w[1];
+    vPlusW[2] = v[2] + w[2];
+    vPlusW[3] = v[3] + w[3];
+#endif
+}
+
+/* Subtracts the 4-dimensional vectors v and w. */
+void vec4Subtract(const double v[4], const double w[4], double vMinusW[4]) {
+#ifdef __AVX2__
+    _mm256_storeu_pd(vMinusW, _mm256_sub_pd(_mm256_loadu_pd(v), _mm256_loadu_pd(w)));
+#else
+    vMinusW[0] = v[0] - w[0];
+    vMinusW[1] = v[1] - w[1];
+    vMinusW[2] = v[2] - w[2];
+    vMinusW[3] = v[3] - w[3];
+#endif
+}
+
+/* Scales the 4-dimensional vector w by the number c. */
+void vec4Scale(double c, const double w[4], double cTimesW[4]) {
+#ifdef __AVX2__
+    _mm256_storeu_pd(cTimesW, _mm256_mul_pd(_mm256_set1_pd(c), _mm256_loadu_pd(w)));
+#else
+    cTimesW[0] = c * w[0];
+    cTimesW[1] = c * w[1];
+    cTimesW[2] = c * w[2];
+    cTimesW[3] = c * w[3];
+#endif
+}
+
+/* Returns the dot product of the 4-dimensional vectors v and w. */
+double vec4Dot(const double v[4], const double w[4]) {
+#ifdef __AVX2__
+    return vecHorizontalSum(_mm256_mul_pd(_mm256_loadu_pd(v), _mm256_loadu_pd(w)));
+#else
+    return (v[0] * w[0] + v[2] * w[2]) + (v[1] * w[1] + v[3] * w[3]);
+#endif
+}
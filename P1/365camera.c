@@ -0,0 +1,263 @@
+/*
+    365camera.c
+    A camera class, used for projection transformations. Upgraded from 300camera.c to work on reals
+    (see 365real.c), so that the same source replaces both 300camera.c and the float copy 490camera.c.
+    The projection matrices follow OpenGL conventions, as in 300camera.c, unless CAMVULKAN is defined
+    as 1 before including this file. Then they are multiplied by camVulkan to match Vulkan
+    conventions, as in 490camera.c, and the inverse projections are multiplied by its inverse.
+    Designed by Josh Davis for Carleton College's CS311 - Computer Graphics.
+    Implementations written by Cole Weinstein and Robbie Young.
+*/
+
+#ifndef CAMVULKAN
+#define CAMVULKAN 0
+#endif
+
+
+/* Feel free to read from this struct's members, but don't write to them. */
+typedef struct camCamera camCamera;
+struct camCamera {
+	real projection[6];
+	int projectionType;
+	isoIsometry isometry;
+};
+
+#if CAMVULKAN
+/* Matrix used to make our projection matrices match Vulkan conventions. It 
+flips y and maps z from [-1, 1] to [0, 1]. */
+const real camVulkan[4][4] = {
+    {1.0, 0.0, 0.0, 0.0}, 
+    {0.0, -1.0, 0.0, 0.0}, 
+    {0.0, 0.0, 0.5, 0.5}, 
+    {0.0, 0.0, 0.0, 1.0}};
+
+/* Inverse to camVulkan. */
+const real camInverseVulkan[4][4] = {
+    {1.0, 0.0, 0.0, 0.0}, 
+    {0.0, -1.0, 0.0, 0.0}, 
+    {0.0, 0.0, 2.0, -1.0}, 
+    {0.0, 0.0, 0.0, 1.0}};
+#endif
+
+/* Converts a projection matrix built with OpenGL conventions to the 
+conventions that the camera uses. The output CANNOT safely alias the input. */
+void camConvertProjection(const real base[4][4], real proj[4][4]) {
+#if CAMVULKAN
+	mat444Multiply(camVulkan, base, proj);
+#else
+	vecCopy(16, (const real *)base, (real *)proj);
+#endif
+}
+
+/* Converts the inverse of a projection matrix built with OpenGL conventions, 
+so that it is inverse to the output of camConvertProjection. The output CANNOT 
+safely alias the input. */
+void camConvertInverseProjection(const real baseInv[4][4], real projInv[4][4]) {
+#if CAMVULKAN
+	mat444Multiply(baseInv, camInverseVulkan, projInv);
+#else
+	vecCopy(16, (const real *)baseInv, (real *)projInv);
+#endif
+}
+
+
+
+/*** Projections ***/
+
+#define camORTHOGRAPHIC 0
+#define camPERSPECTIVE 1
+#define camPROJL 0
+#define camPROJR 1
+#define camPROJB 2
+#define camPROJT 3
+#define camPROJF 4
+#define camPROJN 5
+
+/* Sets the projection type, to either camORTHOGRAPHIC or camPERSPECTIVE. */
+void camSetProjectionType(camCamera *cam, int projType) {
+	cam->projectionType = projType;
+}
+
+/* Sets all six projection parameters. */
+void camSetProjection(camCamera *cam, const real proj[6]) {
+	vecCopy(6, proj, cam->projection);
+}
+
+/* Sets one of the six projection parameters. */
+void camSetOneProjection(camCamera *cam, int i, real value) {
+	cam->projection[i] = value;
+}
+
+/* Builds a 4x4 matrix representing orthographic projection with a boxy viewing 
+volume [left, right] x [bottom, top] x [far, near]. That is, on the near plane 
+the box is the rectangle R = [left, right] x [bottom, top], and on the far 
+plane the box is the same rectangle R. Keep in mind that 0 > near > far. Maps 
+the viewing volume to [-1, 1] x [-1, 1] x [-1, 1], with far going to 1 and near 
+going to -1, and then applies camConvertProjection. */
+void camGetOrthographic(const camCamera *cam, real proj[4][4]) {
+	real base[4][4];
+	real left = cam->projection[camPROJL];
+	real right = cam->projection[camPROJR];
+	real bottom = cam->projection[camPROJB];
+	real top = cam->projection[camPROJT];
+	real far = cam->projection[camPROJF];
+	real near = cam->projection[camPROJN];
+	mat44Zero(base);
+    base[0][0] = 2.0 / (right - left);
+	base[0][3] = (-right - left) / (right - left);
+	base[1][1] = 2.0 / (top - bottom);
+	base[1][3] = (-top - bottom) / (top - bottom);
+	base[2][2] = -2.0 / (near - far);
+	base[2][3] = (near + far) / (near - far);
+	base[3][3] = 1.0;
+	camConvertProjection(base, proj);
+}
+
+/* Inverse to the matrix produced by camGetOrthographic. */
+void camGetInverseOrthographic(const camCamera *cam, real proj[4][4]) {
+	real base[4][4];
+	real left = cam->projection[camPROJL];
+	real right = cam->projection[camPROJR];
+	real bottom = cam->projection[camPROJB];
+	real top = cam->projection[camPROJT];
+	real far = cam->projection[camPROJF];
+	real near = cam->projection[camPROJN];
+	mat44Zero(base);
+	base[0][0] = (right - left) / 2.0;
+	base[0][3] = (right + left) / 2.0;
+	base[1][1] = (top - bottom) / 2.0;
+	base[1][3] = (top + bottom) / 2.0;
+	base[2][2] = (near - far) / -2.0;
+	base[2][3] = (near + far) / 2.0;
+	base[3][3] = 1.0;
+	camConvertInverseProjection(base, proj);
+}
+
+/* Builds a 4x4 matrix representing perspective projection. The viewing frustum 
+is contained between the near and far planes, with 0 > near > far. On the near 
+plane, the frustum is the rectangle R = [left, right] x [bottom, top]. On the 
+far plane, the frustum is the rectangle (far / near) * R. Maps the viewing 
+volume to [-1, 1] x [-1, 1] x [-1, 1], with far going to 1 and near going to 
+-1, and then applies camConvertProjection. */
+void camGetPerspective(const camCamera *cam, real proj[4][4]) {
+	real base[4][4];
+	real left = cam->projection[camPROJL];
+	real right = cam->projection[camPROJR];
+	real bottom = cam->projection[camPROJB];
+	real top = cam->projection[camPROJT];
+	real far = cam->projection[camPROJF];
+	real near = cam->projection[camPROJN];
+	mat44Zero(base);
+	base[0][0] = (-2.0 * near) / (right - left);
+	base[0][2] = (right + left) / (right - left);
+	base[1][1] = (-2.0 * near) / (top - bottom);
+	base[1][2] = (top + bottom) / (top - bottom);
+	base[2][2] = (near + far) / (near - far);
+	base[2][3] = (-2.0 * near * far) / (near - far);
+	base[3][2] = -1.0;
+	camConvertProjection(base, proj);
+}
+
+/* Inverse to the matrix produced by camGetPerspective. */
+void camGetInversePerspective(const camCamera *cam, real proj[4][4]) {
+	real base[4][4];
+	real left = cam->projection[camPROJL];
+	real right = cam->projection[camPROJR];
+	real bottom = cam->projection[camPROJB];
+	real top = cam->projection[camPROJT];
+	real far = cam->projection[camPROJF];
+	real near = cam->projection[camPROJN];
+	mat44Zero(base);
+	base[0][0] = (right - left) / (-2.0 * near);
+    base[0][3] = (right + left) / (-2.0 * near);
+    base[1][1] = (top - bottom) / (-2.0 * near);
+    base[1][3] = (top + bottom) / (-2.0 * near);
+    base[2][3] = -1.0;
+    base[3][2] = (near - far) / (-2.0 * near * far);
+    base[3][3] = (near + far) / (-2.0 * near * far);
+	camConvertInverseProjection(base, proj);
+}
+
+
+
+/*** Convenience functions for projection ***/
+
+/* Sets the six projection parameters, based on the width and height of the 
+viewport and three other parameters. The camera looks down the center of the 
+viewing volume. For perspective projection, fovy is the full (not half) 
+vertical angle of the field of vision, in radians. focal > 0 is the distance 
+from the camera to the 'focal' plane (where 'focus' is used in the sense of 
+attention, not optics). ratio expresses the far and near clipping planes 
+relative to focal: far = -focal * ratio and near = -focal / ratio. Reasonable 
+values are fovy = M_PI / 6.0, focal = 10.0, and ratio = 10.0, so that 
+far = -100.0 and near = -1.0. For orthographic projection, the projection 
+parameters are set to produce the orthographic projection that, at the focal 
+plane, is most similar to the perspective projection just described. You must 
+re-invoke this function after each time you resize the viewport. */
+void camSetFrustum(
+        camCamera *cam, real fovy, real focal, real ratio, real width, 
+        real height) {
+	cam->projection[camPROJF] = -focal * ratio;
+	cam->projection[camPROJN] = -focal / ratio;
+	real tanHalfFovy = tan(fovy * 0.5);
+	if (cam->projectionType == camPERSPECTIVE)
+		cam->projection[camPROJT] = -cam->projection[camPROJN] * tanHalfFovy;
+	else
+		cam->projection[camPROJT] = focal * tanHalfFovy;
+	cam->projection[camPROJB] = -cam->projection[camPROJT];
+	cam->projection[camPROJR] = cam->projection[camPROJT] * width / height;
+	cam->projection[camPROJL] = -cam->projection[camPROJR];
+}
+
+/* Returns the homogeneous 4x4 product of the camera's projection and the 
+camera's inverse isometry (regardless of whether the camera is in orthographic 
+or perspective mode). */
+void camGetProjectionInverseIsometry(const camCamera *cam, real homog[4][4]) {
+	real proj[4][4];
+    if (cam->projectionType == camORTHOGRAPHIC) {
+        camGetOrthographic(cam, proj);
+    } else {
+		camGetPerspective(cam, proj);
+	}
+    real invIsom[4][4];
+    isoGetInverseHomogeneous(&(cam->isometry), invIsom);
+    mat444Multiply(proj, invIsom, homog);
+}
+
+// /*** Convenience functions for isometry ***/
+
+/* Sets the camera's isometry, in a manner suitable for third-person viewing. 
+The camera is aimed at the world coordinates target. The camera itself is 
+displaced from that target by a distance rho, in the direction specified by the 
+spherical coordinates phi and theta (as in vec3Spherical). Under normal use, 
+where 0 < phi < pi, the camera's up-direction is world-up, or as close to it as 
+possible. */
+void camLookAt(
+        camCamera *cam, const real target[3], real rho, real phi, 
+		real theta) {
+	real z[3], y[3], yStd[3] = {0.0, 1.0, 0.0}, zStd[3] = {0.0, 0.0, 1.0};
+	real rot[3][3], trans[3];
+	vec3Spherical(1.0, phi, theta, z);
+	vec3Spherical(1.0, M_PI / 2.0 - phi, theta + M_PI, y);
+	mat33BasisRotation(yStd, zStd, y, z, rot);
+	isoSetRotation(&(cam->isometry), rot);
+	vecScale(3, rho, z, trans);
+	vecAdd(3, target, trans, trans);
+	isoSetTranslation(&(cam->isometry), trans);
+}
+
+/* Sets the camera's isometry, in a manner suitable for first-person viewing. 
+The camera is positioned at the world coordinates position. From that position, 
+the camera's sight direction is described by the spherical coordinates phi and 
+theta (as in vec3Spherical). Under normal use, where 0 < phi < pi, the camera's 
+up-direction is world-up, or as close to it as possible. */
+void camLookFrom(
+        camCamera *cam, const real position[3], real phi, real theta) {
+	real negZ[3], y[3], yStd[3] = {0.0, 1.0, 0.0};
+	real negZStd[3] = {0.0, 0.0, -1.0}, rot[3][3];
+	vec3Spherical(1.0, phi, theta, negZ);
+	vec3Spherical(1.0, M_PI / 2.0 - phi, theta + M_PI, y);
+	mat33BasisRotation(yStd, negZStd, y, negZ, rot);
+	isoSetRotation(&(cam->isometry), rot);
+	isoSetTranslation(&(cam->isometry), position);
+}
\ No newline at end of file
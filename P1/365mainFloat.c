@@ -0,0 +1,328 @@
+/*
+	365mainFloat.c
+	Runs the landscape of 362mainQuads.c through the renderer of the files numbered 365, which are
+	written once in terms of real (see 365real.c). By default real is a float, so the whole pipeline,
+	from the mesh and the texture through the varyings to the depth buffer, is in float32. Compile
+	with -DREALFLOAT=0 to get the same program in double. Either way, the program times FRAMENUM
+	whole frames and prints how much memory the mesh, texture, and depth buffer take. It saves the
+	last frame to 365float.rgb or 365double.rgb, and if the other build has already saved its frame,
+	it prints the largest difference between the two images. Then it shows the landscape as in
+	340mainLandscape.c.
+	Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+
+/* On macOS (Intel), compile with...
+    clang -O3 -c 040pixel.c -Wno-deprecated
+    clang -O3 -mavx2 365mainFloat.c 040pixel.o -lglfw -framework OpenGL -framework Cocoa -framework IOKit
+On Ubuntu, compile with...
+    cc -O3 -c 040pixel.c
+    cc -O3 -mavx2 365mainFloat.c 040pixel.o -lglfw -lGL -lm -ldl -lpthread
+Add -DREALFLOAT=0 to either for the double version. In float, the fixed-size
+math uses SSE, which every x86-64 processor has. In double, it needs -mavx2, and
+without it (for example on Apple silicon) falls back to unrolled loops.
+*/
+
+#define WINDOWWIDTH 512.0
+#define WINDOWHEIGHT 512.0
+
+#ifndef REALFLOAT
+#define REALFLOAT 1
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <GLFW/glfw3.h>
+#include <sys/time.h>
+
+#include "040pixel.h"
+
+#include "365real.c"
+#include "365vector.c"
+#include "365matrix.c"
+#include "365texture.c"
+#include "365shading.c"
+#include "363depth.c"
+#include "365triangle.c"
+#include "365mesh.c"
+#include "365mesh3D.c"
+#include "365isometry.c"
+#include "365camera.c"
+#include "365landscape.c"
+
+#define LANDSIZE 40
+#define FRAMENUM 100
+
+#define ATTRX 0
+#define ATTRY 1
+#define ATTRZ 2
+#define ATTRS 3
+#define ATTRT 4
+#define ATTRN 5
+#define ATTRO 6
+#define ATTRP 7
+#define VARYX 0
+#define VARYY 1
+#define VARYZ 2
+#define VARYW 3
+#define VARYS 4
+#define VARYT 5
+#define VARYN 6
+#define VARYO 7
+#define VARYP 8
+#define UNIFMODELING 0
+#define UNIFPROJINVISOM 16
+
+/* The first four entries of vary are assumed to be X, Y, Z, W. */
+void shadeVertexLand(
+        int unifDim, const real unif[], int attrDim, const real attr[],
+        int varyDim, real vary[]) {
+	real attrHomog[4] = {attr[ATTRX], attr[ATTRY], attr[ATTRZ], 1.0};
+	real modHomog[4];
+	mat441Multiply((real(*)[4])(&unif[UNIFMODELING]), attrHomog, modHomog);
+	mat441Multiply((real(*)[4])(&unif[UNIFPROJINVISOM]), modHomog, vary);
+	vecCopy(5, &attr[ATTRS], &vary[VARYS]);
+}
+
+/* The per-fragment shader, as in 362mainQuads.c. */
+void shadeFragmentLand(
+        int unifDim, const real unif[], int texNum, const texTexture *tex[],
+        int varyDim, const real vary[], real rgbd[4]) {
+	real sample[tex[0]->texelDim];
+	texSample(tex[0], vary[VARYS], vary[VARYT], sample);
+	sample[0] = sample[1] * 0.2 + 0.8;
+	sample[1] = sample[1] * 0.2 + 0.6;
+	sample[2] = 0.3;
+	real intensity = vary[VARYP] / vecLength(3, &vary[VARYN]);
+	vecScale(3, intensity, sample, rgbd);
+	rgbd[3] = vary[VARYZ];
+}
+
+/* The group shader, as in 362mainQuads.c. Its constants are cast to real, so
+that in float the loop over the lanes stays in float, and the compiler fits
+twice as many lanes in each vector instruction. */
+void shadeFragmentsLand(
+        int unifDim, const real unif[], int texNum, const texTexture *tex[],
+        int varyDim, const real vary[], const real dVary[], int mask,
+        real rgbd[]) {
+	const int n = shaGROUPSIZE;
+	/* Texture sampling doesn't vectorize, so do it only where it's needed. */
+	real green[shaGROUPSIZE] = {0.0};
+	real sample[tex[0]->texelDim];
+	for (int l = 0; l < n; l += 1)
+		if (mask & (1 << l)) {
+			texSample(tex[0], vary[VARYS * n + l], vary[VARYT * n + l], sample);
+			green[l] = sample[1];
+		}
+	/* The rest is the same arithmetic in every lane. */
+	for (int l = 0; l < n; l += 1) {
+		real nx = vary[VARYN * n + l], ny = vary[VARYO * n + l];
+		real nz = vary[VARYP * n + l];
+		real intensity = nz / sqrt(nx * nx + ny * ny + nz * nz);
+		rgbd[l] = intensity * (green[l] * (real)0.2 + (real)0.8);
+		rgbd[n + l] = intensity * (green[l] * (real)0.2 + (real)0.6);
+		rgbd[2 * n + l] = intensity * (real)0.3;
+		rgbd[3 * n + l] = vary[VARYZ * n + l];
+	}
+}
+
+depthBuffer buf;
+shaShading sha;
+texTexture texture;
+const texTexture *textures[1] = {&texture};
+meshMesh landMesh;
+real unif[16 + 16] = {
+	1.0, 0.0, 0.0, 0.0,
+	0.0, 1.0, 0.0, 0.0,
+	0.0, 0.0, 1.0, 0.0,
+	0.0, 0.0, 0.0, 1.0};
+real viewport[4][4];
+camCamera cam;
+real angle = M_PI * 0.25;
+
+/* Returns the current time in seconds. */
+double benchTime(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (double)tv.tv_sec + (double)tv.tv_usec * 0.000001;
+}
+
+/* Builds a landscape mesh from a fixed seed, as 362mainQuads.c does. Returns
+an error code (0 on success). */
+int initializeLandscape(meshMesh *mesh, int size) {
+	real *landData = (real *)malloc(size * size * sizeof(real));
+	if (landData == NULL)
+		return 2;
+	landFlat(size, landData, 0.0);
+	srand(311);
+	for (int i = 0; i < 12; i += 1)
+		landFaultRandomly(size, landData, 1.0 - i * 0.04);
+	for (int i = 0; i < 4; i += 1)
+		landBlur(size, landData);
+	for (int i = 0; i < 4; i += 1)
+		landBump(size, landData, landInt(0, size - 1), landInt(0, size - 1),
+			5.0, 1.0);
+	int error = mesh3DInitializeLandscape(mesh, size, 1.0, landData);
+	free(landData);
+	if (error != 0)
+		return 1;
+	for (int i = 0; i < mesh->vertNum; i += 1) {
+		real *vertPtr = meshGetVertexPointer(mesh, i);
+		vertPtr[ATTRS] = 0.0;
+		vertPtr[ATTRT] = vertPtr[ATTRZ];
+	}
+	return 0;
+}
+
+/* Saves the window's RGB to the file at path, as width * height * 3 raw doubles.
+Returns an error code (0 on success). */
+int saveImage(const char *path, int rgbNum, double *rgb) {
+	FILE *file = fopen(path, "wb");
+	if (file == NULL) {
+		fprintf(stderr, "error: saveImage: could not open %s\n", path);
+		return 1;
+	}
+	pixCopyRGB(rgb);
+	int error = (fwrite(rgb, sizeof(double), rgbNum, file) != (size_t)rgbNum);
+	if (fclose(file) != 0)
+		error = 1;
+	if (error)
+		fprintf(stderr, "error: saveImage: could not write %s\n", path);
+	return error;
+}
+
+/* Reads an image saved by saveImage from the file at path and returns the
+largest difference between it and the doubles in rgb, or -1.0 if there is no
+such file of the right size. */
+double compareImage(const char *path, int rgbNum, const double *rgb) {
+	FILE *file = fopen(path, "rb");
+	if (file == NULL)
+		return -1.0;
+	double maxDiff = 0.0, other;
+	int i;
+	for (i = 0; i < rgbNum && fread(&other, sizeof(double), 1, file) == 1; i += 1)
+		if (fabs(other - rgb[i]) > maxDiff)
+			maxDiff = fabs(other - rgb[i]);
+	fclose(file);
+	return (i == rgbNum) ? maxDiff : -1.0;
+}
+
+void render(void) {
+	pixClearRGB(0.8, 0.8, 1.0);
+	depthClearDepths(&buf, 1000000000.0);
+	real projInvIsom[4][4];
+	camGetProjectionInverseIsometry(&cam, projInvIsom);
+	vecCopy(16, (real *)projInvIsom, &unif[UNIFPROJINVISOM]);
+	meshRender(&landMesh, &buf, viewport, &sha, unif, textures);
+}
+
+void handleKeyDownAndRepeat(
+        int key, int shiftIsDown, int controlIsDown, int altOptionIsDown,
+        int superCommandIsDown) {
+	real position[3];
+	vecCopy(3, cam.isometry.translation, position);
+	if (key == GLFW_KEY_W) {
+		real delta[3] = {cos(angle), sin(angle), 0.0};
+		vecAdd(3, position, delta, position);
+	} else if (key == GLFW_KEY_S) {
+		real delta[3] = {cos(angle), sin(angle), 0.0};
+		vecSubtract(3, position, delta, position);
+	} else if (key == GLFW_KEY_A)
+		angle += M_PI / 12.0;
+	else if (key == GLFW_KEY_D)
+		angle -= M_PI / 12.0;
+	else if (key == GLFW_KEY_Q)
+		position[2] -= 1.0;
+	else if (key == GLFW_KEY_E)
+		position[2] += 1.0;
+	camLookFrom(&cam, position, M_PI * 0.6, angle);
+}
+
+void handleTimeStep(double oldTime, double newTime) {
+	if (floor(newTime) - floor(oldTime) >= 1.0)
+		printf("handleTimeStep: %f frames/sec\n", 1.0 / (newTime - oldTime));
+	render();
+}
+
+int main(void) {
+	int depthFormat = REALFLOAT ? depthFLOAT : depthDOUBLE;
+	if (pixInitialize(WINDOWWIDTH, WINDOWHEIGHT, "Float") != 0)
+		return 1;
+	if (depthInitialize(&buf, WINDOWWIDTH, WINDOWHEIGHT, depthFormat) != 0) {
+		pixFinalize();
+		return 2;
+	}
+	if (texInitializeFile(&texture, "awesome.png") != 0) {
+		depthFinalize(&buf);
+		pixFinalize();
+		return 3;
+	}
+	if (initializeLandscape(&landMesh, LANDSIZE) != 0) {
+		texFinalize(&texture);
+		depthFinalize(&buf);
+		pixFinalize();
+		return 4;
+	}
+	texSetFiltering(&texture, texNEAREST);
+	texSetLeftRight(&texture, texREPEAT);
+	texSetTopBottom(&texture, texREPEAT);
+	sha.unifDim = 16 + 16;
+	sha.attrDim = 3 + 2 + 3;
+	sha.varyDim = 4 + 2 + 3;
+	sha.shadeVertex = shadeVertexLand;
+	sha.shadeFragment = shadeFragmentLand;
+	sha.shadeVertices = NULL;
+	sha.shadeFragments = shadeFragmentsLand;
+	sha.texNum = 1;
+	mat44Viewport(WINDOWWIDTH, WINDOWHEIGHT, viewport);
+	camSetProjectionType(&cam, camPERSPECTIVE);
+	camSetFrustum(&cam, M_PI / 6.0, 10.0, 10.0, WINDOWWIDTH, WINDOWHEIGHT);
+	real position[3] = {-5.0, -5.0, 20.0};
+	camLookFrom(&cam, position, M_PI * 0.6, angle);
+	printf("main: real is %s, fixed-size math %s\n",
+		REALFLOAT ? "float" : "double",
+		realSIMD ? "uses SIMD" : "uses the scalar fallbacks");
+	printf("memory: mesh %d bytes, texture %d bytes, depth buffer %d bytes\n",
+		landMesh.vertNum * landMesh.attrDim * (int)sizeof(real),
+		texture.width * texture.height * texture.texelDim * (int)sizeof(real),
+		buf.width * buf.height * depthGetFormatSize(depthFormat));
+	/* Whole frames, after one untimed frame. */
+	render();
+	double start = benchTime();
+	for (int i = 0; i < FRAMENUM; i += 1)
+		render();
+	printf("frames: %f ms/frame\n", (benchTime() - start) / FRAMENUM * 1000.0);
+	/* Compare the last frame against the other precision's, if it's saved. */
+	int rgbNum = pixGetWidth() * pixGetHeight() * 3;
+	double *rgb = (double *)malloc(rgbNum * sizeof(double));
+	if (rgb == NULL) {
+		fprintf(stderr, "error: main: malloc failed\n");
+		meshFinalize(&landMesh);
+		texFinalize(&texture);
+		depthFinalize(&buf);
+		pixFinalize();
+		return 5;
+	}
+	const char *path = REALFLOAT ? "365float.rgb" : "365double.rgb";
+	const char *otherPath = REALFLOAT ? "365double.rgb" : "365float.rgb";
+	if (saveImage(path, rgbNum, rgb) == 0) {
+		double maxDiff = compareImage(otherPath, rgbNum, rgb);
+		if (maxDiff < 0.0)
+			printf("images: saved %s; run the other build to compare\n", path);
+		else
+			printf("images: max difference from %s %g\n", otherPath, maxDiff);
+	}
+	free(rgb);
+	/* Run user interface. */
+	pixSetKeyDownHandler(handleKeyDownAndRepeat);
+	pixSetKeyRepeatHandler(handleKeyDownAndRepeat);
+	pixSetTimeStepHandler(handleTimeStep);
+	pixRun();
+	/* Clean up. */
+	meshFinalize(&landMesh);
+	texFinalize(&texture);
+	depthFinalize(&buf);
+	pixFinalize();
+	return 0;
+}
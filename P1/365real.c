@@ -0,0 +1,112 @@
+/*
+    365real.c
+    The scalar type of the precision-generic math library. 365vector.c, 365matrix.c, 365isometry.c,
+    365camera.c, and the software renderer files numbered 365 are written once, in terms of real
+    rather than double or float, so that one source serves both projects: the software renderer in
+    double or float, and the Vulkan demos in float.
+    The precision is controlled by REALFLOAT, much as statistics are controlled by STATS in
+    353stats.c. Define REALFLOAT as 1 before including this file to make real a float. Otherwise
+    REALFLOAT defaults to 0, and real is a double, as in 250vector.c and 280matrix.c. Include this
+    file before any of the others numbered 365.
+    Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+#ifndef REALFLOAT
+#define REALFLOAT 0
+#endif
+
+/* tgmath.h replaces the functions of math.h, such as sin and sqrt, with macros
+that pick the float or double version by the type of their argument. So sin(x)
+calls sinf when x is a real and REALFLOAT is 1, and there is no need for a
+second copy of any code that calls them. Constants such as 2.0 are still
+doubles, so, on hot paths, write them as (real)2.0 to keep the arithmetic in
+float. */
+#include <math.h>
+#include <tgmath.h>
+
+#if REALFLOAT
+typedef float real;
+#else
+typedef double real;
+#endif
+
+
+
+/*** Registers of four reals ***/
+
+/* The fixed-size vector and matrix functions work on registers of four reals.
+For floats, that is an SSE register, which every x86-64 processor has. For
+doubles, it is an AVX register, which needs -mavx2. realSIMD is 1 when the
+registers are available, and then the macros below wrap the intrinsics for the
+current precision. Otherwise realSIMD is 0, and the callers fall back to
+unrolled loops. Either way, a float register holds as many lanes as a double
+one, in half the bits, so the float version moves half as much memory. */
+
+#if REALFLOAT && defined(__SSE__)
+#define realSIMD 1
+#include <xmmintrin.h>
+
+typedef __m128 realV4;
+#define realLoad4(v) _mm_loadu_ps(v)
+#define realStore4(v, r) _mm_storeu_ps(v, r)
+#define realSet4(x) _mm_set1_ps(x)
+#define realAdd4(r, s) _mm_add_ps(r, s)
+#define realSub4(r, s) _mm_sub_ps(r, s)
+#define realMul4(r, s) _mm_mul_ps(r, s)
+/* Transposes the four registers, in place, as the rows of a 4x4 matrix. */
+#define realTRANSPOSE4(r0, r1, r2, r3) _MM_TRANSPOSE4_PS(r0, r1, r2, r3)
+
+/* Loads a 3-dimensional vector into the first three lanes of a register, with
+0 in the fourth. */
+realV4 realLoad3(const real v[3]) {
+    return _mm_setr_ps(v[0], v[1], v[2], 0.0f);
+}
+
+/* Stores the first three lanes of a register into a 3-dimensional vector. */
+void realStore3(real v[3], realV4 r) {
+    _mm_storel_pi((__m64 *)v, r);
+    _mm_store_ss(&v[2], _mm_movehl_ps(r, r));
+}
+
+/* Adds up the four lanes of a register, as (r0 + r2) + (r1 + r3). */
+real realSum4(realV4 r) {
+    __m128 pair = _mm_add_ps(r, _mm_movehl_ps(r, r));
+    return _mm_cvtss_f32(_mm_add_ss(pair, _mm_shuffle_ps(pair, pair, 1)));
+}
+
+#elif !REALFLOAT && defined(__AVX2__)
+#define realSIMD 1
+#include <immintrin.h>
+
+typedef __m256d realV4;
+#define realLoad4(v) _mm256_loadu_pd(v)
+#define realStore4(v, r) _mm256_storeu_pd(v, r)
+#define realSet4(x) _mm256_set1_pd(x)
+#define realAdd4(r, s) _mm256_add_pd(r, s)
+#define realSub4(r, s) _mm256_sub_pd(r, s)
+#define realMul4(r, s) _mm256_mul_pd(r, s)
+/* Masks selecting the first three lanes of a register. */
+#define realMASK3 _mm256_setr_epi64x(-1, -1, -1, 0)
+#define realLoad3(v) _mm256_maskload_pd(v, realMASK3)
+#define realStore3(v, r) _mm256_maskstore_pd(v, realMASK3, r)
+
+/* Transposes the four registers as the rows of a 4x4 matrix. */
+void realTranspose4(realV4 *r0, realV4 *r1, realV4 *r2, realV4 *r3) {
+    __m256d t0 = _mm256_unpacklo_pd(*r0, *r1), t1 = _mm256_unpackhi_pd(*r0, *r1);
+    __m256d t2 = _mm256_unpacklo_pd(*r2, *r3), t3 = _mm256_unpackhi_pd(*r2, *r3);
+    *r0 = _mm256_permute2f128_pd(t0, t2, 0x20);
+    *r1 = _mm256_permute2f128_pd(t1, t3, 0x20);
+    *r2 = _mm256_permute2f128_pd(t0, t2, 0x31);
+    *r3 = _mm256_permute2f128_pd(t1, t3, 0x31);
+}
+#define realTRANSPOSE4(r0, r1, r2, r3) realTranspose4(&(r0), &(r1), &(r2), &(r3))
+
+/* Adds up the four lanes of a register, as (r0 + r2) + (r1 + r3). */
+real realSum4(realV4 r) {
+    __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(r), _mm256_extractf128_pd(r, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+#else
+#define realSIMD 0
+#endif
@@ -0,0 +1,223 @@
+/*
+    365triangle.c
+    C file to rasterize a given triangle and render it. triRender and its subcalls interpolate the varyings passed into it, then invoke the shader for fragment colors and depths (after any number and type of artistic transformations). Only set pixel if fragment is
+    the closest fragment to screen so far.
+    Upgraded from 362triangle.c to interpolate and shade in reals (see 365real.c). The edge functions stay in fixed
+    point, so coverage is exactly as in 362triangle.c in either precision. The depth buffer of 363depth.c takes its
+    depths as doubles, so each group's depths are widened on their way to depthTestGroup; use a depthFLOAT buffer to
+    keep the stored depths in float. Passing pixels are written in spans, as in 362triangle.c.
+    Requires 365shading.c and 363depth.c.
+    Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+/* Vertices are snapped to multiples of 1 / triSUBPIXELS of a pixel. */
+#define triSUBPIXELBITS 8
+#define triSUBPIXELS (1 << triSUBPIXELBITS)
+/* Triangles reaching farther than this many pixels from the origin are not drawn, because their edge functions could
+overflow. The window is much smaller than this guard band, so in practice only triangles that graze the near plane are lost. */
+#define triGUARDBAND 524288.0
+
+void createA(const real a[], const real b[], const real c[], real m[2][2]) {
+    real bMinusA[2];
+    real cMinusA[2];
+    vecSubtract(2, b, a, bMinusA);
+    vecSubtract(2, c, a, cMinusA);
+    mat22Columns(bMinusA, cMinusA, m);
+}
+
+/* Returns 1 if the edge from p to q, in snapped coordinates, is a top edge or a left edge of a counterclockwise
+triangle, and 0 otherwise. Going counterclockwise, a left edge runs downward, and a top edge runs horizontally to the
+left. */
+int triIsTopLeft(const long long p[2], const long long q[2]) {
+    return (q[1] < p[1]) || (q[1] == p[1] && q[0] < p[0]);
+}
+
+/* Interpolates, shades, and depth-tests the group whose lower left pixel is (i, j), and sets the pixels that pass.
+mask holds the lanes that are inside the triangle and the buffer. dVary is as for shadeFragments. */
+void setGroup(
+    const shaShading *sha, depthBuffer *buf, const real unif[], const texTexture *tex[], int i, int j, int mask,
+    const real a[], const real invertedItpCoeffs[2][2],
+    const real bMinusA[], const real cMinusA[], const real dVary[]) {
+    // interpolates the varyings at the lower left pixel, then steps them to the other lanes.
+    real xMinusA[2] = {i - a[0], j - a[1]};
+    real pq[2];
+    mat221Multiply(invertedItpCoeffs, xMinusA, pq);
+    real vary[sha->varyDim * shaGROUPSIZE];
+    const real *dVaryDx = dVary, *dVaryDy = &dVary[sha->varyDim];
+    for (int v = 0; v < sha->varyDim; v += 1) {
+        real base = a[v] + pq[0] * bMinusA[v] + pq[1] * cMinusA[v];
+        for (int l = 0; l < shaGROUPSIZE; l += 1)
+            vary[v * shaGROUPSIZE + l] = base + shaLANEX(l) * dVaryDx[v] + shaLANEY(l) * dVaryDy[v];
+    }
+
+    // shades the group, then keeps only the fragments that are closer than what's already there.
+    real rgbd[4 * shaGROUPSIZE] = {0.0};
+    shaShadeFragments(sha, unif, tex, vary, dVary, mask, rgbd);
+    double depths[shaGROUPSIZE];
+    for (int l = 0; l < shaGROUPSIZE; l += 1)
+        depths[l] = rgbd[3 * shaGROUPSIZE + l];
+    int passMask = depthTestGroup(buf, i, j, mask, depths);
+    if (passMask == 0)
+        return;
+
+    // writes each row of the group as a few spans, as 362triangle.c does. The pixel system takes doubles, so each row's 
+    // colors are widened as they are packed.
+    for (int y = 0; y < shaGROUPSIZE / 4; y += 1) {
+        int rowMask = (passMask >> (4 * y)) & 15;
+        double rgb[3 * 4];
+        for (int x = 0; x < 4; x += 1) {
+            int l = 4 * y + x;
+            rgb[3 * x] = rgbd[l];
+            rgb[3 * x + 1] = rgbd[shaGROUPSIZE + l];
+            rgb[3 * x + 2] = rgbd[2 * shaGROUPSIZE + l];
+        }
+        int x = 0;
+        while (x < 4) {
+            if (!(rowMask & (1 << x))) {
+                x += 1;
+                continue;
+            }
+            int start = x;
+            while (x < 4 && (rowMask & (1 << x)))
+                x += 1;
+            pixSetSpanRGB(i + start, j + y, x - start, &rgb[3 * start]);
+        }
+    }
+}
+
+/* Rasterizes the triangle and renders it. Assumes that the 0th and 1th elements of a, b, c are the 'x' and 'y'
+coordinates of the vertices, respectively (used in rasterization, and to interpolate the other elements of a, b, c).
+The vertices may come in any order. */
+void triRenderHelper(
+        const shaShading *sha, depthBuffer *buf, const real unif[], const texTexture *tex[],
+        const real a[], const real b[], const real c[]) {
+    // snaps the vertices to the subpixel grid.
+    const real *verts[3] = {a, b, c};
+    long long v[3][2];
+    for (int k = 0; k < 3; k += 1)
+        for (int i = 0; i < 2; i += 1) {
+            if (fabs(verts[k][i]) > triGUARDBAND)
+                return;
+            v[k][i] = llround(verts[k][i] * triSUBPIXELS);
+        }
+
+    // twice the signed area, in square subpixels. Implements backface culling: if it is negative or zero, the
+    // triangle does not render. Because it is exact, triangles that snapping has made degenerate are culled too.
+    long long area = (v[1][0] - v[0][0]) * (v[2][1] - v[0][1]) - (v[1][1] - v[0][1]) * (v[2][0] - v[0][0]);
+    if (area <= 0)
+        return;
+
+    // creates the matrix A (to find p and q for the purposes of linear interpolation) and inverts it. The
+    // interpolation uses the unsnapped vertices, as in 270triangle.c.
+    real interpolateCoeffs[2][2];
+    real invertedItpCoeffs[2][2];
+    createA(a, b, c, interpolateCoeffs);
+    if (mat22Invert(interpolateCoeffs, invertedItpCoeffs) <= 0)
+        return;
+
+    // computes 'b - a' and 'c - a', and from them the change in the varyings per pixel to the right and per pixel up.
+    // moving right by one pixel changes p and q by the first column of the inverse, and moving up by the second.
+    real bMinusA[sha->varyDim];
+    real cMinusA[sha->varyDim];
+    real dVary[2 * sha->varyDim];
+    vecSubtract(sha->varyDim, b, a, bMinusA);
+    vecSubtract(sha->varyDim, c, a, cMinusA);
+    for (int k = 0; k < sha->varyDim; k += 1) {
+        dVary[k] = invertedItpCoeffs[0][0] * bMinusA[k] + invertedItpCoeffs[1][0] * cMinusA[k];
+        dVary[sha->varyDim + k] = invertedItpCoeffs[0][1] * bMinusA[k] + invertedItpCoeffs[1][1] * cMinusA[k];
+    }
+
+    // finds the pixels in the bounding box of the snapped triangle, clipped to the depth buffer. Pixel (i, j) is
+    // sampled at the point (i, j), as in 270triangle.c.
+    long long minX = v[0][0], maxX = v[0][0], minY = v[0][1], maxY = v[0][1];
+    for (int k = 1; k < 3; k += 1) {
+        minX = (v[k][0] < minX) ? v[k][0] : minX;
+        maxX = (v[k][0] > maxX) ? v[k][0] : maxX;
+        minY = (v[k][1] < minY) ? v[k][1] : minY;
+        maxY = (v[k][1] > maxY) ? v[k][1] : maxY;
+    }
+    int iMin = (int)ceil((double)minX / triSUBPIXELS);
+    int iMax = (int)floor((double)maxX / triSUBPIXELS);
+    int jMin = (int)ceil((double)minY / triSUBPIXELS);
+    int jMax = (int)floor((double)maxY / triSUBPIXELS);
+    iMin = (iMin < 0) ? 0 : iMin;
+    jMin = (jMin < 0) ? 0 : jMin;
+    iMax = (iMax > buf->width - 1) ? buf->width - 1 : iMax;
+    jMax = (jMax > buf->height - 1) ? buf->height - 1 : jMax;
+    if (iMin > iMax || jMin > jMax)
+        return;
+
+    // the blocks start at even coordinates, so that their quads line up from one triangle to the next.
+    int iStart = iMin & ~1, jStart = jMin & ~1;
+
+    // sets up the edge function of each edge, from v[k] to v[k + 1], at pixel (iStart, jStart), as in 361triangle.c.
+    // also finds how far each lane of a block is from the block's lower left pixel, in edge function units.
+    long long edge[3], stepI[3], stepJ[3], laneStep[3][shaGROUPSIZE];
+    for (int k = 0; k < 3; k += 1) {
+        const long long *p = v[k], *q = v[(k + 1) % 3];
+        long long dx = q[0] - p[0], dy = q[1] - p[1];
+        edge[k] = dx * ((long long)jStart * triSUBPIXELS - p[1]) - dy * ((long long)iStart * triSUBPIXELS - p[0]);
+        if (!triIsTopLeft(p, q))
+            edge[k] -= 1;
+        stepI[k] = -dy * triSUBPIXELS;
+        stepJ[k] = dx * triSUBPIXELS;
+        for (int l = 0; l < shaGROUPSIZE; l += 1)
+            laneStep[k][l] = shaLANEX(l) * stepI[k] + shaLANEY(l) * stepJ[k];
+    }
+
+    // finds which lanes of a block are inside the bounding box, on the first and last rows and columns of blocks.
+    // everywhere else, all of them are.
+    int left = 0, right = 0, bottom = 0, top = 0;
+    for (int l = 0; l < shaGROUPSIZE; l += 1) {
+        left |= (iStart + shaLANEX(l) >= iMin) << l;
+        bottom |= (jStart + shaLANEY(l) >= jMin) << l;
+        right |= (shaLANEX(l) <= (iMax - iStart) % 4) << l;
+        top |= (shaLANEY(l) <= (jMax - jStart) % 2) << l;
+    }
+    int iLast = iStart + (iMax - iStart) / 4 * 4, jLast = jStart + (jMax - jStart) / 2 * 2;
+
+    // now, we render the triangle, a row of blocks at a time. a pixel is inside when all three edge functions are
+    // nonnegative, which is when their bitwise OR is. since the triangle is convex, once a row of pixels has entered
+    // and left it, the rest of that row is outside. the two rows of pixels in a row of blocks can be covered far apart
+    // when the triangle is thin, so the loop only stops early once both rows are done.
+    for (int j = jStart; j <= jMax; j += 2) {
+        long long e0 = edge[0], e1 = edge[1], e2 = edge[2];
+        int rowMask = 0xff;
+        rowMask &= (j == jStart) ? bottom : 0xff;
+        rowMask &= (j == jLast) ? top : 0xff;
+        int entered[2] = {0, 0};
+        int done[2] = {(rowMask & 0x0f) == 0, (rowMask & 0xf0) == 0};
+        for (int i = iStart; i <= iMax && !(done[0] && done[1]); i += 4) {
+            int mask = 0;
+            for (int l = 0; l < shaGROUPSIZE; l += 1)
+                mask |= ((e0 + laneStep[0][l]) | (e1 + laneStep[1][l]) | (e2 + laneStep[2][l])) >= 0 ? 1 << l : 0;
+            mask &= rowMask;
+            mask &= (i == iStart) ? left : 0xff;
+            mask &= (i == iLast) ? right : 0xff;
+            if (mask != 0)
+                setGroup(sha, buf, unif, tex, i, j, mask, a, invertedItpCoeffs, bMinusA, cMinusA, dVary);
+            for (int r = 0; r < 2; r += 1) {
+                if (mask & (0x0f << (4 * r)))
+                    entered[r] = 1;
+                else if (entered[r])
+                    done[r] = 1;
+            }
+            e0 += 4 * stepI[0];
+            e1 += 4 * stepI[1];
+            e2 += 4 * stepI[2];
+        }
+        edge[0] += 2 * stepJ[0];
+        edge[1] += 2 * stepJ[1];
+        edge[2] += 2 * stepJ[2];
+    }
+}
+
+/* Assumes that the 0th and 1th elements of a, b, c are the 'x' and 'y' coordinates of the vertices,
+respectively (used in rasterization, and to interpolate the other elements of a, b, c). */
+/* Backface culling check performed in triRenderHelper(); as in 361triangle.c, there's no need to find the left-most
+vertex first. */
+void triRender(
+        const shaShading *sha, depthBuffer *buf, const real unif[], const texTexture *tex[],
+        const real a[], const real b[], const real c[]) {
+    triRenderHelper(sha, buf, unif, tex, a, b, c);
+}
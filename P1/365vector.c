@@ -0,0 +1,232 @@
+/*
+    365vector.c
+    A simple program to modify vectors and teach basic vector arithmetic. Upgraded from 364vector.c
+    to work on reals (see 365real.c) rather than doubles, so that the same source serves both
+    the double rasterizer and float code like P2's. The fixed-size functions use registers of four
+    reals when 365real.c provides them, and fall back to unrolled loops otherwise.
+    Written by Josh Davis for Carleton College's CS311 - Computer Graphics.
+    Implementations written by Cole Weinstein and Robbie Young.
+*/
+
+/*** In general dimensions ***/
+
+/* Copies the dim-dimensional vector v to the dim-dimensional vector copy. The 
+output can safely alias the input. */
+void vecCopy(int dim, const real v[], real copy[]) {
+    for (int i = 0; i < dim; i += 1)
+        copy[i] = v[i];
+}
+
+/* Adds the dim-dimensional vectors v and w. The output can safely alias the 
+input. */
+void vecAdd(int dim, const real v[], const real w[], real vPlusW[]) {
+    for (int i = 0; i < dim; i += 1)
+        vPlusW[i] = v[i] + w[i];
+}
+
+/* Subtracts the dim-dimensional vectors v and w. The output can safely alias 
+the input. */
+void vecSubtract(
+        int dim, const real v[], const real w[], real vMinusW[]) {
+    for (int i = 0; i < dim; i += 1)
+        vMinusW[i] = v[i] - w[i];
+}
+
+/* Scales the dim-dimensional vector w by the number c. The output can safely 
+alias the input.*/
+void vecScale(int dim, real c, const real w[], real cTimesW[]) {
+    for (int i = 0; i < dim; i += 1)
+        cTimesW[i] = c * w[i];
+}
+
+/* Given two vectors v and w of the same dimension, produces a third vector of 
+the same dimension, obtained by multiplying v and w component-wise. The output 
+can safely alias the input. */
+void vecModulate(int dim, const real v[], const real w[], real vw[]) {
+    for (int i = 0; i < dim; i += 1)
+        vw[i] = v[i] * w[i];
+}
+
+
+
+/*** In specific dimensions ***/
+
+/* By the way, it is possible, using stdarg.h, to write a single vecSet function 
+that works in all dimensions. We're not going to take this approach for two 
+reasons. First, I try not to burden you with learning a lot of C that isn't 
+strictly necessary. Second, it's dangerous, in that it provides no type 
+checking. */
+
+/* Copies three numbers into a three-dimensional vector. */
+void vec3Set(real a0, real a1, real a2, real a[3]) {
+    a[0] = a0;
+    a[1] = a1;
+    a[2] = a2;
+}
+
+/* Copies four numbers into a four-dimensional vector. */
+void vec4Set(real a0, real a1, real a2, real a3, real a[4]) {
+    a[0] = a0;
+    a[1] = a1;
+    a[2] = a2;
+    a[3] = a3;
+}
+
+/* Copies eight numbers into an eight-dimensional vector. */
+void vec8Set(
+        real a0, real a1, real a2, real a3, real a4, real a5, 
+        real a6, real a7, real a[8]) {
+    a[0] = a0;
+    a[1] = a1;
+    a[2] = a2;
+    a[3] = a3;
+    a[4] = a4;
+    a[5] = a5;
+    a[6] = a6;
+    a[7] = a7;
+}
+
+/* Returns the dot product of the vectors v and w. */
+real vecDot(int dim, const real v[], const real w[]) {
+    real dot = 0;
+    for (int i = 0 ; i < dim ; i++) {
+        dot += (v[i] * w[i]);
+    }
+    return dot;
+}
+
+/* Returns the length of the vector v. */
+real vecLength(int dim, const real v[]) {
+    real length = 0;
+    for (int i = 0 ; i < dim ; i++) {
+        length += v[i] * v[i];
+    }
+    return sqrt(length);
+}
+
+/* Returns the length of the vector v. If the length is non-zero, then also 
+places a normalized (length-1) version of v into unit. The output can safely 
+alias the input. */
+real vecUnit(int dim, const real v[], real unit[]) {
+    real length = vecLength(dim, v);
+    if (length != 0) {
+        for (int i = 0 ; i < dim ; i++) {
+            unit[i] = v[i]/length;
+        }
+    }
+    return length;
+}
+
+/* Computes the cross product of v and w, and places it into vCrossW. The 
+output CANNOT safely alias the input. */
+void vec3Cross(const real v[3], const real w[3], real vCrossW[3]) {
+    vCrossW[0] = v[1] * w[2] - v[2] * w[1];
+    vCrossW[1] = v[2] * w[0] - v[0] * w[2];
+    vCrossW[2] = v[0] * w[1] - v[1] * w[0];
+}
+
+/* Computes the vector v from its spherical coordinates. rho >= 0.0 is the 
+radius. 0 <= phi <= pi is the co-latitude. -pi <= theta <= pi is the longitude 
+or azimuth. */
+void vec3Spherical(real rho, real phi, real theta, real v[3]) {
+    v[0] = rho * sin(phi) * cos(theta);
+    v[1] = rho * sin(phi) * sin(theta);
+    v[2] = rho * cos(phi);
+}
+
+
+
+/*** In specific dimensions, with SIMD ***/
+
+/* These do the same as the general-dimension functions above with dim equal to
+3 or 4, and their outputs can safely alias their inputs in the same way. The
+3-dimensional ones touch only the three entries of each vector, so they are
+safe on vectors packed inside larger arrays, such as varyings. The dot products
+add in the same order with or without SIMD, so they agree exactly. */
+
+/* Adds the 3-dimensional vectors v and w. */
+void vec3Add(const real v[3], const real w[3], real vPlusW[3]) {
+#if realSIMD
+    realStore3(vPlusW, realAdd4(realLoad3(v), realLoad3(w)));
+#else
+    vPlusW[0] = v[0] + w[0];
+    vPlusW[1] = v[1] + w[1];
+    vPlusW[2] = v[2] + w[2];
+#endif
+}
+
+/* Subtracts the 3-dimensional vectors v and w. */
+void vec3Subtract(const real v[3], const real w[3], real vMinusW[3]) {
+#if realSIMD
+    realStore3(vMinusW, realSub4(realLoad3(v), realLoad3(w)));
+#else
+    vMinusW[0] = v[0] - w[0];
+    vMinusW[1] = v[1] - w[1];
+    vMinusW[2] = v[2] - w[2];
+#endif
+}
+
+/* Scales the 3-dimensional vector w by the number c. */
+void vec3Scale(real c, const real w[3], real cTimesW[3]) {
+#if realSIMD
+    realStore3(cTimesW, realMul4(realSet4(c), realLoad3(w)));
+#else
+    cTimesW[0] = c * w[0];
+    cTimesW[1] = c * w[1];
+    cTimesW[2] = c * w[2];
+#endif
+}
+
+/* Returns the dot product of the 3-dimensional vectors v and w. */
+real vec3Dot(const real v[3], const real w[3]) {
+#if realSIMD
+    return realSum4(realMul4(realLoad3(v), realLoad3(w)));
+#else
+    return (v[0] * w[0] + v[2] * w[2]) + v[1] * w[1];
+#endif
+}
+
+/* Adds the 4-dimensional vectors v and w. */
+void vec4Add(const real v[4], const real w[4], real vPlusW[4]) {
+#if realSIMD
+    realStore4(vPlusW, realAdd4(realLoad4(v), realLoad4(w)));
+#else
+    vPlusW[0] = v[0] + w[0];
+    vPlusW[1] = v[1] + w[1];
+    vPlusW[2] = v[2] + w[2];
+    vPlusW[3] = v[3] + w[3];
+#endif
+}
+
+/* Subtracts the 4-dimensional vectors v and w. */
+void vec4Subtract(const real v[4], const real w[4], real vMinusW[4]) {
+#if realSIMD
+    realStore4(vMinusW, realSub4(realLoad4(v), realLoad4(w)));
+#else
+    vMinusW[0] = v[0] - w[0];
+    vMinusW[1] = v[1] - w[1];
+    vMinusW[2] = v[2] - w[2];
+    vMinusW[3] = v[3] - w[3];
+#endif
+}
+
+/* Scales the 4-dimensional vector w by the number c. */
+void vec4Scale(real c, const real w[4], real cTimesW[4]) {
+#if realSIMD
+    realStore4(cTimesW, realMul4(realSet4(c), realLoad4(w)));
+#else
+    cTimesW[0] = c * w[0];
+    cTimesW[1] = c * w[1];
+    cTimesW[2] = c * w[2];
+    cTimesW[3] = c * w[3];
+#endif
+}
+
+/* Returns the dot product of the 4-dimensional vectors v and w. */
+real vec4Dot(const real v[4], const real w[4]) {
+#if realSIMD
+    return realSum4(realMul4(realLoad4(v), realLoad4(w)));
+#else
+    return (v[0] * w[0] + v[2] * w[2]) + (v[1] * w[1] + v[3] * w[3]);
+#endif
+}
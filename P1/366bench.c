@@ -0,0 +1,142 @@
+/*
+    366bench.c
+    A small framework for timing individual kernels in isolation. A kernel is a function that runs
+    some primitive, such as mat444Multiply or texSample, a given number of times. benchRun first
+    finds how many runs make a repetition last at least benchMINSECONDS, so that the clock's
+    resolution doesn't matter, then runs benchWARMUPNUM untimed repetitions, so that caches and
+    branch predictors are warm, and then times repNum repetitions. It records the minimum, median,
+    99th percentile, and mean time per run. The median is what to compare between commits, because
+    a few repetitions are always slowed by interrupts and other programs; the 99th percentile shows
+    how bad those are. benchPrintJSON prints the results as JSON, one benchmark per line, so that
+    the files from two commits can be compared with diff.
+    Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+#include <string.h>
+#include <time.h>
+
+#define benchMAXRESULTS 64
+#define benchMAXREPS 1000
+#define benchNAMELENGTH 64
+#define benchMINSECONDS 0.0002
+#define benchWARMUPNUM 10
+
+/* Tells the compiler that value is used, so that it can't skip computing it.
+If value is a pointer, then the memory it points to is used, too. Like
+benchClobberMemory, it costs no instructions. */
+#define benchDoNotOptimize(value) __asm__ __volatile__("" : : "g"(value) : "memory")
+
+/* Tells the compiler that any memory may have been read or written, so that it
+can't skip storing results that are overwritten by the next run, or hoist loads
+out of the loop. */
+#define benchClobberMemory() __asm__ __volatile__("" : : : "memory")
+
+/* Feel free to read the struct's members, but don't write them, except
+through the functions below. The times are in nanoseconds per run. */
+typedef struct benchResult benchResult;
+struct benchResult {
+    char name[benchNAMELENGTH];
+    int runNum;             /* runs of the kernel per repetition */
+    int repNum;             /* timed repetitions */
+    double minNS, medianNS, p99NS, meanNS;
+};
+
+typedef struct benchSuite benchSuite;
+struct benchSuite {
+    int resultNum;
+    benchResult results[benchMAXRESULTS];
+};
+
+/* Empties the suite. */
+void benchInitialize(benchSuite *suite) {
+    suite->resultNum = 0;
+}
+
+/* Returns the time in seconds from an arbitrary start, with a resolution of
+nanoseconds on most systems. Unlike gettimeofday, the clock never jumps. */
+double benchTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 0.000000001;
+}
+
+/* Times runNum runs of the kernel, as one repetition. Returns seconds. */
+double benchRepetition(void (*kernel)(int, void *), void *arg, int runNum) {
+    double start = benchTime();
+    kernel(runNum, arg);
+    return benchTime() - start;
+}
+
+/* For qsort. */
+int benchCompare(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Times the kernel and adds the result to the suite under the given name. The
+kernel is called as kernel(runNum, arg), and must run its primitive runNum
+times, using benchDoNotOptimize or benchClobberMemory on the results. repNum
+is at most benchMAXREPS. Returns 0 on success, or 1 if the suite is full or
+repNum is out of range, in which case nothing is added. */
+int benchRun(
+        benchSuite *suite, const char *name, void (*kernel)(int, void *),
+        void *arg, int repNum) {
+    if (suite->resultNum >= benchMAXRESULTS) {
+        fprintf(stderr, "error: benchRun: suite is full\n");
+        return 1;
+    }
+    if (repNum < 1 || repNum > benchMAXREPS) {
+        fprintf(stderr, "error: benchRun: bad repNum %d\n", repNum);
+        return 1;
+    }
+    /* Calibrates, doubling the runs until a repetition is long enough. */
+    int runNum = 1;
+    while (benchRepetition(kernel, arg, runNum) < benchMINSECONDS && runNum < (1 << 24))
+        runNum *= 2;
+    for (int rep = 0; rep < benchWARMUPNUM; rep += 1)
+        benchRepetition(kernel, arg, runNum);
+    double times[benchMAXREPS], sum = 0.0;
+    for (int rep = 0; rep < repNum; rep += 1) {
+        times[rep] = benchRepetition(kernel, arg, runNum) * 1000000000.0 / runNum;
+        sum += times[rep];
+    }
+    qsort(times, repNum, sizeof(double), benchCompare);
+    benchResult *result = &suite->results[suite->resultNum];
+    strncpy(result->name, name, benchNAMELENGTH - 1);
+    result->name[benchNAMELENGTH - 1] = '\0';
+    result->runNum = runNum;
+    result->repNum = repNum;
+    result->minNS = times[0];
+    result->medianNS = (times[(repNum - 1) / 2] + times[repNum / 2]) / 2.0;
+    result->p99NS = times[(int)ceil(repNum * 0.99) - 1];
+    result->meanNS = sum / repNum;
+    suite->resultNum += 1;
+    return 0;
+}
+
+/* Prints the results as a table, for people. */
+void benchPrint(const benchSuite *suite, FILE *file) {
+    fprintf(file, "%-28s %10s %10s %10s %10s %9s\n", "benchmark", "min ns",
+        "median ns", "p99 ns", "mean ns", "runs");
+    for (int i = 0; i < suite->resultNum; i += 1) {
+        const benchResult *result = &suite->results[i];
+        fprintf(file, "%-28s %10.2f %10.2f %10.2f %10.2f %9d\n", result->name,
+            result->minNS, result->medianNS, result->p99NS, result->meanNS,
+            result->runNum);
+    }
+}
+
+/* Prints the results as JSON, one benchmark per line. label describes the
+build, for example which precision it uses, and should not contain quotes. */
+void benchPrintJSON(const benchSuite *suite, const char *label, FILE *file) {
+    fprintf(file, "{\n  \"label\": \"%s\",\n  \"benchmarks\": [\n", label);
+    for (int i = 0; i < suite->resultNum; i += 1) {
+        const benchResult *result = &suite->results[i];
+        fprintf(file, "    {\"name\": \"%s\", \"runs\": %d, \"repetitions\": %d, ",
+            result->name, result->runNum, result->repNum);
+        fprintf(file, "\"min_ns\": %.2f, \"median_ns\": %.2f, \"p99_ns\": %.2f, \"mean_ns\": %.2f}%s\n",
+            result->minNS, result->medianNS, result->p99NS, result->meanNS,
+            (i < suite->resultNum - 1) ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
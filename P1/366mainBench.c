@@ -0,0 +1,209 @@
+/*
+	366mainBench.c
+	Times the math, texture, and mesh primitives of the files numbered 365, each in isolation, with
+	the framework of 366bench.c: mat444Multiply, mat441Multiply, mat44TransformPoints, texSample with
+	nearest and with linear filtering, mesh3DSmoothNormals, landBlur, and meshInitializeFile. It
+	prints a table to stderr and JSON to stdout. It doesn't open a window. To catch a regression,
+	save the JSON before and after a change and diff the two files, for example
+	    ./a.out > before.json
+	    (change something, recompile)
+	    ./a.out > after.json
+	    diff before.json after.json
+	Times of a few percent either way are noise. Compare the medians.
+	Written by Cole Weinstein and Robbie Young for Carleton College's CS311 - Computer Graphics, taught by Josh Davis.
+*/
+
+
+/* On macOS (Intel), compile with...
+    clang -O3 -c 040pixel.c -Wno-deprecated
+    clang -O3 -mavx2 366mainBench.c 040pixel.o -lglfw -framework OpenGL -framework Cocoa -framework IOKit
+On Ubuntu, compile with...
+    cc -O3 -c 040pixel.c
+    cc -O3 -mavx2 366mainBench.c 040pixel.o -lglfw -lGL -lm -ldl -lpthread
+The pixel library is linked only because meshRender needs it. Add -DREALFLOAT=1
+to time the float versions. The JSON's label records the precision, so that
+files from different builds aren't mistaken for each other.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <GLFW/glfw3.h>
+
+#include "040pixel.h"
+
+#include "365real.c"
+#include "365vector.c"
+#include "365matrix.c"
+#include "365texture.c"
+#include "365shading.c"
+#include "363depth.c"
+#include "365triangle.c"
+#include "365mesh.c"
+#include "365mesh3D.c"
+#include "365landscape.c"
+#include "366bench.c"
+
+#define REPNUM 101
+#define ARRAYSIZE 1024
+#define TEXSIZE 256
+#define LANDSIZE 100
+#define FILELANDSIZE 40
+#define MESHPATH "366mainBench.mesh"
+
+real mats[ARRAYSIZE][4][4], otherMats[ARRAYSIZE][4][4];
+real vecs[ARRAYSIZE][4], points[ARRAYSIZE][3];
+real matsOut[ARRAYSIZE][4][4], vecsOut[ARRAYSIZE][4];
+real texCoords[ARRAYSIZE][2];
+texTexture texture;
+meshMesh landMesh;
+real landData[LANDSIZE * LANDSIZE];
+
+/* Each kernel runs its primitive runNum times. The ones on small inputs walk
+through arrays of ARRAYSIZE different inputs, so that the compiler can't hoist
+the work out of the loop, and the branch predictor can't memorize it. */
+
+void kernelMat444Multiply(int runNum, void *arg) {
+	for (int i = 0; i < runNum; i += 1) {
+		int k = i % ARRAYSIZE;
+		mat444Multiply(mats[k], otherMats[k], matsOut[k]);
+		benchClobberMemory();
+	}
+}
+
+void kernelMat441Multiply(int runNum, void *arg) {
+	for (int i = 0; i < runNum; i += 1) {
+		int k = i % ARRAYSIZE;
+		mat441Multiply(mats[k], vecs[k], vecsOut[k]);
+		benchClobberMemory();
+	}
+}
+
+/* One run transforms all ARRAYSIZE points. */
+void kernelMat44TransformPoints(int runNum, void *arg) {
+	for (int i = 0; i < runNum; i += 1) {
+		mat44TransformPoints(ARRAYSIZE, mats[i % ARRAYSIZE], points, vecsOut);
+		benchClobberMemory();
+	}
+}
+
+/* arg points to the filtering, texNEAREST or texLINEAR. */
+void kernelTexSample(int runNum, void *arg) {
+	texSetFiltering(&texture, *(int *)arg);
+	real sample[3];
+	for (int i = 0; i < runNum; i += 1) {
+		int k = i % ARRAYSIZE;
+		texSample(&texture, texCoords[k][0], texCoords[k][1], sample);
+		benchDoNotOptimize(sample);
+	}
+}
+
+void kernelMesh3DSmoothNormals(int runNum, void *arg) {
+	for (int i = 0; i < runNum; i += 1) {
+		mesh3DSmoothNormals(&landMesh, 5);
+		benchClobberMemory();
+	}
+}
+
+void kernelLandBlur(int runNum, void *arg) {
+	for (int i = 0; i < runNum; i += 1) {
+		landBlur(LANDSIZE, landData);
+		benchClobberMemory();
+	}
+}
+
+/* One run reads the whole file, and then frees the mesh. */
+void kernelMeshInitializeFile(int runNum, void *arg) {
+	meshMesh mesh;
+	for (int i = 0; i < runNum; i += 1) {
+		if (meshInitializeFile(&mesh, MESHPATH) != 0)
+			return;
+		benchDoNotOptimize(mesh.vert);
+		meshFinalize(&mesh);
+	}
+}
+
+/* Fills the inputs with random numbers from a fixed seed, and builds the
+texture, the landscapes, and the mesh file. Returns an error code (0 on
+success). */
+int initializeInputs(void) {
+	srand(311);
+	for (int i = 0; i < ARRAYSIZE; i += 1) {
+		for (int j = 0; j < 16; j += 1) {
+			mats[i][j / 4][j % 4] = rand() / (real)RAND_MAX - 0.5;
+			otherMats[i][j / 4][j % 4] = rand() / (real)RAND_MAX - 0.5;
+		}
+		for (int j = 0; j < 4; j += 1)
+			vecs[i][j] = rand() / (real)RAND_MAX - 0.5;
+		for (int j = 0; j < 3; j += 1)
+			points[i][j] = rand() / (real)RAND_MAX * 100.0 - 50.0;
+		texCoords[i][0] = rand() / (real)RAND_MAX * 4.0 - 2.0;
+		texCoords[i][1] = rand() / (real)RAND_MAX * 4.0 - 2.0;
+	}
+	real black[3] = {0.0, 0.0, 0.0};
+	if (texInitializeSolid(&texture, TEXSIZE, TEXSIZE, 3, black) != 0)
+		return 1;
+	texSetLeftRight(&texture, texREPEAT);
+	texSetTopBottom(&texture, texREPEAT);
+	for (int s = 0; s < TEXSIZE; s += 1)
+		for (int t = 0; t < TEXSIZE; t += 1) {
+			real texel[3] = {rand() / (real)RAND_MAX, rand() / (real)RAND_MAX,
+				rand() / (real)RAND_MAX};
+			texSetTexel(&texture, s, t, texel);
+		}
+	landFlat(LANDSIZE, landData, 0.0);
+	for (int i = 0; i < 12; i += 1)
+		landFaultRandomly(LANDSIZE, landData, 1.0 - i * 0.04);
+	if (mesh3DInitializeLandscape(&landMesh, LANDSIZE, 1.0, landData) != 0) {
+		texFinalize(&texture);
+		return 2;
+	}
+	meshMesh fileMesh;
+	if (mesh3DInitializeLandscape(&fileMesh, FILELANDSIZE, 1.0, landData) != 0) {
+		meshFinalize(&landMesh);
+		texFinalize(&texture);
+		return 3;
+	}
+	int error = meshSaveFile(&fileMesh, MESHPATH);
+	meshFinalize(&fileMesh);
+	if (error != 0) {
+		meshFinalize(&landMesh);
+		texFinalize(&texture);
+		return 4;
+	}
+	return 0;
+}
+
+benchSuite suite;
+
+int main(void) {
+	if (initializeInputs() != 0)
+		return 1;
+	int nearest = texNEAREST, linear = texLINEAR;
+	benchInitialize(&suite);
+	benchRun(&suite, "mat444Multiply", kernelMat444Multiply, NULL, REPNUM);
+	benchRun(&suite, "mat441Multiply", kernelMat441Multiply, NULL, REPNUM);
+	benchRun(&suite, "mat44TransformPoints1024", kernelMat44TransformPoints,
+		NULL, REPNUM);
+	benchRun(&suite, "texSampleNearest", kernelTexSample, &nearest, REPNUM);
+	benchRun(&suite, "texSampleLinear", kernelTexSample, &linear, REPNUM);
+	benchRun(&suite, "mesh3DSmoothNormals100", kernelMesh3DSmoothNormals, NULL,
+		REPNUM);
+	benchRun(&suite, "landBlur100", kernelLandBlur, NULL, REPNUM);
+	benchRun(&suite, "meshInitializeFile40", kernelMeshInitializeFile, NULL,
+		REPNUM);
+	benchPrint(&suite, stderr);
+#if realSIMD
+	const char *simd = "simd";
+#else
+	const char *simd = "scalar";
+#endif
+	char label[64];
+	snprintf(label, sizeof(label), "%s %s", REALFLOAT ? "float" : "double",
+		simd);
+	benchPrintJSON(&suite, label, stdout);
+	remove(MESHPATH);
+	meshFinalize(&landMesh);
+	texFinalize(&texture);
+	return 0;
+}
@@ -399,6 +399,9 @@ int swapInitializeSyncs(swapChain *swap) {
         fprintf(stderr, "error: createSyncs: malloc failed\n");
         return 4;
     }
+    /* No image is in flight yet, so presentFrame has no fence to wait on. */
+    for (int i = 0; i < swap->numImages; i += 1)
+        swap->imagesInFlight[i] = VK_NULL_HANDLE;
     VkSemaphoreCreateInfo semaphoreInfo = {0};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
     VkFenceCreateInfo fenceInfo = {0};
@@ -48,6 +48,13 @@ If you see errors, then try changing ANISOTROPY to 0 and/or MAXFRAMESINFLIGHT to
 /* Informational messages should (1) or shouldn't (0) be printed to stderr. */
 #define VERBOSE 1
 
+/* Frames should (1) or shouldn't (0) be traced to 610trace.json, for viewing in 
+chrome://tracing or ui.perfetto.dev. The trace is written on exit and whenever 
+F12 is pressed. If you change TRACE to 1, then compile ../P1/354trace.c with 
+-DTRACE=1 and link ../P1/354trace.o. See ../P1/354trace.h. */
+#define TRACE 0
+#include "../P1/354trace.h"
+
 /* Anisotropic texture filtering. If you get an error that there are no suitable 
 Vulkan devices, then try changing ANISOTROPY from 1 to 0. */
 #define ANISOTROPY 1
@@ -536,6 +543,7 @@ VkDeviceMemory *sceneUniformBuffersMemory;
 
 /* Configures the scene uniforms for a single frame. */
 void setSceneUniforms(uint32_t imageIndex) {
+    TRACESCOPE("setSceneUniforms");
     SceneUniforms sceneUnifs;
     /* Update the camera. */
     setCamera();
@@ -581,6 +589,7 @@ unifAligned aligned;
 
 /* Configures the body uniforms for a single frame. */
 void setBodyUniforms(uint32_t imageIndex) {
+    TRACESCOPE("setBodyUniforms");
     float identity[4][4] = {
         {1.0, 0.0, 0.0, 0.0},                           // row 0, not column 0
         {0.0, 1.0, 0.0, 0.0},                           // row 1
@@ -1039,6 +1048,7 @@ int reinitializeSwapChain() {
 
 /* Called by guiRun. Presents one frame to the window. */
 int presentFrame() {
+    TRACESCOPE("presentFrame");
     /* Synchronization. */
     vkWaitForFences(
         vul.device, 1, &swap.inFlightFences[swap.curFrame], VK_TRUE, 
@@ -1169,10 +1179,12 @@ void handleKey(
             attenK[0] *= 2;
         else if (!shiftIsDown && attenK[0] > 0.000001)
             attenK[0] /= 2;
-    }
+    } if (key == GLFW_KEY_F12 && action == GLFW_PRESS)
+        TRACEWRITE();
 }
 
 int main() {
+    TRACESTART("610trace.json");
     if (guiInitialize(&gui, 512, 512, "Vulkan") != 0)
         return 5;
     if (vulInitialize(&vul) != 0) {
@@ -0,0 +1,433 @@
+
+
+
+/*
+    620gui.c
+    The GUI of 440gui.c, with two ways to stop guiRun from presenting frames as fast as it can. In
+    on-demand mode, guiRun presents a frame only when the program asks for one with guiRequestFrame
+    (or the window is resized), and otherwise sleeps until the next user event. Under a frame cap,
+    guiRun sleeps between frames, rather than spinning, while still handling events. Either way, an
+    idle or slow-moving scene costs almost no processor time. guiStartRecording and guiStartReplay
+    log the keys and time steps to a file and feed them back, as pixStartRecording and
+    pixStartReplay do in ../P1/040pixel.c, so that two perf runs present the same frames.
+    Designed by Josh Davis for Carleton College's CS311 - Computer Graphics.
+    Edited by Cole Weinstein and Robbie Young.
+*/
+
+#include <time.h>
+
+/* This file builds a simple graphical user interface (GUI) consisting of a 
+window that is capable of receiving user input (mouse clicks, key presses, etc.) 
+and showing Vulkan graphics. If we were all doing this work on a single 
+operating system, such as macOS, then we would use that operating system's tools 
+to make such a window. However, we are trying to write code that can run on both 
+Linux and macOS, so we use the GLFW toolkit instead.
+
+It is worth emphasizing that GLFW has (almost) nothing to do with Vulkan. In 
+fact, this file does not contain a single Vulkan function call. */
+
+/* Feel free to read from this struct's members, but don't write to them except 
+through the accessors below. */
+typedef struct guiGUI guiGUI;
+struct guiGUI {
+    GLFWwindow *window;
+    int framebufferResized;
+    double startTime, lastTime, currentTime;
+    int (*presentFrame)(void);
+    int onDemand, frameRequested;
+    double framePeriod, nextFrameTime;
+    GLFWkeyfun keyCallback;
+    FILE *recordFile, *replayFile;
+    unsigned int frameIndex;
+    double replayStep, replayTime;
+};
+
+/* Usually you call this function after handling a resizing event. You pass 0 to 
+the function, to indicate that there's no longer a pending resizing event. */
+void guiSetFramebufferResized(guiGUI *gui, int framebufferResized) {
+    gui->framebufferResized = framebufferResized;
+}
+
+/* Returns the current time in seconds since some distant past time (1970?). */
+double guiGetTime(const guiGUI *gui) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double)tv.tv_sec + (double)tv.tv_usec * 0.000001;
+}
+
+/* This GLFW callback is called whenever GLFW throws errors. */
+void guiErrorCallback(int error, const char *description) {
+    fprintf(
+        stderr, "error: guiErrorCallback: GLFW code %d, message...\n%s\n",
+        error, description);
+}
+
+/* This GLFW callback is called whenever the window resizes. */
+void guiResizingCallback(GLFWwindow* window, int width, int height) {
+    /* A pointer to the GUI has been stored inside the GLFW window. */
+    guiGUI *gui = glfwGetWindowUserPointer(window);
+    /* The actual resizing happens asynchronously in presentFrame. */
+    gui->framebufferResized = 1;
+}
+
+/* Initializes the GUI, returning an error code (0 on success). On success, 
+don't forget to call guiFinalize when you're done. */
+int guiInitialize(guiGUI *gui, int width, int height, const char *title) {
+    /* Start keeping track of time. */
+    gui->startTime = guiGetTime(gui);
+    gui->lastTime = gui->startTime;
+    gui->currentTime = gui->startTime;
+    /* Initialize GLFW and one window. */
+    glfwSetErrorCallback(guiErrorCallback);
+    glfwInit();
+    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+    glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
+    gui->window = glfwCreateWindow(width, height, title, NULL, NULL);
+    glfwSetWindowUserPointer(gui->window, gui);
+    glfwSetFramebufferSizeCallback(gui->window, guiResizingCallback);
+    gui->framebufferResized = 0;
+    gui->presentFrame = NULL;
+    gui->onDemand = 0;
+    gui->frameRequested = 1;
+    gui->framePeriod = 0.0;
+    gui->nextFrameTime = 0.0;
+    gui->keyCallback = NULL;
+    gui->recordFile = NULL;
+    gui->replayFile = NULL;
+    gui->frameIndex = 0;
+    gui->replayStep = 0.0;
+    return 0;
+}
+
+/* Sets the callback function, that guiRun calls to present a frame to the 
+screen. The presentFrame function's return value must be an error code: 0 
+signaling no error, non-zero signaling an error.*/
+void guiSetFramePresenter(guiGUI *gui, int (*presentFrame)(void)) {
+    gui->presentFrame = presentFrame;
+}
+
+/* Chooses whether guiRun presents frames only on demand (1) or continually (0, 
+the default). In on-demand mode, guiRun presents a frame only after 
+guiRequestFrame has been called, or when the window has been resized. Otherwise 
+it sleeps until the next user event. So a program whose scene changes only in 
+response to the user should call guiRequestFrame from its event handlers. A 
+program that is animating should call guiRequestFrame from presentFrame, for as 
+long as the animation lasts. After a sleep, lastTime is set to just before 
+currentTime, so that animations don't jump ahead by the time spent asleep. */
+void guiSetOnDemand(guiGUI *gui, int onDemand) {
+    gui->onDemand = onDemand;
+}
+
+/* In on-demand mode, asks guiRun to present one more frame, soon. Requests made 
+before that frame are merged into it. */
+void guiRequestFrame(guiGUI *gui) {
+    gui->frameRequested = 1;
+}
+
+/* Caps the rate at which guiRun presents frames. A framesPerSecond of 0.0 (the 
+default) removes the cap. */
+void guiSetFrameCap(guiGUI *gui, double framesPerSecond) {
+    if (framesPerSecond > 0.0)
+        gui->framePeriod = 1.0 / framesPerSecond;
+    else
+        gui->framePeriod = 0.0;
+    gui->nextFrameTime = 0.0;
+}
+
+/* Returns the time in seconds on a clock that, unlike guiGetTime's, never jumps 
+when the system clock is set. */
+double guiGetMonotonicTime(const guiGUI *gui) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 0.000000001;
+}
+
+/* Under a frame cap, sleeps until it's time for the next frame. The coarse part 
+of the wait is spent in glfwWaitEventsTimeout, so that events are still handled 
+promptly. The last millisecond or so is slept precisely with nanosleep. If a 
+frame runs late, the next one starts right away, rather than trying to catch 
+up. */
+void guiWaitForFrameSlot(guiGUI *gui) {
+    if (gui->framePeriod <= 0.0)
+        return;
+    double now = guiGetMonotonicTime(gui);
+    if (gui->nextFrameTime - now > 0.002) {
+        glfwWaitEventsTimeout(gui->nextFrameTime - now - 0.001);
+        now = guiGetMonotonicTime(gui);
+    }
+    while (now < gui->nextFrameTime) {
+        double rest = gui->nextFrameTime - now;
+        struct timespec ts = {(time_t)rest, 
+            (long)((rest - (time_t)rest) * 1000000000.0)};
+        nanosleep(&ts, NULL);
+        now = guiGetMonotonicTime(gui);
+    }
+    gui->nextFrameTime += gui->framePeriod;
+    if (gui->nextFrameTime < now)
+        gui->nextFrameTime = now;
+}
+
+/* A recording starts with the 4 bytes "GUIR" and a 4-byte version number. Then 
+come records, each starting with a 1-byte kind. For a key, the kind is 
+guiRECORDKEY, followed by the 4-byte key, scancode, action, and mods that GLFW 
+reported. For a time step, the kind is guiRECORDSTEP, followed by the 4-byte 
+frame index and the 8-byte doubles lastTime and currentTime. The keys before a 
+time step are the ones handled just before it. Numbers are in the machine's byte 
+order. */
+#define guiRECORDMAGIC "GUIR"
+#define guiRECORDVERSION 1
+#define guiRECORDKEY 0
+#define guiRECORDSTEP 16
+#define guiRECORDMAXSIZE 32
+
+/* Appends one record. If writing fails, stops recording. */
+void guiWriteRecord(guiGUI *gui, const unsigned char *record, size_t size) {
+    if (fwrite(record, 1, size, gui->recordFile) != size) {
+        fprintf(stderr, "error: guiWriteRecord: fwrite failed; ");
+        fprintf(stderr, "recording stopped\n");
+        fclose(gui->recordFile);
+        gui->recordFile = NULL;
+    }
+}
+
+/* Records a time step, if recording, and counts it. */
+void guiRecordStep(guiGUI *gui) {
+    if (gui->recordFile != NULL) {
+        unsigned char record[guiRECORDMAXSIZE];
+        record[0] = guiRECORDSTEP;
+        memcpy(&record[1], &gui->frameIndex, 4);
+        memcpy(&record[5], &gui->lastTime, 8);
+        memcpy(&record[13], &gui->currentTime, 8);
+        guiWriteRecord(gui, record, 21);
+    }
+    gui->frameIndex += 1;
+}
+
+/* Records the key, if recording, and passes it to the program's handler. */
+void guiDispatchKey(
+        guiGUI *gui, int key, int scancode, int action, int mods) {
+    if (gui->recordFile != NULL) {
+        unsigned char record[guiRECORDMAXSIZE];
+        int fields[4] = {key, scancode, action, mods};
+        record[0] = guiRECORDKEY;
+        memcpy(&record[1], fields, 16);
+        guiWriteRecord(gui, record, 17);
+    }
+    if (gui->keyCallback != NULL)
+        gui->keyCallback(gui->window, key, scancode, action, mods);
+}
+
+/* This GLFW callback is called whenever a key is pressed, released, or 
+repeated. While replaying, live keys are ignored. */
+void guiKeyCallback(
+        GLFWwindow *window, int key, int scancode, int action, int mods) {
+    guiGUI *gui = glfwGetWindowUserPointer(window);
+    if (gui->replayFile == NULL)
+        guiDispatchKey(gui, key, scancode, action, mods);
+}
+
+/* Sets the program's key handler, which has the signature of a GLFW key 
+callback. Install it with this function, rather than glfwSetKeyCallback, so 
+that its keys can be recorded and replayed. */
+void guiSetKeyCallback(guiGUI *gui, GLFWkeyfun keyCallback) {
+    gui->keyCallback = keyCallback;
+    glfwSetKeyCallback(gui->window, guiKeyCallback);
+}
+
+/* Reads the recording up to its next time step, dispatching the keys on the 
+way, and sets lastTime and currentTime. Returns 0 if a time step was read, 1 at 
+the end of the recording, or 2 if the recording is damaged. */
+int guiReplayFrame(guiGUI *gui) {
+    unsigned char record[guiRECORDMAXSIZE];
+    while (fread(record, 1, 1, gui->replayFile) == 1) {
+        if (record[0] == guiRECORDSTEP) {
+            unsigned int frame;
+            if (fread(&record[1], 1, 20, gui->replayFile) != 20)
+                break;
+            memcpy(&frame, &record[1], 4);
+            memcpy(&gui->lastTime, &record[5], 8);
+            memcpy(&gui->currentTime, &record[13], 8);
+            if (frame != gui->frameIndex) {
+                fprintf(stderr, "error: guiReplayFrame: expected frame %u, ", 
+                    gui->frameIndex);
+                fprintf(stderr, "found %u\n", frame);
+                return 2;
+            }
+            /* Under a fixed step, time starts where the recording's did. */
+            if (gui->replayStep > 0.0) {
+                if (frame == 0)
+                    gui->replayTime = gui->lastTime;
+                gui->lastTime = gui->replayTime;
+                gui->replayTime += gui->replayStep;
+                gui->currentTime = gui->replayTime;
+            }
+            return 0;
+        }
+        if (record[0] != guiRECORDKEY || 
+                fread(&record[1], 1, 16, gui->replayFile) != 16)
+            break;
+        int fields[4];
+        memcpy(fields, &record[1], 16);
+        guiDispatchKey(gui, fields[0], fields[1], fields[2], fields[3]);
+    }
+    if (feof(gui->replayFile))
+        return 1;
+    fprintf(stderr, "error: guiReplayFrame: damaged recording at frame %u\n", 
+        gui->frameIndex);
+    return 2;
+}
+
+/* Opens a file of the given mode and checks or writes the header. Returns NULL 
+on error. */
+FILE *guiOpenRecording(const char *path, const char *mode) {
+    FILE *file = fopen(path, mode);
+    if (file == NULL) {
+        fprintf(stderr, "error: guiOpenRecording: could not open %s\n", path);
+        return NULL;
+    }
+    unsigned int version = guiRECORDVERSION;
+    char magic[4];
+    if (mode[0] == 'w') {
+        if (fwrite(guiRECORDMAGIC, 1, 4, file) == 4 && 
+                fwrite(&version, 4, 1, file) == 1)
+            return file;
+        fprintf(stderr, "error: guiOpenRecording: could not write %s\n", path);
+    } else {
+        if (fread(magic, 1, 4, file) == 4 && 
+                memcmp(magic, guiRECORDMAGIC, 4) == 0 && 
+                fread(&version, 4, 1, file) == 1 && 
+                version == guiRECORDVERSION)
+            return file;
+        fprintf(stderr, "error: guiOpenRecording: %s is not a recording\n", 
+            path);
+    }
+    fclose(file);
+    return NULL;
+}
+
+/* Stops recording, if recording, and finishes the file. */
+void guiStopRecording(guiGUI *gui) {
+    if (gui->recordFile == NULL)
+        return;
+    if (fclose(gui->recordFile) != 0)
+        fprintf(stderr, "error: guiStopRecording: could not finish file\n");
+    gui->recordFile = NULL;
+}
+
+/* Starts recording every key that reaches the handler set by guiSetKeyCallback, 
+and the times of every frame that guiRun presents, to a compact binary file at 
+path. guiStartReplay can then feed the same input to the same program, frame 
+for frame. Call this function after guiInitialize and before guiRun. Recording 
+stops at guiStopRecording or guiFinalize. Returns an error code (0 on success). 
+Resizes are not recorded, because they depend on the window, not the user. */
+int guiStartRecording(guiGUI *gui, const char *path) {
+    guiStopRecording(gui);
+    gui->recordFile = guiOpenRecording(path, "wb");
+    if (gui->recordFile == NULL)
+        return 1;
+    gui->frameIndex = 0;
+    return 0;
+}
+
+/* Makes the next guiRun replay the recording at path, instead of listening to 
+the user and the clock. If timeStep is positive, then the frames advance by 
+exactly that many seconds, starting at the recording's first time. Otherwise 
+they get the recorded times. Either way, guiRun presents one frame per recorded 
+frame, as fast as it can, ignoring on-demand mode and the frame cap, and returns 
+at the end of the recording. Unlike the pixel system, the GUI can't run without 
+a window, because Vulkan presents to the window's surface. Returns an error code 
+(0 on success). */
+int guiStartReplay(guiGUI *gui, const char *path, double timeStep) {
+    if (gui->replayFile != NULL)
+        fclose(gui->replayFile);
+    gui->replayFile = guiOpenRecording(path, "rb");
+    if (gui->replayFile == NULL)
+        return 1;
+    gui->replayStep = (timeStep > 0.0) ? timeStep : 0.0;
+    gui->frameIndex = 0;
+    return 0;
+}
+
+/* The loop while replaying. Keys and times come from the recording. If VERBOSE, 
+reports at the end how long the frames took on the wall clock. */
+void guiRunReplay(guiGUI *gui) {
+    int numErrors = 0;
+    double start = guiGetMonotonicTime(gui);
+    while (!glfwWindowShouldClose(gui->window)) {
+        /* Let the user close the window. Other input is ignored. */
+        glfwPollEvents();
+        if (guiReplayFrame(gui) != 0)
+            break;
+        guiRecordStep(gui);
+        if (gui->presentFrame() != 0 && VERBOSE) {
+            numErrors += 1;
+            if (numErrors == 100) {
+                fprintf(stderr, "warning: guiRun: 100 more strange frames\n");
+                numErrors = 0;
+            }
+        }
+    }
+    double seconds = guiGetMonotonicTime(gui) - start;
+    if (VERBOSE && gui->frameIndex > 0)
+        fprintf(
+            stderr, "info: guiRun: replayed %u frames at %f ms/frame\n", 
+            gui->frameIndex, seconds * 1000.0 / gui->frameIndex);
+    fclose(gui->replayFile);
+    gui->replayFile = NULL;
+}
+
+/* Runs the user interface event loop. While replaying (see guiStartReplay), the 
+keys and times come from the recording instead. */
+void guiRun(guiGUI *gui) {
+    if (gui->replayFile != NULL) {
+        guiRunReplay(gui);
+        return;
+    }
+    int numErrors = 0, numFramesPerSecond = 0;
+    while (!glfwWindowShouldClose(gui->window)) {
+        /* Deal with the user. In on-demand mode with nothing to do, sleep until 
+        an event arrives, and then skip the sleep in the frame timing. */
+        if (gui->onDemand && !gui->frameRequested && 
+                !gui->framebufferResized) {
+            glfwWaitEvents();
+            gui->currentTime = guiGetTime(gui);
+        } else
+            glfwPollEvents();
+        if (gui->onDemand && !gui->frameRequested && 
+                !gui->framebufferResized)
+            continue;
+        guiWaitForFrameSlot(gui);
+        gui->frameRequested = 0;
+        /* Keep track of time. */
+        gui->lastTime = gui->currentTime;
+        gui->currentTime = guiGetTime(gui);
+        guiRecordStep(gui);
+        /* Show frames per second if VERBOSE. */
+        numFramesPerSecond += 1;
+        if (VERBOSE && (floor(gui->currentTime) > floor(gui->lastTime))) {
+            fprintf(stderr, "info: guiRun: %d frames/s\n", numFramesPerSecond);
+            numFramesPerSecond = 0;
+        }
+        /* Render. Print more diagnostics if VERBOSE. */
+        if (gui->presentFrame() != 0 && VERBOSE) {
+            numErrors += 1;
+            if (numErrors == 100) {
+                fprintf(stderr, "warning: guiRun: 100 more strange frames\n");
+                numErrors = 0;
+            }
+        }
+    }
+}
+
+/* Releases the resources backing the GUI. */
+void guiFinalize(guiGUI *gui) {
+    guiStopRecording(gui);
+    if (gui->replayFile != NULL) {
+        fclose(gui->replayFile);
+        gui->replayFile = NULL;
+    }
+    glfwDestroyWindow(gui->window);
+    glfwTerminate();
+}
+
+
@@ -0,0 +1,371 @@
+/*
+    650hierarchy.c
+    A flattened scene hierarchy, as an alternative to the firstChild/nextSibling trees of 640body.c.
+    The bodies live in parallel arrays (parents, rotations, translations, local and world matrices),
+    indexed by body, and every body comes after its parent. So the world matrices can be computed by
+    one sweep from the first body to the last, without recursion, and without chasing pointers
+    around memory. hierSortByDepth further sorts the bodies by their depth in the tree. Then the
+    bodies of each depth are contiguous and independent of each other, and hierUpdate splits each
+    large depth among hierInitialize's threads. Consecutive small depths, such as the top of the
+    tree, or a long chain, are swept by one thread, because splitting them costs more than it saves.
+    Designed by Josh Davis for Carleton College's CS311 - Computer Graphics.
+    Implementations written by Cole Weinstein and Robbie Young.
+*/
+
+#include <pthread.h>
+
+#define hierMAXTHREADS 16
+/* A depth is split among the threads only if each would get this many bodies. */
+#define hierMINSLICE 1024
+
+/* A reusable barrier, because macOS lacks pthread_barrier_t. */
+typedef struct hierBarrier hierBarrier;
+struct hierBarrier {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int threadNum, arrivedNum, generation;
+};
+
+typedef struct hierHierarchy hierHierarchy;
+
+typedef struct hierWorker hierWorker;
+struct hierWorker {
+    hierHierarchy *hier;
+    int index;
+};
+
+/* Feel free to read this struct's members, but write them only through the
+functions below. Body i's parent is parents[i], which is less than i, or -1 if
+body i is a root. */
+struct hierHierarchy {
+    int bodyNum, maxBodyNum;
+    int *parents;
+    int *depths;
+    float (*rotations)[3][3];
+    float (*translations)[3];
+    float (*locals)[4][4];
+    float (*worlds)[4][4];
+    char *localDirty;
+    /* The sweep is cut into phases, separated by barriers. Phase p covers
+    bodies phaseStarts[p] to phaseStarts[p + 1] - 1. If phaseSplit[p], then the
+    threads share them; otherwise thread 0 does them all. phaseNum is 0 until
+    hierSortByDepth, and after any hierAddBody. */
+    int phaseNum;
+    int *phaseStarts;
+    char *phaseSplit;
+    /* Threads other than the caller of hierUpdate. */
+    int threadNum, quitting;
+    pthread_t threads[hierMAXTHREADS];
+    hierWorker workers[hierMAXTHREADS];
+    hierBarrier barrier;
+};
+
+/* Initializes the barrier for threadNum threads. Returns an error code (0 on
+success). On success, don't forget to hierFinalizeBarrier. */
+int hierInitializeBarrier(hierBarrier *bar, int threadNum) {
+    if (pthread_mutex_init(&bar->mutex, NULL) != 0)
+        return 2;
+    if (pthread_cond_init(&bar->cond, NULL) != 0) {
+        pthread_mutex_destroy(&bar->mutex);
+        return 1;
+    }
+    bar->threadNum = threadNum;
+    bar->arrivedNum = 0;
+    bar->generation = 0;
+    return 0;
+}
+
+void hierFinalizeBarrier(hierBarrier *bar) {
+    pthread_cond_destroy(&bar->cond);
+    pthread_mutex_destroy(&bar->mutex);
+}
+
+/* Blocks until all threadNum threads have called this function. */
+void hierWaitBarrier(hierBarrier *bar) {
+    pthread_mutex_lock(&bar->mutex);
+    int generation = bar->generation;
+    bar->arrivedNum += 1;
+    if (bar->arrivedNum == bar->threadNum) {
+        bar->arrivedNum = 0;
+        bar->generation += 1;
+        pthread_cond_broadcast(&bar->cond);
+    } else
+        while (generation == bar->generation)
+            pthread_cond_wait(&bar->cond, &bar->mutex);
+    pthread_mutex_unlock(&bar->mutex);
+}
+
+/* Computes the world matrices of bodies start to end - 1, assuming that their
+parents' world matrices are already computed. */
+void hierSweep(hierHierarchy *hier, int start, int end) {
+    for (int i = start; i < end; i += 1) {
+        if (hier->localDirty[i]) {
+            float (*local)[4] = hier->locals[i];
+            for (int j = 0; j < 3; j += 1) {
+                vecCopy(3, hier->rotations[i][j], local[j]);
+                local[j][3] = hier->translations[i][j];
+            }
+            local[3][0] = 0.0;
+            local[3][1] = 0.0;
+            local[3][2] = 0.0;
+            local[3][3] = 1.0;
+            hier->localDirty[i] = 0;
+        }
+        int parent = hier->parents[i];
+        if (parent < 0)
+            vecCopy(16, (float *)hier->locals[i], (float *)hier->worlds[i]);
+        else
+            mat444Multiply(hier->worlds[parent], hier->locals[i], hier->worlds[i]);
+    }
+}
+
+/* Helper function for hierUpdate. The index-th of the threadNum + 1 threads
+does its part of every phase, waiting for the others between phases. */
+void hierSweepPhases(hierHierarchy *hier, int index) {
+    int threadNum = hier->threadNum + 1;
+    for (int p = 0; p < hier->phaseNum; p += 1) {
+        int start = hier->phaseStarts[p], end = hier->phaseStarts[p + 1];
+        if (hier->phaseSplit[p]) {
+            int slice = (end - start + threadNum - 1) / threadNum;
+            int myStart = start + index * slice;
+            int myEnd = (myStart + slice < end) ? myStart + slice : end;
+            if (myStart < myEnd)
+                hierSweep(hier, myStart, myEnd);
+        } else if (index == 0)
+            hierSweep(hier, start, end);
+        hierWaitBarrier(&hier->barrier);
+    }
+}
+
+/* The body of each extra thread. Waits for hierUpdate to start a sweep. */
+void *hierWork(void *arg) {
+    hierWorker *worker = (hierWorker *)arg;
+    hierHierarchy *hier = worker->hier;
+    while (1) {
+        hierWaitBarrier(&hier->barrier);
+        if (hier->quitting)
+            return NULL;
+        hierSweepPhases(hier, worker->index);
+    }
+}
+
+/* Releases the arrays. */
+void hierFinalizeArrays(hierHierarchy *hier) {
+    free(hier->parents);
+    free(hier->depths);
+    free(hier->rotations);
+    free(hier->translations);
+    free(hier->locals);
+    free(hier->worlds);
+    free(hier->localDirty);
+    free(hier->phaseStarts);
+    free(hier->phaseSplit);
+}
+
+/* Tells the extra threads to quit, and waits for them to do so. */
+void hierFinalizeThreads(hierHierarchy *hier) {
+    hier->quitting = 1;
+    hierWaitBarrier(&hier->barrier);
+    for (int k = 0; k < hier->threadNum; k += 1)
+        pthread_join(hier->threads[k], NULL);
+    hier->threadNum = 0;
+}
+
+/* Initializes an empty hierarchy with room for maxBodyNum bodies. hierUpdate
+uses threadNum threads in all, including the one that calls it, so threadNum 1
+means no extra threads. Returns an error code (0 on success). On success, don't
+forget to hierFinalize. */
+int hierInitialize(hierHierarchy *hier, int maxBodyNum, int threadNum) {
+    if (threadNum < 1 || threadNum > hierMAXTHREADS + 1) {
+        fprintf(stderr, "error: hierInitialize: bad threadNum %d\n", threadNum);
+        return 4;
+    }
+    hier->bodyNum = 0;
+    hier->maxBodyNum = maxBodyNum;
+    hier->parents = malloc(maxBodyNum * sizeof(int));
+    hier->depths = malloc(maxBodyNum * sizeof(int));
+    hier->rotations = malloc(maxBodyNum * sizeof(float[3][3]));
+    hier->translations = malloc(maxBodyNum * sizeof(float[3]));
+    hier->locals = malloc(maxBodyNum * sizeof(float[4][4]));
+    hier->worlds = malloc(maxBodyNum * sizeof(float[4][4]));
+    hier->localDirty = malloc(maxBodyNum * sizeof(char));
+    hier->phaseStarts = malloc((maxBodyNum + 1) * sizeof(int));
+    hier->phaseSplit = malloc(maxBodyNum * sizeof(char));
+    if (hier->parents == NULL || hier->depths == NULL ||
+            hier->rotations == NULL || hier->translations == NULL ||
+            hier->locals == NULL || hier->worlds == NULL ||
+            hier->localDirty == NULL || hier->phaseStarts == NULL ||
+            hier->phaseSplit == NULL) {
+        fprintf(stderr, "error: hierInitialize: malloc failed\n");
+        hierFinalizeArrays(hier);
+        return 3;
+    }
+    hier->phaseNum = 0;
+    hier->threadNum = 0;
+    hier->quitting = 0;
+    if (hierInitializeBarrier(&hier->barrier, threadNum) != 0) {
+        fprintf(stderr, "error: hierInitialize: barrier failed\n");
+        hierFinalizeArrays(hier);
+        return 2;
+    }
+    for (int k = 0; k < threadNum - 1; k += 1) {
+        hier->workers[k].hier = hier;
+        hier->workers[k].index = k + 1;
+        if (pthread_create(&hier->threads[k], NULL, hierWork,
+                &hier->workers[k]) != 0) {
+            fprintf(stderr, "error: hierInitialize: pthread_create failed\n");
+            /* Only the threads that exist take part in the last barrier. */
+            hier->barrier.threadNum = k + 1;
+            hierFinalizeThreads(hier);
+            hierFinalizeBarrier(&hier->barrier);
+            hierFinalizeArrays(hier);
+            return 1;
+        }
+        hier->threadNum = k + 1;
+    }
+    return 0;
+}
+
+/* Releases the resources backing the hierarchy, including its threads. */
+void hierFinalize(hierHierarchy *hier) {
+    hierFinalizeThreads(hier);
+    hierFinalizeBarrier(&hier->barrier);
+    hierFinalizeArrays(hier);
+}
+
+/* Appends a body with the given parent (an existing body, or -1 for a root)
+and the identity isometry. Because the parent already exists, it comes before
+the new body. Returns the new body's index, or -1 on error. */
+int hierAddBody(hierHierarchy *hier, int parent) {
+    if (hier->bodyNum >= hier->maxBodyNum) {
+        fprintf(stderr, "error: hierAddBody: hierarchy is full\n");
+        return -1;
+    }
+    if (parent < -1 || parent >= hier->bodyNum) {
+        fprintf(stderr, "error: hierAddBody: bad parent %d\n", parent);
+        return -1;
+    }
+    int i = hier->bodyNum;
+    hier->parents[i] = parent;
+    hier->depths[i] = (parent < 0) ? 0 : hier->depths[parent] + 1;
+    float rot[3][3] = {{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}};
+    vecCopy(9, (float *)rot, (float *)hier->rotations[i]);
+    vec3Set(0.0, 0.0, 0.0, hier->translations[i]);
+    hier->localDirty[i] = 1;
+    hier->bodyNum += 1;
+    /* The phases no longer cover all of the bodies. */
+    hier->phaseNum = 0;
+    return i;
+}
+
+/* Sets the rotation of the body's isometry. */
+void hierSetRotation(hierHierarchy *hier, int i, const float rot[3][3]) {
+    vecCopy(9, (const float *)rot, (float *)hier->rotations[i]);
+    hier->localDirty[i] = 1;
+}
+
+/* Sets the translation of the body's isometry. */
+void hierSetTranslation(hierHierarchy *hier, int i, const float transl[3]) {
+    vecCopy(3, transl, hier->translations[i]);
+    hier->localDirty[i] = 1;
+}
+
+/* Helper function for hierSortByDepth. Groups the depths, from the root down,
+into phases. */
+void hierMakePhases(hierHierarchy *hier, int depthNum, const int depthStarts[]) {
+    int threadNum = hier->threadNum + 1;
+    hier->phaseNum = 0;
+    for (int d = 0; d < depthNum; d += 1) {
+        int size = depthStarts[d + 1] - depthStarts[d];
+        int split = (threadNum > 1 && size >= threadNum * hierMINSLICE);
+        /* A small depth joins the previous phase, if that one is small too. */
+        int p = hier->phaseNum;
+        if (!split && p > 0 && !hier->phaseSplit[p - 1])
+            hier->phaseStarts[p] = depthStarts[d + 1];
+        else {
+            hier->phaseStarts[p] = depthStarts[d];
+            hier->phaseStarts[p + 1] = depthStarts[d + 1];
+            hier->phaseSplit[p] = split;
+            hier->phaseNum += 1;
+        }
+    }
+}
+
+/* Reorders the bodies by depth, keeping the order of the bodies within each
+depth, so that hierUpdate can split the depths among its threads. If newIndices
+is not NULL, then it must have room for bodyNum ints, and receives the new index
+of each old index. Returns an error code (0 on success). */
+int hierSortByDepth(hierHierarchy *hier, int newIndices[]) {
+    int n = hier->bodyNum;
+    int depthNum = 0;
+    for (int i = 0; i < n; i += 1)
+        if (hier->depths[i] + 1 > depthNum)
+            depthNum = hier->depths[i] + 1;
+    int *depthStarts = calloc(depthNum + 1, sizeof(int));
+    int *news = malloc(n * sizeof(int));
+    void *scratch = malloc(n * sizeof(float[4][4]));
+    if (depthStarts == NULL || news == NULL || scratch == NULL) {
+        fprintf(stderr, "error: hierSortByDepth: malloc failed\n");
+        free(depthStarts);
+        free(news);
+        free(scratch);
+        return 1;
+    }
+    /* A counting sort: count each depth, then find where each depth starts. */
+    for (int i = 0; i < n; i += 1)
+        depthStarts[hier->depths[i] + 1] += 1;
+    for (int d = 0; d < depthNum; d += 1)
+        depthStarts[d + 1] += depthStarts[d];
+    int *next = (int *)scratch;
+    memcpy(next, depthStarts, depthNum * sizeof(int));
+    for (int i = 0; i < n; i += 1)
+        news[i] = next[hier->depths[i]]++;
+    /* Permutes each array through the scratch space. A parent's new index is
+    less than its child's, because its depth is less. */
+    int *ints = (int *)scratch;
+    for (int i = 0; i < n; i += 1)
+        ints[news[i]] = (hier->parents[i] < 0) ? -1 : news[hier->parents[i]];
+    memcpy(hier->parents, ints, n * sizeof(int));
+    for (int i = 0; i < n; i += 1)
+        ints[news[i]] = hier->depths[i];
+    memcpy(hier->depths, ints, n * sizeof(int));
+    char *chars = (char *)scratch;
+    for (int i = 0; i < n; i += 1)
+        chars[news[i]] = hier->localDirty[i];
+    memcpy(hier->localDirty, chars, n * sizeof(char));
+    float (*rots)[3][3] = scratch;
+    for (int i = 0; i < n; i += 1)
+        vecCopy(9, (float *)hier->rotations[i], (float *)rots[news[i]]);
+    memcpy(hier->rotations, rots, n * sizeof(float[3][3]));
+    float (*transls)[3] = scratch;
+    for (int i = 0; i < n; i += 1)
+        vecCopy(3, hier->translations[i], transls[news[i]]);
+    memcpy(hier->translations, transls, n * sizeof(float[3]));
+    float (*mats)[4][4] = scratch;
+    for (int i = 0; i < n; i += 1)
+        vecCopy(16, (float *)hier->locals[i], (float *)mats[news[i]]);
+    memcpy(hier->locals, mats, n * sizeof(float[4][4]));
+    for (int i = 0; i < n; i += 1)
+        vecCopy(16, (float *)hier->worlds[i], (float *)mats[news[i]]);
+    memcpy(hier->worlds, mats, n * sizeof(float[4][4]));
+    hierMakePhases(hier, depthNum, depthStarts);
+    if (newIndices != NULL)
+        memcpy(newIndices, news, n * sizeof(int));
+    free(depthStarts);
+    free(news);
+    free(scratch);
+    return 0;
+}
+
+/* Called once per animation frame. Computes the world matrices of all of the
+bodies. Before hierSortByDepth, or after a later hierAddBody, it uses only the
+calling thread. */
+void hierUpdate(hierHierarchy *hier) {
+    if (hier->threadNum == 0 || hier->phaseNum == 0) {
+        hierSweep(hier, 0, hier->bodyNum);
+        return;
+    }
+    /* Releases the extra threads into the sweep, and joins them. */
+    hierWaitBarrier(&hier->barrier);
+    hierSweepPhases(hier, 0);
+}
@@ -0,0 +1,194 @@
+/*
+    650mainHierarchy.c
+    Builds a random scene hierarchy of BODYNUM bodies, under ROOTNUM roots, and times the
+    computation of all of their world matrices in four ways, with the framework of ../P1/366bench.c:
+    recursively, through a firstChild/nextSibling tree of separately allocated nodes, like the
+    bodies of 640body.c; with the flattened hierarchy of 650hierarchy.c, in the order that the
+    bodies were added; after hierSortByDepth; and after hierSortByDepth with THREADNUM threads.
+    It checks that all four agree. It doesn't open a window, and it doesn't need Vulkan.
+    Designed by Josh Davis for Carleton College's CS311 - Computer Graphics.
+    Implementations written by Cole Weinstein and Robbie Young.
+*/
+
+/* On macOS, compile with...
+    clang -O3 650mainHierarchy.c
+On Linux, compile with...
+    clang -O3 650mainHierarchy.c -lm -lpthread
+Then run the program with
+    ./a.out > hierarchy.json
+The table goes to stderr and the JSON to stdout, as in ../P1/366mainBench.c.
+*/
+
+#define REALFLOAT 1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../P1/365real.c"
+#include "../P1/365vector.c"
+#include "../P1/365matrix.c"
+#include "../P1/366bench.c"
+#include "650hierarchy.c"
+
+#define BODYNUM 100000
+#define ROOTNUM 100
+#define THREADNUM 4
+#define REPNUM 31
+
+/* The pointer-linked tree, for comparison. Each node is allocated on its own,
+as the bodies of a real scene would be, so they are scattered around memory. */
+typedef struct treeNode treeNode;
+struct treeNode {
+    float local[4][4];
+    float world[4][4];
+    treeNode *firstChild;
+    treeNode *nextSibling;
+};
+
+treeNode *nodes[BODYNUM];
+treeNode *firstRoot;
+
+/* Computes the world matrices of the given node, its younger siblings, and all
+of their descendants. Unlike bodySetUniformsRecursively, it loops over the
+siblings, so that the recursion is only as deep as the tree. */
+void treeUpdateRecursively(treeNode *node, const float parent[4][4]) {
+    for (; node != NULL; node = node->nextSibling) {
+        mat444Multiply(parent, node->local, node->world);
+        treeUpdateRecursively(node->firstChild, node->world);
+    }
+}
+
+hierHierarchy unsorted, sorted, threaded;
+int newIndices[BODYNUM];
+
+/* Builds the same random hierarchy in the tree and in the three flattened
+hierarchies. Each body after the roots has a random earlier body as its parent.
+Returns an error code (0 on success). */
+int initializeBodies(void) {
+    hierHierarchy *hiers[3] = {&unsorted, &sorted, &threaded};
+    int threadNums[3] = {1, 1, THREADNUM};
+    for (int h = 0; h < 3; h += 1)
+        if (hierInitialize(hiers[h], BODYNUM, threadNums[h]) != 0) {
+            for (int g = 0; g < h; g += 1)
+                hierFinalize(hiers[g]);
+            return 3;
+        }
+    srand(311);
+    float identity[4][4] = {
+        {1.0, 0.0, 0.0, 0.0}, {0.0, 1.0, 0.0, 0.0},
+        {0.0, 0.0, 1.0, 0.0}, {0.0, 0.0, 0.0, 1.0}};
+    for (int i = 0; i < BODYNUM; i += 1) {
+        int parent = (i < ROOTNUM) ? -1 : rand() % i;
+        float axis[3], rot[3][3], transl[3];
+        for (int j = 0; j < 3; j += 1) {
+            axis[j] = rand() / (float)RAND_MAX - 0.5;
+            transl[j] = rand() / (float)RAND_MAX - 0.5;
+        }
+        vecUnit(3, axis, axis);
+        mat33AngleAxisRotation(rand() / (float)RAND_MAX * M_PI, axis, rot);
+        for (int h = 0; h < 3; h += 1) {
+            hierAddBody(hiers[h], parent);
+            hierSetRotation(hiers[h], i, rot);
+            hierSetTranslation(hiers[h], i, transl);
+        }
+        nodes[i] = malloc(sizeof(treeNode));
+        if (nodes[i] == NULL) {
+            fprintf(stderr, "error: initializeBodies: malloc failed\n");
+            return 2;
+        }
+        vecCopy(16, (float *)identity, (float *)nodes[i]->local);
+        for (int j = 0; j < 3; j += 1) {
+            vecCopy(3, rot[j], nodes[i]->local[j]);
+            nodes[i]->local[j][3] = transl[j];
+        }
+        /* Prepends, so the siblings are in reverse order. That's fine. */
+        nodes[i]->firstChild = NULL;
+        if (parent < 0) {
+            nodes[i]->nextSibling = firstRoot;
+            firstRoot = nodes[i];
+        } else {
+            nodes[i]->nextSibling = nodes[parent]->firstChild;
+            nodes[parent]->firstChild = nodes[i];
+        }
+    }
+    if (hierSortByDepth(&sorted, newIndices) != 0 ||
+            hierSortByDepth(&threaded, NULL) != 0)
+        return 1;
+    return 0;
+}
+
+void finalizeBodies(void) {
+    for (int i = 0; i < BODYNUM; i += 1)
+        free(nodes[i]);
+    hierFinalize(&threaded);
+    hierFinalize(&sorted);
+    hierFinalize(&unsorted);
+}
+
+/* Returns the largest difference between the tree's world matrices and the
+hierarchy's. If indices is not NULL, then body i of the tree is body
+indices[i] of the hierarchy. */
+float compareWorlds(const hierHierarchy *hier, const int indices[]) {
+    float maxDiff = 0.0;
+    for (int i = 0; i < BODYNUM; i += 1) {
+        int k = (indices == NULL) ? i : indices[i];
+        for (int j = 0; j < 16; j += 1) {
+            float diff = fabs(((float *)nodes[i]->world)[j] -
+                ((float *)hier->worlds[k])[j]);
+            if (diff > maxDiff)
+                maxDiff = diff;
+        }
+    }
+    return maxDiff;
+}
+
+void kernelTree(int runNum, void *arg) {
+    float identity[4][4] = {
+        {1.0, 0.0, 0.0, 0.0}, {0.0, 1.0, 0.0, 0.0},
+        {0.0, 0.0, 1.0, 0.0}, {0.0, 0.0, 0.0, 1.0}};
+    for (int i = 0; i < runNum; i += 1) {
+        treeUpdateRecursively(firstRoot, identity);
+        benchClobberMemory();
+    }
+}
+
+/* arg points to the hierarchy. */
+void kernelHierarchy(int runNum, void *arg) {
+    for (int i = 0; i < runNum; i += 1) {
+        hierUpdate((hierHierarchy *)arg);
+        benchClobberMemory();
+    }
+}
+
+benchSuite suite;
+
+int main(void) {
+    if (initializeBodies() != 0)
+        return 1;
+    int depthNum = 0;
+    for (int i = 0; i < BODYNUM; i += 1)
+        if (sorted.depths[i] + 1 > depthNum)
+            depthNum = sorted.depths[i] + 1;
+    int splitNum = 0;
+    for (int p = 0; p < threaded.phaseNum; p += 1)
+        splitNum += threaded.phaseSplit[p];
+    fprintf(stderr, "main: %d bodies, %d depths, %d phases of which %d split among %d threads\n",
+        BODYNUM, depthNum, threaded.phaseNum, splitNum, THREADNUM);
+    benchInitialize(&suite);
+    benchRun(&suite, "treeRecursive100k", kernelTree, NULL, REPNUM);
+    benchRun(&suite, "hierUnsorted100k", kernelHierarchy, &unsorted, REPNUM);
+    benchRun(&suite, "hierSorted100k", kernelHierarchy, &sorted, REPNUM);
+    benchRun(&suite, "hierThreaded100k", kernelHierarchy, &threaded, REPNUM);
+    /* The tree doesn't change, so the matrices are all up to date now. */
+    fprintf(stderr, "main: differences from tree: %g unsorted, %g sorted, %g threaded\n",
+        compareWorlds(&unsorted, NULL), compareWorlds(&sorted, newIndices),
+        compareWorlds(&threaded, newIndices));
+    benchPrint(&suite, stderr);
+    char label[64];
+    snprintf(label, sizeof(label), "float %d threads", THREADNUM);
+    benchPrintJSON(&suite, label, stdout);
+    finalizeBodies();
+    return 0;
+}
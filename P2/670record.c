@@ -0,0 +1,255 @@
+/*
+    670record.c
+    Records a frame's draw commands on several threads at once. The work is a list of items, such
+    as the visible bodies of a scene, and recRecord cuts it into one contiguous slice per thread.
+    Each thread records its slice into its own secondary command buffer, which the caller then
+    executes from its primary command buffer, inside the render pass, with vkCmdExecuteCommands.
+    Vulkan requires that a command pool be used by only one thread at a time, and that it not be
+    reset while any of its command buffers are in flight. So there is one pool per thread per swap
+    chain image, and each holds one secondary command buffer. The thread that calls recRecord does
+    the first slice itself, and recInitialize starts threadNum - 1 more threads, which sleep
+    between frames.
+    Designed by Josh Davis for Carleton College's CS311 - Computer Graphics.
+    Implementations written by Cole Weinstein and Robbie Young.
+*/
+
+#include <pthread.h>
+
+#define recMAXTHREADS 16
+
+/* Called by each thread, between beginning and ending its secondary command
+buffer, to record items start to end - 1. start might equal end. The callback
+must bind the pipeline itself, because secondary command buffers don't inherit
+any state from the primary, except for the render pass. */
+typedef void (*recRecordFunc)(VkCommandBuffer cmdBuf, int start, int end, void *arg);
+
+typedef struct recRecorder recRecorder;
+
+typedef struct recWorker recWorker;
+struct recWorker {
+    recRecorder *rec;
+    int index;
+};
+
+/* Feel free to read this struct's members, but don't write them. The pool and
+the secondary command buffer of thread k for image i are at index
+i * threadNum + k. */
+struct recRecorder {
+    int threadNum, imageNum;
+    VkCommandPool *pools;
+    VkCommandBuffer *cmdBufs;
+    pthread_t threads[recMAXTHREADS];
+    recWorker workers[recMAXTHREADS];
+    pthread_mutex_t mutex;
+    pthread_cond_t startCond, doneCond;
+    int generation, busyNum, quitting, errorNum;
+    /* The current job. */
+    uint32_t imageIndex;
+    VkCommandBufferInheritanceInfo inheritance;
+    int itemNum;
+    recRecordFunc record;
+    void *arg;
+};
+
+/* Records the index-th thread's slice of the current job. Returns an error
+code (0 on success). */
+int recRecordSlice(recRecorder *rec, int index) {
+    int i = rec->imageIndex * rec->threadNum + index;
+    int slice = (rec->itemNum + rec->threadNum - 1) / rec->threadNum;
+    int start = index * slice;
+    int end = (start + slice < rec->itemNum) ? start + slice : rec->itemNum;
+    if (start > end)
+        start = end;
+    vkResetCommandPool(vul.device, rec->pools[i], 0);
+    VkCommandBufferBeginInfo beginInfo = {0};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+        VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &(rec->inheritance);
+    if (vkBeginCommandBuffer(rec->cmdBufs[i], &beginInfo) != VK_SUCCESS) {
+        fprintf(stderr, "error: recRecordSlice: vkBeginCommandBuffer failed\n");
+        return 2;
+    }
+    rec->record(rec->cmdBufs[i], start, end, rec->arg);
+    if (vkEndCommandBuffer(rec->cmdBufs[i]) != VK_SUCCESS) {
+        fprintf(stderr, "error: recRecordSlice: vkEndCommandBuffer failed\n");
+        return 1;
+    }
+    return 0;
+}
+
+/* The body of each extra thread. Sleeps until recRecord starts a job, does its
+slice, and reports back. */
+void *recWork(void *arg) {
+    recWorker *worker = (recWorker *)arg;
+    recRecorder *rec = worker->rec;
+    int generation = 0;
+    while (1) {
+        pthread_mutex_lock(&rec->mutex);
+        while (rec->generation == generation && !rec->quitting)
+            pthread_cond_wait(&rec->startCond, &rec->mutex);
+        if (rec->quitting) {
+            pthread_mutex_unlock(&rec->mutex);
+            return NULL;
+        }
+        generation = rec->generation;
+        pthread_mutex_unlock(&rec->mutex);
+        int error = recRecordSlice(rec, worker->index);
+        pthread_mutex_lock(&rec->mutex);
+        if (error != 0)
+            rec->errorNum += 1;
+        rec->busyNum -= 1;
+        if (rec->busyNum == 0)
+            pthread_cond_signal(&rec->doneCond);
+        pthread_mutex_unlock(&rec->mutex);
+    }
+}
+
+/* Tells the extra threads to quit, and waits for them to do so. */
+void recFinalizeThreads(recRecorder *rec) {
+    pthread_mutex_lock(&rec->mutex);
+    rec->quitting = 1;
+    pthread_cond_broadcast(&rec->startCond);
+    pthread_mutex_unlock(&rec->mutex);
+    for (int k = 0; k < rec->threadNum - 1; k += 1)
+        pthread_join(rec->threads[k], NULL);
+    pthread_cond_destroy(&rec->doneCond);
+    pthread_cond_destroy(&rec->startCond);
+    pthread_mutex_destroy(&rec->mutex);
+}
+
+/* Destroys the first poolNum pools, which frees their command buffers, and the
+arrays. */
+void recFinalizePools(recRecorder *rec, int poolNum) {
+    for (int i = 0; i < poolNum; i += 1)
+        vkDestroyCommandPool(vul.device, rec->pools[i], NULL);
+    free(rec->pools);
+    free(rec->cmdBufs);
+}
+
+/* Initializes the recorder for threadNum threads in all, including the caller
+of recRecord, and imageNum swap chain images. Returns an error code (0 on
+success). On success, don't forget to recFinalize when you're done. */
+int recInitialize(recRecorder *rec, int threadNum, int imageNum) {
+    if (threadNum < 1 || threadNum > recMAXTHREADS + 1) {
+        fprintf(stderr, "error: recInitialize: bad threadNum %d\n", threadNum);
+        return 5;
+    }
+    rec->threadNum = threadNum;
+    rec->imageNum = imageNum;
+    int poolNum = imageNum * threadNum;
+    rec->pools = malloc(poolNum * sizeof(VkCommandPool));
+    rec->cmdBufs = malloc(poolNum * sizeof(VkCommandBuffer));
+    if (rec->pools == NULL || rec->cmdBufs == NULL) {
+        fprintf(stderr, "error: recInitialize: malloc failed\n");
+        free(rec->pools);
+        free(rec->cmdBufs);
+        return 4;
+    }
+    vulQueueFamilyIndices qfIndices = vulGetQueueFamilies(
+        &vul, vul.physicalDevice);
+    for (int i = 0; i < poolNum; i += 1) {
+        VkCommandPoolCreateInfo poolInfo = {0};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = qfIndices.graphicsFamily;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        if (vkCreateCommandPool(vul.device, &poolInfo, NULL, &rec->pools[i]) !=
+                VK_SUCCESS) {
+            fprintf(stderr, "error: recInitialize: vkCreateCommandPool failed\n");
+            recFinalizePools(rec, i);
+            return 3;
+        }
+        VkCommandBufferAllocateInfo allocInfo = {0};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = rec->pools[i];
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(vul.device, &allocInfo, &rec->cmdBufs[i]) !=
+                VK_SUCCESS) {
+            fprintf(stderr, "error: recInitialize: ");
+            fprintf(stderr, "vkAllocateCommandBuffers failed\n");
+            recFinalizePools(rec, i + 1);
+            return 2;
+        }
+    }
+    pthread_mutex_init(&rec->mutex, NULL);
+    pthread_cond_init(&rec->startCond, NULL);
+    pthread_cond_init(&rec->doneCond, NULL);
+    rec->generation = 0;
+    rec->busyNum = 0;
+    rec->quitting = 0;
+    rec->errorNum = 0;
+    for (int k = 0; k < threadNum - 1; k += 1) {
+        rec->workers[k].rec = rec;
+        rec->workers[k].index = k + 1;
+        if (pthread_create(&rec->threads[k], NULL, recWork, &rec->workers[k]) !=
+                0) {
+            fprintf(stderr, "error: recInitialize: pthread_create failed\n");
+            /* Only the threads that exist are joined. */
+            rec->threadNum = k + 1;
+            recFinalizeThreads(rec);
+            recFinalizePools(rec, poolNum);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Releases the resources backing the recorder, including its threads. Call it
+only when none of its command buffers are in flight, for example after
+vkDeviceWaitIdle. */
+void recFinalize(recRecorder *rec) {
+    int poolNum = rec->imageNum * rec->threadNum;
+    recFinalizeThreads(rec);
+    recFinalizePools(rec, poolNum);
+}
+
+/* Records itemNum items, for the given swap chain image, into the image's
+secondary command buffers, by calling record(cmdBuf, start, end, arg) on every
+thread at once. Call it only when the image's previous frame is done, and
+before beginning the render pass, with the render pass and framebuffer that the
+primary command buffer will use. On success, execute the threadNum buffers
+starting at recGetCommandBuffers in that render pass, which must be begun with
+VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS. Returns an error code (0 on
+success). */
+int recRecord(
+        recRecorder *rec, uint32_t imageIndex, VkRenderPass renderPass,
+        VkFramebuffer framebuffer, int itemNum, recRecordFunc record,
+        void *arg) {
+    VkCommandBufferInheritanceInfo inheritance = {0};
+    inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritance.renderPass = renderPass;
+    inheritance.subpass = 0;
+    inheritance.framebuffer = framebuffer;
+    /* Hand the job to the extra threads. */
+    pthread_mutex_lock(&rec->mutex);
+    rec->imageIndex = imageIndex;
+    rec->inheritance = inheritance;
+    rec->itemNum = itemNum;
+    rec->record = record;
+    rec->arg = arg;
+    rec->errorNum = 0;
+    rec->busyNum = rec->threadNum - 1;
+    rec->generation += 1;
+    pthread_cond_broadcast(&rec->startCond);
+    pthread_mutex_unlock(&rec->mutex);
+    /* Do the first slice here, and then wait for the others. */
+    int error = recRecordSlice(rec, 0);
+    pthread_mutex_lock(&rec->mutex);
+    while (rec->busyNum > 0)
+        pthread_cond_wait(&rec->doneCond, &rec->mutex);
+    int errorNum = rec->errorNum;
+    pthread_mutex_unlock(&rec->mutex);
+    if (error != 0 || errorNum != 0) {
+        fprintf(stderr, "error: recRecord: %d threads failed\n",
+            errorNum + (error != 0));
+        return 1;
+    }
+    return 0;
+}
+
+/* Returns the threadNum secondary command buffers of the given image. */
+const VkCommandBuffer *recGetCommandBuffers(
+        const recRecorder *rec, uint32_t imageIndex) {
+    return &(rec->cmdBufs[imageIndex * rec->threadNum]);
+}
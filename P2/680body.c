@@ -0,0 +1,486 @@
+/*
+    680body.c
+    Creates the bodyBody struct for defining bodies a scene.
+    Modified from 670body.c to batch bodies for instanced drawing. A body marked by bodySetInstanced
+    isn't drawn on its own. Instead bodySceneGetBatches groups the visible instanced bodies by vesh,
+    and copies their uniforms into one array, so that each vesh can be drawn once, with as many
+    instances as it has visible bodies, by veshRenderInstanced in 680vesh.c. So the draw calls go
+    from one per body to one per vesh.
+    Designed by Josh Davis for Carleton College's CS311 - Computer Graphics.
+    Implementations written by Cole Weinstein and Robbie Young.
+*/
+
+
+
+typedef struct bodyScene bodyScene;
+
+/* Feel free to read this struct's members. Write vesh as you like. Write the
+isometry only through bodySetRotation and bodySetTranslation, and after writing
+the uniforms, call bodyMarkUniformsChanged, so that the caches stay correct.
+Write firstChild and nextSibling only before bodySceneInitialize. */
+typedef struct bodyBody bodyBody;
+struct bodyBody {
+    isoIsometry isometry;
+    BodyUniforms uniforms;
+    veshVesh *vesh;
+    bodyBody *firstChild;
+    bodyBody *nextSibling;
+    int instanced;              /* drawn in a batch, not on its own */
+    /* The rest is set by bodySceneInitialize and maintained by this file. */
+    bodyBody *parent;           /* NULL for the root and its siblings */
+    bodyScene *scene;
+    int index;                  /* UBO element, in depth-first order */
+    float local[4][4];          /* cached isoGetHomogeneous */
+    float world[4][4];          /* cached product of the ancestors' locals */
+    int localDirty, worldDirty;
+    uint32_t staleImages;       /* bit i set if UBO buffer i is out of date */
+    int pending;                /* whether the body is on the pending list */
+    bodyBody *nextPending;
+};
+
+/* Feel free to read this struct's members, but don't write them. The counts
+accumulate until the user resets them to 0. */
+struct bodyScene {
+    bodyBody *root;
+    int bodyNum;
+    uint32_t allImages;         /* one bit per swap chain image */
+    bodyBody *firstPending;
+    int updatedNum;             /* world matrices recomputed */
+    int uploadedNum;            /* UBO elements copied to the GPU */
+};
+
+/* Like an initializer, this method sets the body into an acceptable initial
+state. Unlike an initializer, this method has no matching finalizer. */
+void bodyConfigure(
+        bodyBody *body, veshVesh *vesh, bodyBody *firstChild,
+        bodyBody *nextSibling) {
+    float rotation[3][3] = {{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}};
+    isoSetRotation(&(body->isometry), rotation);
+    float translation[3] = {0.0, 0.0, 0.0};
+    isoSetTranslation(&(body->isometry), translation);
+    BodyUniforms unifs = {0};
+    body->uniforms = unifs;
+    body->vesh = vesh;
+    body->firstChild = firstChild;
+    body->nextSibling = nextSibling;
+    body->instanced = 0;
+    body->parent = NULL;
+    body->scene = NULL;
+    body->index = 0;
+    body->localDirty = 1;
+    body->worldDirty = 1;
+    body->staleImages = 0;
+    body->pending = 0;
+    body->nextPending = NULL;
+}
+
+/* Puts the body on its scene's pending list, unless it is already there. */
+void bodyAddPending(bodyBody *body) {
+    if (body->scene == NULL || body->pending)
+        return;
+    body->pending = 1;
+    body->nextPending = body->scene->firstPending;
+    body->scene->firstPending = body;
+}
+
+/* Marks the world matrices of the body and its descendants (but not its
+younger siblings) dirty. Stops early at descendants that are already dirty,
+because their descendants must be too. */
+void bodyMarkWorldDirty(bodyBody *body) {
+    body->worldDirty = 1;
+    bodyAddPending(body);
+    for (bodyBody *child = body->firstChild; child != NULL;
+            child = child->nextSibling)
+        if (!child->worldDirty)
+            bodyMarkWorldDirty(child);
+}
+
+/* Sets the rotation of the body's isometry. If it actually changes, then marks
+the body and its descendants dirty. */
+void bodySetRotation(bodyBody *body, const float rot[3][3]) {
+    if (memcmp(rot, body->isometry.rotation, sizeof(float[3][3])) == 0)
+        return;
+    isoSetRotation(&(body->isometry), rot);
+    body->localDirty = 1;
+    bodyMarkWorldDirty(body);
+}
+
+/* Sets the translation of the body's isometry. If it actually changes, then
+marks the body and its descendants dirty. */
+void bodySetTranslation(bodyBody *body, const float transl[3]) {
+    if (memcmp(transl, body->isometry.translation, sizeof(float[3])) == 0)
+        return;
+    isoSetTranslation(&(body->isometry), transl);
+    body->localDirty = 1;
+    bodyMarkWorldDirty(body);
+}
+
+/* Sets whether the body is drawn in an instanced batch (1) or on its own (0). 
+Its children are unaffected. */
+void bodySetInstanced(bodyBody *body, int instanced) {
+    body->instanced = instanced;
+}
+
+/* Call this after writing the body's uniforms, other than modelingT, so that
+they are copied to the GPU again. Unlike a change in the isometry, this doesn't
+affect the descendants. */
+void bodyMarkUniformsChanged(bodyBody *body) {
+    if (body->scene == NULL)
+        return;
+    body->staleImages = body->scene->allImages;
+    bodyAddPending(body);
+}
+
+/* Helper function for bodySceneInitialize. Visits the graph depth-first, in
+the same order as bodyRenderRecursively, and returns the next unused index. */
+int bodyLinkRecursively(
+        bodyBody *body, bodyBody *parent, bodyScene *scene, int index) {
+    for (; body != NULL; body = body->nextSibling) {
+        body->parent = parent;
+        body->scene = scene;
+        body->index = index;
+        body->localDirty = 1;
+        body->worldDirty = 1;
+        body->pending = 0;
+        bodyAddPending(body);
+        index = bodyLinkRecursively(body->firstChild, body, scene, index + 1);
+    }
+    return index;
+}
+
+/* Links the scene graph rooted at root (including its younger siblings and
+their descendants) to the scene, numbers the bodies for bodyRenderRecursively,
+and marks them all dirty. Call it again after changing the shape of the graph.
+Then call bodySceneSetImageNum before the first bodySceneUpload. Returns the
+number of bodies. */
+int bodySceneInitialize(bodyScene *scene, bodyBody *root) {
+    scene->root = root;
+    scene->allImages = 0;
+    scene->firstPending = NULL;
+    scene->updatedNum = 0;
+    scene->uploadedNum = 0;
+    scene->bodyNum = bodyLinkRecursively(root, NULL, scene, 0);
+    return scene->bodyNum;
+}
+
+/* Sets the number of UBO buffers (one per swap chain image), and marks every
+body's UBO element stale in all of them. Call it whenever the buffers are
+(re)created. Returns an error code (0 on success). */
+int bodySceneSetImageNum(bodyScene *scene, int imageNum) {
+    if (imageNum < 1 || imageNum > 32) {
+        fprintf(stderr, "error: bodySceneSetImageNum: bad imageNum %d\n",
+            imageNum);
+        return 1;
+    }
+    scene->allImages = (imageNum == 32) ? 0xffffffff : (1u << imageNum) - 1;
+    for (bodyBody *body = scene->root; body != NULL; ) {
+        body->staleImages = scene->allImages;
+        bodyAddPending(body);
+        /* Continues depth-first without recursion, using the parent links. */
+        if (body->firstChild != NULL)
+            body = body->firstChild;
+        else {
+            while (body != NULL && body->nextSibling == NULL)
+                body = body->parent;
+            if (body != NULL)
+                body = body->nextSibling;
+        }
+    }
+    return 0;
+}
+
+/* Recomputes the body's cached matrices, first bringing its ancestors up to
+date if they are dirty. */
+void bodyUpdateWorld(bodyBody *body) {
+    if (body->localDirty) {
+        isoGetHomogeneous(&(body->isometry), body->local);
+        body->localDirty = 0;
+    }
+    if (body->parent == NULL)
+        vecCopy(16, (float *)body->local, (float *)body->world);
+    else {
+        if (body->parent->worldDirty)
+            bodyUpdateWorld(body->parent);
+        mat444Multiply(body->parent->world, body->local, body->world);
+    }
+    body->worldDirty = 0;
+    body->staleImages = body->scene->allImages;
+    body->scene->updatedNum += 1;
+}
+
+/* Called once per animation frame, before bodySceneUpload. Recomputes the
+world matrices of the pending bodies that need it, and writes the uniforms of
+all pending bodies into aligned. */
+void bodySceneUpdate(bodyScene *scene, const unifAligned *aligned) {
+    for (bodyBody *body = scene->firstPending; body != NULL;
+            body = body->nextPending) {
+        if (body->worldDirty)
+            bodyUpdateWorld(body);
+        mat44Transpose(body->world, body->uniforms.modelingT);
+        BodyUniforms *bodyUnif = (BodyUniforms *)unifGetAligned(
+            aligned, body->index);
+        *bodyUnif = body->uniforms;
+    }
+}
+
+/* Called once per animation frame, after bodySceneUpdate. mapped points to the
+mapped memory of the UBO buffer for the given swap chain image. Copies the
+elements of aligned that are stale in that buffer, and takes the bodies that
+are now up to date everywhere off the pending list. Returns the number of
+elements copied. */
+int bodySceneUpload(
+        bodyScene *scene, const unifAligned *aligned, uint32_t imageIndex,
+        void *mapped) {
+    int copiedNum = 0;
+    uint32_t bit = 1u << imageIndex;
+    bodyBody **link = &(scene->firstPending);
+    while (*link != NULL) {
+        bodyBody *body = *link;
+        if (body->staleImages & bit) {
+            memcpy((char *)mapped + body->index * aligned->alignedSize,
+                unifGetAligned(aligned, body->index), aligned->uboSize);
+            body->staleImages &= ~bit;
+            copiedNum += 1;
+        }
+        if (body->staleImages == 0 && !body->worldDirty) {
+            body->pending = 0;
+            *link = body->nextPending;
+        } else
+            link = &(body->nextPending);
+    }
+    scene->uploadedNum += copiedNum;
+    return copiedNum;
+}
+
+/* The six planes of a view frustum, in world coordinates. A point p is on the 
+inside of plane i if planes[i][0] p[0] + planes[i][1] p[1] + planes[i][2] p[2] + 
+planes[i][3] >= 0. Each plane's normal (its first three entries) is a unit 
+vector, so that the left side is the signed distance from the plane. */
+typedef struct bodyFrustum bodyFrustum;
+struct bodyFrustum {
+    float planes[6][4];
+};
+
+/* Extracts the planes from the camera's projection times inverse isometry, 
+which maps world coordinates to Vulkan clip coordinates, where the visible 
+points have -w <= x <= w, -w <= y <= w, and 0 <= z <= w. Each of those six 
+inequalities is a plane, made of the rows of the matrix. */
+void bodySetFrustum(bodyFrustum *frustum, const float projInvIsom[4][4]) {
+    const float (*m)[4] = projInvIsom;
+    for (int j = 0; j < 4; j += 1) {
+        frustum->planes[0][j] = m[3][j] + m[0][j];
+        frustum->planes[1][j] = m[3][j] - m[0][j];
+        frustum->planes[2][j] = m[3][j] + m[1][j];
+        frustum->planes[3][j] = m[3][j] - m[1][j];
+        frustum->planes[4][j] = m[2][j];
+        frustum->planes[5][j] = m[3][j] - m[2][j];
+    }
+    for (int i = 0; i < 6; i += 1) {
+        float length = vecLength(3, frustum->planes[i]);
+        if (length > 0.0)
+            vecScale(4, 1.0 / length, frustum->planes[i], frustum->planes[i]);
+    }
+}
+
+/* Returns 0 if the body's bounding sphere, placed by its cached world matrix, 
+is entirely outside the frustum, and 1 otherwise. Because the body's modeling 
+transformation is an isometry, the radius doesn't change. */
+int bodyIsVisible(const bodyBody *body, const bodyFrustum *frustum) {
+    float center[3];
+    for (int j = 0; j < 3; j += 1)
+        center[j] = vecDot(3, body->world[j], body->vesh->center) + 
+            body->world[j][3];
+    for (int i = 0; i < 6; i += 1)
+        if (vecDot(3, frustum->planes[i], center) + frustum->planes[i][3] < 
+                -body->vesh->radius)
+            return 0;
+    return 1;
+}
+
+/* Called during command buffer construction. Renders the body's vesh. The index
+must count 0, 1, 2, ... as body after body is rendered into the scene. */
+void bodyRender(
+        const bodyBody *body, VkCommandBuffer *cmdBuf,
+        const VkPipelineLayout *pipelineLayout,
+        const VkDescriptorSet *descriptorSet, const unifAligned *aligned,
+        int index) {
+    uint32_t offset = index * aligned->alignedSize;
+    vkCmdBindDescriptorSets(
+        *cmdBuf, VK_PIPELINE_BIND_POINT_GRAPHICS, *pipelineLayout, 0, 1,
+        descriptorSet, 1, &offset);
+    veshRender(body->vesh, *cmdBuf);
+}
+
+/* The index is the order of visitation in depth-first traveral, which is the
+order that bodySceneInitialize numbers the bodies in. Renders the scene graph,
+that is rooted at the given body, including younger siblings and their
+descendants, depth-first, starting from the given index. Returns the last index
+that was used in rendering the graph. */
+int bodyRenderRecursively(
+        const bodyBody *body, VkCommandBuffer *cmdBuf,
+        const VkPipelineLayout *pipelineLayout,
+        const VkDescriptorSet *descriptorSet, const unifAligned *aligned,
+        int index) {
+    bodyRender(body, cmdBuf, pipelineLayout, descriptorSet, aligned, index);
+    if (body->firstChild != NULL) {
+        index = bodyRenderRecursively(body->firstChild, cmdBuf, pipelineLayout, descriptorSet, aligned, index + 1);
+    }
+    if (body->nextSibling != NULL) {
+        index = bodyRenderRecursively(body->nextSibling, cmdBuf, pipelineLayout, descriptorSet, aligned, index + 1);
+    }
+
+    return index;
+}
+
+/* Called during command buffer construction, after bodySceneUpdate, so that the 
+world matrices are current. Renders every body of the scene that might be 
+visible, in the same depth-first order as bodyRenderRecursively, without 
+recursion. Returns the number of bodies culled. */
+int bodySceneRenderCulled(
+        const bodyScene *scene, VkCommandBuffer *cmdBuf, 
+        const VkPipelineLayout *pipelineLayout, 
+        const VkDescriptorSet *descriptorSet, const unifAligned *aligned, 
+        const bodyFrustum *frustum) {
+    int culledNum = 0;
+    for (const bodyBody *body = scene->root; body != NULL; ) {
+        if (bodyIsVisible(body, frustum))
+            bodyRender(
+                body, cmdBuf, pipelineLayout, descriptorSet, aligned, 
+                body->index);
+        else
+            culledNum += 1;
+        if (body->firstChild != NULL)
+            body = body->firstChild;
+        else {
+            while (body != NULL && body->nextSibling == NULL)
+                body = body->parent;
+            if (body != NULL)
+                body = body->nextSibling;
+        }
+    }
+    return culledNum;
+}
+
+/* Called once per frame, after bodySceneUpdate, so that the world matrices are 
+current. Puts the bodies of the scene that might be visible into visible, which 
+must have room for scene->bodyNum pointers, in the same depth-first order as 
+bodyRenderRecursively. Returns the number of bodies put there. */
+int bodySceneGetVisible(
+        const bodyScene *scene, const bodyFrustum *frustum, 
+        const bodyBody *visible[]) {
+    int visibleNum = 0;
+    for (const bodyBody *body = scene->root; body != NULL; ) {
+        if (bodyIsVisible(body, frustum)) {
+            visible[visibleNum] = body;
+            visibleNum += 1;
+        }
+        if (body->firstChild != NULL)
+            body = body->firstChild;
+        else {
+            while (body != NULL && body->nextSibling == NULL)
+                body = body->parent;
+            if (body != NULL)
+                body = body->nextSibling;
+        }
+    }
+    return visibleNum;
+}
+
+#define bodyMAXBATCHES 16
+
+/* A batch is instanceNum instances of one vesh, whose per-instance data start 
+at element firstInstance of an array of BodyUniforms. */
+typedef struct bodyBatch bodyBatch;
+struct bodyBatch {
+    const veshVesh *vesh;
+    int firstInstance, instanceNum;
+};
+
+/* Called once per frame, after bodySceneUpdate, so that the world matrices and 
+uniforms are current. Culls the scene, as bodySceneGetVisible does. Puts the 
+visible bodies that aren't instanced into visible, which must have room for 
+scene->bodyNum pointers, and sets *visibleNum to their number. Groups the 
+visible instanced bodies by vesh into at most bodyMAXBATCHES batches, and sets 
+*batchNum to their number. Copies the instanced bodies' uniforms into instances, 
+which must have room for scene->bodyNum elements, batch after batch. The 
+instanced bodies of any further veshes are put into visible, so that they are 
+still drawn. Returns the number of bodies culled. */
+int bodySceneGetBatches(
+        const bodyScene *scene, const bodyFrustum *frustum, 
+        const bodyBody *visible[], int *visibleNum, bodyBatch batches[], 
+        int *batchNum, BodyUniforms instances[]) {
+    /* The visible instanced bodies are parked at the back of visible, 
+    which can't fill up from both ends at once. */
+    int frontNum = 0, backNum = 0, culledNum = 0;
+    *batchNum = 0;
+    for (const bodyBody *body = scene->root; body != NULL; ) {
+        if (!bodyIsVisible(body, frustum))
+            culledNum += 1;
+        else {
+            int b = -1;
+            if (body->instanced) {
+                for (b = 0; b < *batchNum; b += 1)
+                    if (batches[b].vesh == body->vesh)
+                        break;
+                if (b == *batchNum && *batchNum < bodyMAXBATCHES) {
+                    batches[b].vesh = body->vesh;
+                    batches[b].instanceNum = 0;
+                    *batchNum += 1;
+                } else if (b == *batchNum)
+                    b = -1;
+            }
+            if (b < 0) {
+                visible[frontNum] = body;
+                frontNum += 1;
+            } else {
+                batches[b].instanceNum += 1;
+                backNum += 1;
+                visible[scene->bodyNum - backNum] = body;
+            }
+        }
+        if (body->firstChild != NULL)
+            body = body->firstChild;
+        else {
+            while (body != NULL && body->nextSibling == NULL)
+                body = body->parent;
+            if (body != NULL)
+                body = body->nextSibling;
+        }
+    }
+    /* Lay the batches out one after another, and then fill them. */
+    int firstInstance = 0;
+    for (int b = 0; b < *batchNum; b += 1) {
+        batches[b].firstInstance = firstInstance;
+        firstInstance += batches[b].instanceNum;
+        batches[b].instanceNum = 0;
+    }
+    for (int k = 1; k <= backNum; k += 1) {
+        const bodyBody *body = visible[scene->bodyNum - k];
+        int b = 0;
+        while (batches[b].vesh != body->vesh)
+            b += 1;
+        instances[batches[b].firstInstance + batches[b].instanceNum] = 
+            body->uniforms;
+        batches[b].instanceNum += 1;
+    }
+    *visibleNum = frontNum;
+    return culledNum;
+}
+
+/* Appends the given sibling to the body's list of siblings. */
+void bodyAddSibling(bodyBody *body, bodyBody *sibling) {
+    if (body->nextSibling != NULL) {
+        bodyAddSibling(body->nextSibling, sibling);
+    } else {
+        body->nextSibling = sibling;
+    }
+}
+
+/* Appends the given child to the body's list of children. */
+void bodyAddChild(bodyBody *body, bodyBody *child) {
+    if (body->firstChild != NULL) {
+        bodyAddSibling(body->firstChild, child);
+    } else {
+        body->firstChild = child;
+    }
+}
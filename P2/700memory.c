@@ -0,0 +1,389 @@
+/*
+    700memory.c
+    Sub-allocates GPU memory. Vulkan implementations allow only a few thousand calls to
+    vkAllocateMemory at once (maxMemoryAllocationCount), and each call is slow. So this file calls
+    it rarely, for blocks of memBLOCKSIZE bytes (or more, for a bigger request), and carves those
+    blocks into the pieces that buffers and images need, with a buddy allocator. A block is split in
+    halves, and those halves in halves, and so on, down to memLEAFSIZE bytes, and a freed piece is
+    merged with its buddy whenever the buddy is free too. Every piece is a power of two in size and
+    starts at a multiple of its size, so the alignment requirements of buffers and images come for
+    free. Each memory type has two pools of blocks, one for buffers and linear images and one for
+    optimal images, because Vulkan wants those kept apart (bufferImageGranularity). Host-visible
+    blocks are mapped once, when they are allocated, so every allocation in them comes with a
+    pointer to write through.
+    Designed by Josh Davis for Carleton College's CS311 - Computer Graphics.
+    Implementations written by Cole Weinstein and Robbie Young.
+*/
+
+
+
+/* This file assumes that the global variable vul has already been configured. */
+
+#define memLEAFSIZE 256
+#define memBLOCKSIZE (16 * 1024 * 1024)
+#define memMAXORDER 24
+
+/* One chunk of memory from vkAllocateMemory. The block is memLEAFSIZE <<
+maxOrder bytes, made of that many leaves. A free piece of order k is 2^k leaves
+long. For the first leaf of each free piece, freeOrder holds its order, and
+nextFree and prevFree link it into the list of free pieces of that order. For
+every other leaf, freeOrder is -1. */
+typedef struct memBlock memBlock;
+struct memBlock {
+    VkDeviceMemory memory;
+    char *mapped;                       /* NULL if not host-visible */
+    VkDeviceSize size;
+    int maxOrder;
+    int firstFree[memMAXORDER + 1];     /* -1 if there are none */
+    int *nextFree, *prevFree;
+    signed char *freeOrder;
+    int allocNum;                       /* pieces in use */
+    VkDeviceSize allocatedSize;         /* bytes in those pieces */
+    VkDeviceSize usedSize;              /* bytes requested for them */
+    int pool;                           /* index into memManager's pools */
+    memBlock *next;
+};
+
+/* Feel free to read from this struct's members, but don't write to them. An
+allocation is size bytes at offset in memory. Bind buffers and images to memory
+at offset. If the memory is host-visible, then mapped points to the first of the
+bytes; otherwise it is NULL. */
+typedef struct memAllocation memAllocation;
+struct memAllocation {
+    VkDeviceMemory memory;
+    VkDeviceSize offset, size;
+    char *mapped;
+    memBlock *block;
+    int order;
+};
+
+/* Feel free to read from this struct's members, but don't write to them.
+pools[2 * t] holds the blocks of memory type t for buffers and linear images,
+and pools[2 * t + 1] those for optimal images. */
+typedef struct memManager memManager;
+struct memManager {
+    VkDeviceSize blockSize;
+    uint32_t typeNum;
+    VkMemoryPropertyFlags typeFlags[VK_MAX_MEMORY_TYPES];
+    memBlock *pools[2 * VK_MAX_MEMORY_TYPES];
+    int blockAllocNum;                  /* calls to vkAllocateMemory, ever */
+};
+
+/* The state of some pools at a moment. Of the reserved bytes, allocated are in
+pieces in use, and free are not. Of the allocated bytes, used were actually
+requested; the rest were lost to rounding up to powers of two. The largest free
+sum adds up, over the pools, the largest free piece of each pool. Free pieces in
+different pools can't serve the same allocation, so summing them keeps each
+pool's fragmentation separate. */
+typedef struct memStats memStats;
+struct memStats {
+    int blockNum, allocNum;
+    VkDeviceSize reservedSize, allocatedSize, usedSize, freeSize;
+    VkDeviceSize largestFreeSum;
+};
+
+/* Initializes the manager, which allocates no memory until it's asked to.
+blockSize is the usual size of a block, and should be a power of two. Returns
+an error code (0 on success). On success, don't forget to memFinalize when
+you're done. */
+int memInitialize(memManager *man, VkDeviceSize blockSize) {
+    if (blockSize < memLEAFSIZE || (blockSize & (blockSize - 1)) != 0) {
+        fprintf(stderr, "error: memInitialize: bad blockSize %d\n",
+            (int)blockSize);
+        return 1;
+    }
+    man->blockSize = blockSize;
+    VkPhysicalDeviceMemoryProperties memProps;
+    vkGetPhysicalDeviceMemoryProperties(vul.physicalDevice, &memProps);
+    man->typeNum = memProps.memoryTypeCount;
+    for (uint32_t t = 0; t < man->typeNum; t += 1)
+        man->typeFlags[t] = memProps.memoryTypes[t].propertyFlags;
+    for (int p = 0; p < 2 * VK_MAX_MEMORY_TYPES; p += 1)
+        man->pools[p] = NULL;
+    man->blockAllocNum = 0;
+    return 0;
+}
+
+/* Helper function. Puts the free piece of the given order, starting at the
+given leaf, at the front of its list. */
+void memPushFree(memBlock *block, int leaf, int order) {
+    block->freeOrder[leaf] = order;
+    block->prevFree[leaf] = -1;
+    block->nextFree[leaf] = block->firstFree[order];
+    if (block->firstFree[order] >= 0)
+        block->prevFree[block->firstFree[order]] = leaf;
+    block->firstFree[order] = leaf;
+}
+
+/* Helper function. Takes the free piece starting at the given leaf out of its
+list. */
+void memRemoveFree(memBlock *block, int leaf) {
+    int order = block->freeOrder[leaf];
+    if (block->prevFree[leaf] >= 0)
+        block->nextFree[block->prevFree[leaf]] = block->nextFree[leaf];
+    else
+        block->firstFree[order] = block->nextFree[leaf];
+    if (block->nextFree[leaf] >= 0)
+        block->prevFree[block->nextFree[leaf]] = block->prevFree[leaf];
+    block->freeOrder[leaf] = -1;
+}
+
+/* Helper function. Releases the block's memory and bookkeeping. */
+void memFinalizeBlock(memBlock *block) {
+    if (block->mapped != NULL)
+        vkUnmapMemory(vul.device, block->memory);
+    vkFreeMemory(vul.device, block->memory, NULL);
+    free(block->freeOrder);
+    free(block->prevFree);
+    free(block->nextFree);
+    free(block);
+}
+
+/* Helper function. Allocates a block of memLEAFSIZE << maxOrder bytes of the
+given memory type, entirely free, and maps it if it's host-visible. Returns
+NULL on failure. */
+memBlock *memInitializeBlock(memManager *man, uint32_t memType, int maxOrder) {
+    memBlock *block = malloc(sizeof(memBlock));
+    if (block == NULL) {
+        fprintf(stderr, "error: memInitializeBlock: malloc failed\n");
+        return NULL;
+    }
+    int leafNum = 1 << maxOrder;
+    block->nextFree = malloc(leafNum * sizeof(int));
+    block->prevFree = malloc(leafNum * sizeof(int));
+    block->freeOrder = malloc(leafNum * sizeof(signed char));
+    if (block->nextFree == NULL || block->prevFree == NULL ||
+            block->freeOrder == NULL) {
+        fprintf(stderr, "error: memInitializeBlock: malloc failed\n");
+        free(block->freeOrder);
+        free(block->prevFree);
+        free(block->nextFree);
+        free(block);
+        return NULL;
+    }
+    block->size = (VkDeviceSize)memLEAFSIZE << maxOrder;
+    VkMemoryAllocateInfo allocInfo = {0};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = block->size;
+    allocInfo.memoryTypeIndex = memType;
+    if (vkAllocateMemory(vul.device, &allocInfo, NULL, &(block->memory)) !=
+            VK_SUCCESS) {
+        fprintf(stderr, "error: memInitializeBlock: vkAllocateMemory failed\n");
+        free(block->freeOrder);
+        free(block->prevFree);
+        free(block->nextFree);
+        free(block);
+        return NULL;
+    }
+    man->blockAllocNum += 1;
+    block->mapped = NULL;
+    if (man->typeFlags[memType] & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        void *data;
+        if (vkMapMemory(
+                vul.device, block->memory, 0, block->size, 0, &data) !=
+                VK_SUCCESS) {
+            fprintf(stderr, "error: memInitializeBlock: vkMapMemory failed\n");
+            memFinalizeBlock(block);
+            return NULL;
+        }
+        block->mapped = (char *)data;
+    }
+    block->maxOrder = maxOrder;
+    for (int k = 0; k <= memMAXORDER; k += 1)
+        block->firstFree[k] = -1;
+    for (int i = 0; i < leafNum; i += 1)
+        block->freeOrder[i] = -1;
+    memPushFree(block, 0, maxOrder);
+    block->allocNum = 0;
+    block->allocatedSize = 0;
+    block->usedSize = 0;
+    block->next = NULL;
+    return block;
+}
+
+/* Helper function. Takes a piece of the given order from the block, splitting
+a bigger piece if necessary. Returns its first leaf, or -1 if the block has no
+piece that big. */
+int memTakeFree(memBlock *block, int order) {
+    int k = order;
+    while (k <= block->maxOrder && block->firstFree[k] < 0)
+        k += 1;
+    if (k > block->maxOrder)
+        return -1;
+    int leaf = block->firstFree[k];
+    memRemoveFree(block, leaf);
+    /* Give back the upper halves, until the piece is the right size. */
+    while (k > order) {
+        k -= 1;
+        memPushFree(block, leaf + (1 << k), k);
+    }
+    return leaf;
+}
+
+/* Allocates memory that meets the requirements, which usually come from
+vkGetBufferMemoryRequirements or vkGetImageMemoryRequirements, and has the
+given properties. linear is 1 for buffers and linearly tiled images, and 0 for
+optimally tiled images. Returns an error code (0 on success). On success, don't
+forget to memFree when you're done. */
+int memAllocate(
+        memManager *man, const VkMemoryRequirements *reqs,
+        VkMemoryPropertyFlags props, int linear, memAllocation *alloc) {
+    uint32_t memType;
+    if (vulGetMemoryType(&vul, reqs->memoryTypeBits, props, &memType) != 0)
+        return 3;
+    /* Pieces are aligned to their own size, so the alignment is a minimum
+    size. */
+    VkDeviceSize need = (reqs->size > reqs->alignment) ?
+        reqs->size : reqs->alignment;
+    int order = 0;
+    while (((VkDeviceSize)memLEAFSIZE << order) < need)
+        order += 1;
+    if (order > memMAXORDER) {
+        fprintf(stderr, "error: memAllocate: %d bytes is too many\n",
+            (int)reqs->size);
+        return 2;
+    }
+    memBlock **pool = &(man->pools[2 * memType + (linear ? 0 : 1)]);
+    memBlock *block;
+    int leaf = -1;
+    for (block = *pool; block != NULL; block = block->next) {
+        leaf = memTakeFree(block, order);
+        if (leaf >= 0)
+            break;
+    }
+    if (block == NULL) {
+        /* Start a new block, big enough for the request. */
+        int maxOrder = 0;
+        while (((VkDeviceSize)memLEAFSIZE << maxOrder) < man->blockSize)
+            maxOrder += 1;
+        if (maxOrder < order)
+            maxOrder = order;
+        block = memInitializeBlock(man, memType, maxOrder);
+        if (block == NULL)
+            return 1;
+        block->pool = 2 * memType + (linear ? 0 : 1);
+        block->next = *pool;
+        *pool = block;
+        leaf = memTakeFree(block, order);
+    }
+    VkDeviceSize pieceSize = (VkDeviceSize)memLEAFSIZE << order;
+    block->allocNum += 1;
+    block->allocatedSize += pieceSize;
+    block->usedSize += reqs->size;
+    alloc->memory = block->memory;
+    alloc->offset = (VkDeviceSize)leaf * memLEAFSIZE;
+    alloc->size = reqs->size;
+    alloc->mapped = (block->mapped == NULL) ? NULL : block->mapped +
+        alloc->offset;
+    alloc->block = block;
+    alloc->order = order;
+    return 0;
+}
+
+/* Returns the allocation to its pool, merging it with its free buddies. A block
+that becomes entirely free is released, unless it's the only one in its pool.
+Free an allocation only after destroying the buffer or image bound to it. */
+void memFree(memManager *man, memAllocation *alloc) {
+    memBlock *block = alloc->block;
+    int order = alloc->order;
+    int leaf = (int)(alloc->offset / memLEAFSIZE);
+    block->allocNum -= 1;
+    block->allocatedSize -= (VkDeviceSize)memLEAFSIZE << order;
+    block->usedSize -= alloc->size;
+    while (order < block->maxOrder) {
+        int buddy = leaf ^ (1 << order);
+        if (block->freeOrder[buddy] != order)
+            break;
+        memRemoveFree(block, buddy);
+        if (buddy < leaf)
+            leaf = buddy;
+        order += 1;
+    }
+    memPushFree(block, leaf, order);
+    if (block->allocNum > 0 ||
+            (man->pools[block->pool] == block && block->next == NULL))
+        return;
+    memBlock **link = &(man->pools[block->pool]);
+    while (*link != block)
+        link = &((*link)->next);
+    *link = block->next;
+    memFinalizeBlock(block);
+}
+
+/* Releases all of the memory. Call it only after every allocation has been
+freed; any that haven't are reported and then released anyway. */
+void memFinalize(memManager *man) {
+    for (int p = 0; p < 2 * VK_MAX_MEMORY_TYPES; p += 1)
+        while (man->pools[p] != NULL) {
+            memBlock *block = man->pools[p];
+            if (block->allocNum > 0)
+                fprintf(stderr, "error: memFinalize: %d allocations leaked\n",
+                    block->allocNum);
+            man->pools[p] = block->next;
+            memFinalizeBlock(block);
+        }
+}
+
+/* Adds the state of the given pool to the stats. */
+void memAddStats(const memManager *man, int pool, memStats *stats) {
+    VkDeviceSize largestFreeSize = 0;
+    for (memBlock *block = man->pools[pool]; block != NULL;
+            block = block->next) {
+        stats->blockNum += 1;
+        stats->allocNum += block->allocNum;
+        stats->reservedSize += block->size;
+        stats->allocatedSize += block->allocatedSize;
+        stats->usedSize += block->usedSize;
+        stats->freeSize += block->size - block->allocatedSize;
+        for (int k = block->maxOrder; k >= 0; k -= 1)
+            if (block->firstFree[k] >= 0) {
+                VkDeviceSize size = (VkDeviceSize)memLEAFSIZE << k;
+                if (size > largestFreeSize)
+                    largestFreeSize = size;
+                break;
+            }
+    }
+    stats->largestFreeSum += largestFreeSize;
+}
+
+/* Sets the stats for all of the pools together. */
+void memGetStats(const memManager *man, memStats *stats) {
+    memStats zero = {0};
+    *stats = zero;
+    for (int p = 0; p < 2 * VK_MAX_MEMORY_TYPES; p += 1)
+        memAddStats(man, p, stats);
+}
+
+/* Prints a line of stats for each pool that has blocks, and then a total. The
+waste is the fraction of the allocated bytes that weren't requested. The
+fragmentation is the fraction of the free bytes that aren't in the largest free
+piece; 0 means that all of the free memory is in one piece. In the total, it's
+each pool's fragmentation weighted by that pool's share of the free bytes. */
+void memPrintStats(const memManager *man, FILE *file) {
+    for (int p = 0; p <= 2 * VK_MAX_MEMORY_TYPES; p += 1) {
+        memStats stats;
+        if (p < 2 * VK_MAX_MEMORY_TYPES) {
+            memStats zero = {0};
+            stats = zero;
+            memAddStats(man, p, &stats);
+            if (stats.blockNum == 0)
+                continue;
+            fprintf(file, "info: memPrintStats: type %d %s: ", p / 2,
+                (p % 2 == 0) ? "linear " : "optimal");
+        } else {
+            memGetStats(man, &stats);
+            fprintf(file, "info: memPrintStats: total       : ");
+        }
+        double waste = (stats.allocatedSize == 0) ? 0.0 :
+            1.0 - (double)stats.usedSize / stats.allocatedSize;
+        double frag = (stats.freeSize == 0) ? 0.0 :
+            1.0 - (double)stats.largestFreeSum / stats.freeSize;
+        fprintf(file, "%d blocks, %d allocations, ", stats.blockNum,
+            stats.allocNum);
+        fprintf(file, "%.2f of %.2f MB used, %.2f waste, %.2f fragmentation\n",
+            stats.usedSize / 1048576.0, stats.reservedSize / 1048576.0, waste,
+            frag);
+    }
+    fprintf(file, "info: memPrintStats: %d calls to vkAllocateMemory\n",
+        man->blockAllocNum);
+}
@@ -0,0 +1,162 @@
+/*
+    700uniform.c
+    Modified from 690uniform.c to take the uniform buffers' memory, and the ring's, from the
+    sub-allocator of 700memory.c. That memory is host-visible, so the sub-allocator has already
+    mapped it, and unifInitializeRing just keeps the allocation's pointer.
+    Designed by Josh Davis for Carleton College's CS311 - Computer Graphics.
+    Implementations written by Cole Weinstein and Robbie Young.
+*/
+
+
+
+/* This file assumes that the global variables vul, mem, and swap have already 
+been configured. This file is not written in an object-oriented style. I mean, 
+the functions do not systematically act on any specific data type as their 
+first argument. */
+
+
+
+/*** GPU-SIDE UNIFORM BUFFERS (SINGLE OR ARRAY) *******************************/
+
+/* Initializes one uniform buffer per swap chain element. Returns an error code 
+(0 on success). On success, don't forget to unifFinalizeBuffers when you're 
+done. */
+int unifInitializeBuffers(
+        VkBuffer **unifBufs, memAllocation **unifBufsMem, 
+        VkDeviceSize bufferSize) {
+    /* Allocate CPU-side memory to hold meta-data. */
+    *unifBufs = malloc(swap.numImages * sizeof(VkBuffer));
+    if (*unifBufs == NULL) {
+        fprintf(stderr, "error: unifInitializeBuffers: malloc failed\n");
+        return 3;
+    }
+    *unifBufsMem = malloc(swap.numImages * sizeof(memAllocation));
+    if (*unifBufsMem == NULL) {
+        fprintf(stderr, "error: unifInitializeBuffers: malloc failed\n");
+        free(*unifBufs);
+        return 2;
+    }
+    /* Allocate GPU-side memory to actually hold the buffers. */
+    for (size_t i = 0; i < swap.numImages; i += 1) {
+        int error = bufInitialize(
+            bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, 
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | 
+            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &(*unifBufs)[i], 
+            &(*unifBufsMem)[i]);
+        if (error != 0) {
+            for (size_t j = 0; j < i; j += 1)
+                bufFinalize(&(*unifBufs)[j], &(*unifBufsMem)[j]);
+            free(*unifBufsMem);
+            free(*unifBufs);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Releases the resources backing the uniform buffers. */
+void unifFinalizeBuffers(VkBuffer **unifBufs, memAllocation **unifBufsMem) {
+    for (size_t i = 0; i < swap.numImages; i += 1)
+        bufFinalize(&(*unifBufs)[i], &(*unifBufsMem)[i]);
+    free(*unifBufsMem);
+    free(*unifBufs);
+};
+
+
+
+/*** ALIGNMENT OF UNIFORM BUFFERS *********************************************/
+
+/* For uniform buffers with dynamic offset (which we use for body-specific 
+uniforms), we can't just pack elements of size uboSize into an array, because 
+the GPU has certain alignment requirements. Each array element has to start at 
+an offset that is a multiple of the GPU's minimum alignment. So this function 
+returns the least multiple of the alignment that is greater than or equal to 
+uboSize. */
+int unifAlignment(int uboSize) {
+    int alignment = 
+        vul.physicalDeviceProperties.limits.minUniformBufferOffsetAlignment;
+    if (uboSize % alignment == 0)
+        return uboSize;
+    else
+        return (uboSize / alignment + 1) * alignment;
+}
+
+
+
+
+
+/*** PERSISTENTLY MAPPED RING OF UNIFORMS *************************************/
+
+/* Feel free to read from this data structure's members, but don't write to them 
+except through the accessors. Slice i occupies bytes i * sliceSize through 
+(i + 1) * sliceSize - 1 of the buffer. The slice in use has used bytes handed 
+out. peak is the most bytes ever used in one slice, for sizing the ring. */
+typedef struct unifRing unifRing;
+struct unifRing {
+    VkBuffer buffer;
+    memAllocation memory;
+    char *mapped;
+    VkDeviceSize sliceSize, alignment, used, peak;
+    int sliceNum, slice;
+};
+
+/* Initializes a ring of sliceNum slices, each of at least sliceSize bytes, in 
+one host-visible, host-coherent buffer, which comes already mapped. usage should 
+include VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, and can include other bits, such as 
+VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, if the ring will hold other per-frame data. 
+Returns an error code (0 on success). On success, don't forget to 
+unifFinalizeRing when you're done. */
+int unifInitializeRing(
+        unifRing *ring, VkDeviceSize sliceSize, int sliceNum, 
+        VkBufferUsageFlags usage) {
+    ring->alignment = unifAlignment(1);
+    ring->sliceSize = 
+        (sliceSize + ring->alignment - 1) / ring->alignment * ring->alignment;
+    ring->sliceNum = sliceNum;
+    ring->slice = 0;
+    ring->used = 0;
+    ring->peak = 0;
+    if (bufInitialize(
+            ring->sliceSize * sliceNum, usage, 
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | 
+            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &(ring->buffer), 
+            &(ring->memory)) != 0)
+        return 1;
+    ring->mapped = ring->memory.mapped;
+    return 0;
+}
+
+/* Releases the resources backing the ring. Call it only when the GPU is done 
+with every slice, for example after vkDeviceWaitIdle. */
+void unifFinalizeRing(unifRing *ring) {
+    bufFinalize(&(ring->buffer), &(ring->memory));
+}
+
+/* Starts allocating from the given slice, which is emptied. Call it once per 
+frame, with a slice that the GPU is done with. With one slice per frame in 
+flight, the slice of the current frame, swap.curFrame, is such a slice, as soon 
+as presentFrame has waited for that frame's fence. */
+void unifBeginRingSlice(unifRing *ring, int slice) {
+    ring->slice = slice % ring->sliceNum;
+    ring->used = 0;
+}
+
+/* Allocates size bytes from the current slice, at an offset that is a multiple 
+of the GPU's minimum alignment for uniform buffers. Returns a pointer to write 
+them through, and sets *offset to their offset from the start of the buffer, for 
+vkCmdBindDescriptorSets or vkCmdBindVertexBuffers. The bytes hold whatever was 
+written there sliceNum frames ago. If the slice is full, then returns NULL. */
+void *unifAllocateRing(unifRing *ring, VkDeviceSize size, uint32_t *offset) {
+    if (ring->used + size > ring->sliceSize) {
+        fprintf(stderr, "error: unifAllocateRing: slice of %d bytes is full\n", 
+            (int)ring->sliceSize);
+        return NULL;
+    }
+    VkDeviceSize start = ring->slice * ring->sliceSize + ring->used;
+    ring->used += 
+        (size + ring->alignment - 1) / ring->alignment * ring->alignment;
+    if (ring->used > ring->peak)
+        ring->peak = ring->used;
+    *offset = (uint32_t)start;
+    return ring->mapped + start;
+}